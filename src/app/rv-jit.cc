@@ -39,6 +39,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/syscall.h>
 
 #include "histedit.h"
 
@@ -67,6 +68,7 @@
 #include "processor-impl.h"
 #include "interp.h"
 #include "processor-model.h"
+#include "queue.h"
 #include "mmu-proxy.h"
 #include "unknown-abi.h"
 #include "processor-proxy.h"
@@ -77,6 +79,7 @@
 #include "fusion-decode.h"
 #include "fusion-base.h"
 #include "fusion-emitter.h"
+#include "fusion-perf.h"
 #include "fusion-tracer.h"
 #include "fusion-runloop.h"
 
@@ -108,6 +111,12 @@ struct rv_jit
 	host_cpu &cpu;
 	int proc_logs = 0;
 	int trace_iters = 100;
+	bool sync_jit = false;
+	bool jit_stats = false;
+	long code_cache_mb = -1;
+	u64 audit_rate = 0;
+	bool perf_map = false;
+	bool perf_jitdump = false;
 	bool help_or_error = false;
 	std::string elf_filename;
 
@@ -116,6 +125,24 @@ struct rv_jit
 
 	rv_jit() : cpu(host_cpu::get_instance()) {}
 
+	const char* symlookup(addr_t addr, bool nearest)
+	{
+		static char symbol_tmpname[256];
+		auto sym = nearest ? elf.sym_by_nearest_addr((Elf64_Addr)addr)
+			: elf.sym_by_addr((Elf64_Addr)addr);
+		if (!sym) return nullptr;
+		int64_t offset = int64_t(addr) - sym->st_value;
+		if (offset == 0) {
+			snprintf(symbol_tmpname, sizeof(symbol_tmpname),
+				"<%s>", elf.sym_name(sym));
+		} else {
+			snprintf(symbol_tmpname, sizeof(symbol_tmpname),
+				"<%s%s0x%" PRIx64 ">", elf.sym_name(sym),
+				offset < 0 ? "-" : "+", offset < 0 ? -offset : offset);
+		}
+		return symbol_tmpname;
+	}
+
 	static const int elf_p_flags_mmap(int v)
 	{
 		int prot = 0;
@@ -285,10 +312,28 @@ struct rv_jit
 				[&](std::string s) { return (proc_logs |= proc_log_no_pseudo); } },
 			{ "-t", "--trace", cmdline_arg_type_none,
 				"Enable hotspot tracer",
-				[&](std::string s) { proc_logs |= proc_log_hist_pc | proc_log_jit_trap; return true; } },
+				[&](std::string s) { proc_logs |= proc_log_jit_trap; return true; } },
 			{ "-a", "--audit", cmdline_arg_type_none,
 				"Enable JIT audit",
 				[&](std::string s) { proc_logs |= proc_log_jit_audit; return true; } },
+			{ "-A", "--audit-traces", cmdline_arg_type_string,
+				"Audit one in N trace entries against the interpreter",
+				[&](std::string s) { audit_rate = strtoull(s.c_str(), nullptr, 10); return audit_rate > 0; } },
+			{ "-S", "--sync-jit", cmdline_arg_type_none,
+				"Compile traces on the emulation thread",
+				[&](std::string s) { return (sync_jit = true); } },
+			{ "-C", "--code-cache", cmdline_arg_type_string,
+				"JIT code cache size in MiB (0 is unbounded)",
+				[&](std::string s) { code_cache_mb = strtol(s.c_str(), nullptr, 10); return code_cache_mb >= 0; } },
+			{ "-s", "--jit-stats", cmdline_arg_type_none,
+				"Print JIT code cache statistics on exit",
+				[&](std::string s) { return (jit_stats = true); } },
+			{ "-P", "--perf-map", cmdline_arg_type_none,
+				"Write /tmp/perf-<pid>.map naming JIT traces",
+				[&](std::string s) { return (perf_map = true); } },
+			{ "-J", "--jitdump", cmdline_arg_type_none,
+				"Write /tmp/jit-<pid>.dump for perf inject --jit",
+				[&](std::string s) { return (perf_jitdump = true); } },
 			{ "-l", "--trace-iters", cmdline_arg_type_string,
 				"Hotspot trace iterations",
 				[&](std::string s) { trace_iters = strtoull(s.c_str(), nullptr, 10); return true; } },
@@ -343,6 +388,25 @@ struct rv_jit
 		proc.pc = elf.ehdr.e_entry;
 		proc.mmu.mem->log = (proc.log & proc_log_memory);
 		proc.hotspot_iters = trace_iters;
+		proc.jit_async = !sync_jit;
+		proc.audit_rate = audit_rate;
+		if (code_cache_mb >= 0) {
+			proc.code_cache_limit = size_t(code_cache_mb) << 20;
+		}
+
+		/* name traces for host profilers */
+		if (perf_map || perf_jitdump) {
+			proc.perf.reset(new fusion_perf(std::bind(&rv_jit::symlookup, this,
+				std::placeholders::_1, std::placeholders::_2)));
+			if (perf_map) proc.perf->open_map();
+			if (perf_jitdump) proc.perf->open_dump();
+		}
+
+		/* the proxy exit syscall exits the process so print stats from atexit */
+		if (jit_stats) {
+			static P *stats_proc = &proc;
+			atexit([]() { stats_proc->jit_print_stats(); });
+		}
 
 		/* Find the ELF executable PT_LOAD segments and mmap them into user memory */
 		for (size_t i = 0; i < elf.phdrs.size(); i++) {
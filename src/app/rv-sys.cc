@@ -16,6 +16,7 @@
 #include <climits>
 #include <cfloat>
 #include <cfenv>
+#include <cstddef>
 #include <limits>
 #include <array>
 #include <string>
@@ -26,6 +27,7 @@
 #include <deque>
 #include <map>
 #include <thread>
+#include <mutex>
 #include <atomic>
 #include <type_traits>
 
@@ -38,6 +40,8 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/select.h>
+#include <sys/syscall.h>
 
 #include "histedit.h"
 
@@ -72,6 +76,7 @@
 #include "interp.h"
 #include "processor-model.h"
 #include "queue.h"
+#include "hart-events.h"
 #include "console.h"
 #include "device-rom-boot.h"
 #include "device-rom-sbi.h"
@@ -85,9 +90,19 @@
 #include "device-gpio.h"
 #include "device-rand.h"
 #include "device-htif.h"
+#include "device-virtio-blk.h"
 #include "processor-priv-1.9.h"
 #include "debug-cli.h"
 #include "processor-runloop.h"
+#include "asmjit.h"
+#include "fusion-decode.h"
+#include "fusion-base.h"
+#include "fusion-emitter.h"
+#include "fusion-perf.h"
+#include "fusion-tracer.h"
+#include "fusion-runloop.h"
+#include "node.h"
+#include "snapshot.h"
 
 #if defined (ENABLE_GPERFTOOL)
 #include "gperftools/profiler.h"
@@ -100,6 +115,10 @@ using namespace riscv;
 using priv_emulator_rv32imafdc = processor_runloop<processor_privileged<processor_rv32imafdc_model<decode,processor_priv_rv32imafd,mmu_soft_rv32>>>;
 using priv_emulator_rv64imafdc = processor_runloop<processor_privileged<processor_rv64imafdc_model<decode,processor_priv_rv64imafd,mmu_soft_rv64>>>;
 
+/* Parameterized privileged soft-mmu JIT processor model */
+
+using priv_jit_rv64imafdc = fusion_runloop<processor_privileged<processor_rv64imafdc_model<fusion_decode,processor_priv_rv64imafd,mmu_soft_rv64>>>;
+
 
 /* environment variables */
 
@@ -145,6 +164,17 @@ struct rv_emulator
 	bool help_or_error = false;
 	addr_t map_physical = 0;
 	s64 ram_boot = 0;
+	s64 tlb_entries = 0;
+	s64 tlb_ways = 0;
+	s64 num_harts = 1;
+	s64 ram_size_mb = default_ram_size >> 20;
+	bool log_tlb_stats = false;
+	bool jit = false;
+	s64 icount_shift = -1;
+	std::string disk_image;
+	bool disk_read_only = false;
+	std::string snapshot_filename;
+	std::string restore_filename;
 	uint64_t initial_seed = 0;
 
 	std::vector<std::string> host_cmdline;
@@ -251,6 +281,39 @@ struct rv_emulator
 			{ "-b", "--binary", cmdline_arg_type_string,
 				"Boot Binary ( 32, 64 )",
 				[&](std::string s) { return parse_integral(s, ram_boot); } },
+			{ "-E", "--tlb-entries", cmdline_arg_type_string,
+				"TLB entries per L1 TLB ( power of 2 )",
+				[&](std::string s) { return parse_integral(s, tlb_entries); } },
+			{ "-W", "--tlb-ways", cmdline_arg_type_string,
+				"TLB associativity ( power of 2 )",
+				[&](std::string s) { return parse_integral(s, tlb_ways); } },
+			{ "-L", "--log-tlb-stats", cmdline_arg_type_none,
+				"Log TLB statistics on exit",
+				[&](std::string s) { return (log_tlb_stats = true); } },
+			{ "-z", "--ram-size", cmdline_arg_type_string,
+				"RAM size in MiB (default 1024)",
+				[&](std::string s) { return parse_integral(s, ram_size_mb) && ram_size_mb > 0; } },
+			{ "-N", "--harts", cmdline_arg_type_string,
+				"Number of harts, each runs on its own host thread",
+				[&](std::string s) { return parse_integral(s, num_harts); } },
+			{ "-j", "--jit", cmdline_arg_type_none,
+				"Compile hot traces to x86-64 (rv64 only)",
+				[&](std::string s) { return (jit = true); } },
+			{ "-I", "--icount", cmdline_arg_type_string,
+				"Advance time one RTC tick every 2^N instructions (reproducible, one hart only)",
+				[&](std::string s) { return parse_integral(s, icount_shift) && icount_shift >= 0 && icount_shift < 64; } },
+			{ "-D", "--disk", cmdline_arg_type_string,
+				"Attach a disk image as a virtio block device",
+				[&](std::string s) { disk_image = s; return true; } },
+			{ "-R", "--disk-read-only", cmdline_arg_type_none,
+				"Attach the disk image read-only",
+				[&](std::string s) { return (disk_read_only = true); } },
+			{ "-k", "--snapshot", cmdline_arg_type_string,
+				"Save a snapshot and stop when the guest sets GPIO output bit 2",
+				[&](std::string s) { snapshot_filename = s; return true; } },
+			{ "-K", "--restore", cmdline_arg_type_string,
+				"Resume from a snapshot instead of booting",
+				[&](std::string s) { restore_filename = s; return true; } },
 			{ "-s", "--seed", cmdline_arg_type_string,
 				"Random seed",
 				[&](std::string s) { initial_seed = strtoull(s.c_str(), nullptr, 10); return true; } },
@@ -263,19 +326,30 @@ struct rv_emulator
 		auto result = cmdline_option::process_options(options, argc, argv);
 		if (!result.second) {
 			help_or_error = true;
-		} else if (result.first.size() < 1 && !help_or_error) {
+		} else if (result.first.size() < 1 && restore_filename.size() == 0 && !help_or_error) {
 			printf("%s: wrong number of arguments\n", argv[0]);
 			help_or_error = true;
 		}
 
 		if (help_or_error) {
 			printf("usage: %s [<options>] <elf_file>\n", argv[0]);
+			printf("       %s [<options>] --restore <snapshot>\n", argv[0]);
 			cmdline_option::print_options(options);
 			exit(9);
 		}
 
+		/* a snapshot sets the machine, the boot file is not used */
+		if (restore_filename.size() > 0) {
+			snapshot_header hdr = snapshot_header::read(restore_filename.c_str());
+			ram_boot = hdr.xlen;
+			num_harts = hdr.num_harts;
+			ram_size_mb = hdr.ram_size >> 20;
+		}
+
 		/* get command line options */
-		boot_filename = result.first[0];
+		if (result.first.size() > 0) {
+			boot_filename = result.first[0];
+		}
 		for (size_t i = 0; i < result.first.size(); i++) {
 			host_cmdline.push_back(result.first[i]);
 		}
@@ -300,42 +374,62 @@ struct rv_emulator
 		/* setup floating point exception mask */
 		fenv_init();
 
-		/* instantiate processor, set log options and program counter to entry address */
-		P proc;
-		proc.log = proc_logs;
-		proc.mmu.mem->log = (proc.log & proc_log_memory);
-
-		/* randomise integer register state with 512 bits of entropy */
-		proc.seed_registers(cpu, initial_seed, 512);
+		/* instantiate harts sharing the memory map of the primary hart */
+		if (num_harts < 1 || num_harts > decltype(P::device_timer)::element_type::num_harts) {
+			panic("--harts must be between 1 and %d",
+				(int)decltype(P::device_timer)::element_type::num_harts);
+		}
+		if (icount_shift >= 0 && num_harts > 1) {
+			panic("--icount is only reproducible with one hart, use --harts 1");
+		}
+		node<P> harts(num_harts);
+		P &proc = harts.primary();
+		proc.mmu.mem->log = (proc_logs & proc_log_memory);
 
-		/* ROM/FLASH exposed in the Config MMIO region */
-		typename P::ux rom_base = 0, rom_size = 0, rom_entry = 0;
+		/* reproducible runs use a fixed seed unless one is given */
+		if (icount_shift >= 0 && initial_seed == 0) {
+			initial_seed = 1;
+		}
 
-		if (ram_boot == 32 || ram_boot == 64) {
-			struct stat statbuf;
-			FILE *file = nullptr;
-			memory_segment<typename P::ux> *segment = nullptr;
+		for (auto &hart : harts.harts) {
+			/* set log options */
+			hart->log = proc_logs | (jit ? proc_log_jit_trap : 0);
 
-			/* Add 1GB RAM to the mmu */
-			proc.mmu.mem->add_ram(default_ram_base, default_ram_size);
+			/* time base */
+			hart->icount = icount_shift >= 0;
+			hart->icount_shift = icount_shift >= 0 ? u32(icount_shift) : 0;
 
-			addr_t ram_base = proc.mmu.mem->mpa_to_uva(segment, default_ram_base);
-			if (segment == nullptr) {
-				panic("unable to locate ram");
-			}
-			if (stat(boot_filename.c_str(), &statbuf) < 0) {
-				panic("unable to stat boot file: %s", boot_filename.c_str());
-			}
-			if (!(file = fopen(boot_filename.c_str(), "r"))) {
-				panic("unable to open boot file: %s", boot_filename.c_str());
+			/* resize the L1 TLBs */
+			if (tlb_entries > 0 || tlb_ways > 0) {
+				size_t entries = tlb_entries > 0 ? tlb_entries : P::mmu_type::tlb_type::size;
+				size_t ways = tlb_ways > 0 ? tlb_ways : P::mmu_type::tlb_type::default_ways;
+				hart->mmu.l1_itlb.resize(entries, ways);
+				hart->mmu.l1_dtlb.resize(entries, ways);
 			}
-			ssize_t len = fread((void*)ram_base, 1, statbuf.st_size, file);
-			if (len != statbuf.st_size) {
-				panic("unable to read boot file: %s", boot_filename.c_str());
-			}
-			fclose(file);
+
+			/* randomise integer register state with 512 bits of entropy */
+			hart->seed_registers(cpu, initial_seed, 512);
+		}
+
+		/* RAM is mapped up to the top of the physical address space */
+		size_t ram_size = size_t(ram_size_mb) << 20;
+		if (ram_size_mb > s64(((u64(std::numeric_limits<typename P::ux>::max()) - default_ram_base) >> 20) + 1)) {
+			panic("--ram-size must be at most %llu MiB",
+				((u64(std::numeric_limits<typename P::ux>::max()) - default_ram_base) >> 20) + 1);
+		}
+
+		/* ROM/FLASH exposed in the Config MMIO region */
+		typename P::ux rom_base = 0, rom_size = 0, rom_entry = 0;
+
+		if (restore_filename.size() > 0) {
+			/* Add RAM to the mmu, the snapshot fills it */
+			proc.mmu.mem->add_ram(default_ram_base, ram_size);
+		} else if (ram_boot == 32 || ram_boot == 64) {
+			/* Add RAM to the mmu and map the boot image over it copy-on-write */
+			proc.mmu.mem->add_ram(default_ram_base, ram_size);
+			size_t boot_size = proc.mmu.mem->map_file(default_ram_base, boot_filename.c_str());
 			rom_base = default_ram_base;
-			rom_size = statbuf.st_size;
+			rom_size = boot_size;
 			rom_entry = default_ram_base;
 		} else {
 			/* Find the ELF executable PT_LOAD segment base address */
@@ -358,20 +452,32 @@ struct rv_emulator
 			rom_base = rom_base - map_offset;
 			rom_entry = elf.ehdr.e_entry - map_offset;
 
-			/* Add 1GB RAM to the mmu */
-			proc.mmu.mem->add_ram(default_ram_base, default_ram_size);
+			/* Add RAM to the mmu */
+			proc.mmu.mem->add_ram(default_ram_base, ram_size);
 		}
 
 		/* Initialize interpreter */
-		proc.init();
-		proc.reset(); /* Reset code calls mapped ROM image */
-		proc.device_config->num_harts = 1;
+		harts.init();
+		if (icount_shift >= 0) {
+			proc.device_rand->seed(initial_seed);
+		}
+		if (disk_image.size() > 0) {
+			proc.device_blk->open(disk_image, disk_read_only);
+		}
+		harts.reset(); /* Reset code calls mapped ROM image */
+		proc.device_config->num_harts = num_harts;
 		proc.device_config->time_base = 1000000000;
 		proc.device_config->rom_base = rom_base;
 		proc.device_config->rom_size = rom_size;
 		proc.device_config->rom_entry = rom_entry;
 		proc.device_config->ram_base = default_ram_base;
-		proc.device_config->ram_size = default_ram_size;
+		proc.device_config->ram_size = ram_size;
+		proc.device_gpio->snapshot_enabled = snapshot_filename.size() > 0;
+
+		/* resume from a snapshot */
+		if (restore_filename.size() > 0) {
+			snapshot<P>::restore(harts, restore_filename);
+		}
 
 #if defined (ENABLE_GPERFTOOL)
 		ProfilerStart("test-emulate.out");
@@ -382,17 +488,32 @@ struct rv_emulator
 		 *
 		 * when --debug flag is present we start in the debugger
 		 */
-		proc.run(proc.log & proc_log_ebreak_cli
+		harts.run(proc.log & proc_log_ebreak_cli
 			? exit_cause_cli : exit_cause_continue);
 
 #if defined (ENABLE_GPERFTOOL)
 		ProfilerStop();
 #endif
+
+		if (proc.device_gpio->snapshot_requested) {
+			snapshot<P>::save(harts, default_ram_base, snapshot_filename);
+		}
+
+		if (log_tlb_stats) {
+			for (auto &hart : harts.harts) {
+				hart->mmu.l1_itlb.print_stats("itlb");
+				hart->mmu.l1_dtlb.print_stats("dtlb");
+			}
+		}
 	}
 
 	/* Start a specific processor implementation based on ELF type and ISA extensions */
 	void exec()
 	{
+		if (jit && (ram_boot == 32 || (ram_boot == 0 && elf.ei_class == ELFCLASS32))) {
+			panic("--jit requires an rv64 executable");
+		}
+
 		/* check for RDTSCP on X86 */
 		#if X86_USE_RDTSCP
 		if (cpu.caps.size() > 0 && cpu.caps.find("RDTSCP") == cpu.caps.end()) {
@@ -406,14 +527,17 @@ struct rv_emulator
 				case ELFCLASS32:
 					start_priv<priv_emulator_rv32imafdc>(); break;
 				case ELFCLASS64:
-					start_priv<priv_emulator_rv64imafdc>(); break;
+					if (jit) start_priv<priv_jit_rv64imafdc>();
+					else start_priv<priv_emulator_rv64imafdc>();
+					break;
 			}
 		}
 		else if (ram_boot == 32) {
 			start_priv<priv_emulator_rv32imafdc>();
 		}
 		else if (ram_boot == 64) {
-			start_priv<priv_emulator_rv64imafdc>();
+			if (jit) start_priv<priv_jit_rv64imafdc>();
+			else start_priv<priv_emulator_rv64imafdc>();
 		} else {
 			panic("--boot option must be 32 or 64");
 		}
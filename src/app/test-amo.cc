@@ -0,0 +1,218 @@
+//
+//  test-amo.cc
+//
+
+#undef NDEBUG
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <cinttypes>
+#include <csignal>
+#include <csetjmp>
+#include <cerrno>
+#include <cmath>
+#include <cctype>
+#include <cwchar>
+#include <climits>
+#include <cfloat>
+#include <cfenv>
+#include <cstddef>
+#include <limits>
+#include <array>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+#include <sparsehash/dense_hash_map>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/select.h>
+
+#include "host-endian.h"
+#include "types.h"
+#include "fmt.h"
+#include "bits.h"
+#include "sha512.h"
+#include "format.h"
+#include "meta.h"
+#include "util.h"
+#include "color.h"
+#include "host.h"
+#include "codec.h"
+#include "strings.h"
+#include "disasm.h"
+#include "alu.h"
+#include "fpu.h"
+#include "pte.h"
+#include "pma.h"
+#include "amo.h"
+#include "processor-logging.h"
+#include "processor-base.h"
+#include "processor-impl.h"
+#include "user-memory.h"
+#include "tlb-soft.h"
+#include "mmu-soft.h"
+#include "queue.h"
+#include "hart-events.h"
+#include "console.h"
+#include "device-rom-boot.h"
+#include "device-rom-sbi.h"
+#include "device-rom-string.h"
+#include "device-config.h"
+#include "device-rtc.h"
+#include "device-timer.h"
+#include "device-plic.h"
+#include "device-uart.h"
+#include "device-mipi.h"
+#include "device-gpio.h"
+#include "device-rand.h"
+#include "device-htif.h"
+#include "device-virtio-blk.h"
+#include "processor-priv-1.9.h"
+
+using namespace riscv;
+
+/*
+ * AMO and LR/SC stress test
+ *
+ * harts on host threads share one memory and update shared words
+ * through mmu_soft amo, lr and sc, as guest code running on rv-sys
+ * harts does. every update must take effect exactly once, so the
+ * final values are checked against the exact totals. the update rate
+ * is printed for 1, 2 and 4 harts.
+ */
+
+typedef processor_impl<decode,processor_priv_rv64imafd,mmu_soft_rv64> hart_type;
+
+static const u64 ram_base = 0x80000000ULL;
+static const u64 counter_va = ram_base;
+static const u64 lock_va = ram_base + 64;
+static const u64 locked_va = ram_base + 128;
+
+enum test_kind {
+	test_amoadd,
+	test_lr_sc,
+	test_spinlock
+};
+
+static const char* test_name[] = {
+	"amoadd.d",
+	"lr.d/sc.d",
+	"amoswap.d spinlock",
+};
+
+/* increment the counter iters times, returns the number of failed sc */
+static u64 hart_main(hart_type *hart, test_kind kind, u64 iters)
+{
+	u64 sc_fail = 0;
+	for (u64 i = 0; i < iters; i++) {
+		switch (kind) {
+			case test_amoadd: {
+				u64 old;
+				hart->mmu.amo(*hart, amoadd, counter_va, old, u64(1));
+				break;
+			}
+			case test_lr_sc: {
+				u64 val;
+				for (;;) {
+					hart->mmu.lr(*hart, counter_va, val);
+					if (hart->mmu.sc(*hart, counter_va, val + 1) == 0) break;
+					sc_fail++;
+				}
+				break;
+			}
+			case test_spinlock: {
+				u64 held, val;
+				do {
+					hart->mmu.amo(*hart, amoswap, lock_va, held, u64(1));
+				} while (held);
+				/* plain load and store, protected by the lock */
+				hart->mmu.load(*hart, locked_va, val);
+				hart->mmu.store(*hart, locked_va, val + 1);
+				hart->mmu.amo(*hart, amoswap, lock_va, held, u64(0));
+				assert(held == 1);
+				break;
+			}
+		}
+	}
+	return sc_fail;
+}
+
+static void run_test(test_kind kind, size_t num_harts, u64 iters)
+{
+	std::vector<std::shared_ptr<hart_type>> harts;
+	for (size_t i = 0; i < num_harts; i++) {
+		auto hart = std::make_shared<hart_type>();
+		hart->mode = rv_mode_M;
+		hart->mhartid = i;
+		if (i == 0) {
+			hart->mmu.mem->add_ram(ram_base, page_size);
+		} else {
+			hart->mmu.mem = harts[0]->mmu.mem;
+		}
+		harts.push_back(hart);
+	}
+
+	std::vector<std::thread> threads;
+	std::vector<u64> sc_fail(num_harts);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < num_harts; i++) {
+		threads.push_back(std::thread([&, i]() {
+			sc_fail[i] = hart_main(harts[i].get(), kind, iters);
+		}));
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	u64 counter, lock, locked;
+	harts[0]->mmu.load(*harts[0], counter_va, counter);
+	harts[0]->mmu.load(*harts[0], lock_va, lock);
+	harts[0]->mmu.load(*harts[0], locked_va, locked);
+
+	u64 total = num_harts * iters, fails = 0;
+	for (auto n : sc_fail) fails += n;
+	double secs = std::chrono::duration<double>(end - start).count();
+	printf("%-20s harts=%zu updates=%llu %8.2f Mupdates/s sc-fail=%llu\n",
+		test_name[kind], num_harts, total, total / secs / 1e6, fails);
+
+	switch (kind) {
+		case test_amoadd:
+		case test_lr_sc:
+			assert(counter == total);
+			break;
+		case test_spinlock:
+			assert(lock == 0);
+			assert(locked == total);
+			break;
+	}
+}
+
+int main(int argc, const char *argv[])
+{
+	u64 iters = argc > 1 ? strtoull(argv[1], nullptr, 0) : 1000000;
+	for (test_kind kind : { test_amoadd, test_lr_sc, test_spinlock }) {
+		for (size_t num_harts : { 1, 2, 4 }) {
+			run_test(kind, num_harts, iters);
+		}
+	}
+	return 0;
+}
@@ -27,6 +27,7 @@
 #include <deque>
 #include <map>
 #include <thread>
+#include <mutex>
 #include <atomic>
 #include <type_traits>
 
@@ -39,6 +40,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/syscall.h>
 
 #include "histedit.h"
 
@@ -50,6 +52,7 @@
 #include "format.h"
 #include "meta.h"
 #include "util.h"
+#include "color.h"
 #include "host.h"
 #include "cmdline.h"
 #include "config-parser.h"
@@ -59,16 +62,37 @@
 #include "disasm.h"
 #include "alu.h"
 #include "fpu.h"
+#include "pte.h"
 #include "pma.h"
 #include "amo.h"
 #include "processor-logging.h"
 #include "processor-base.h"
 #include "processor-impl.h"
+#include "user-memory.h"
+#include "tlb-soft.h"
+#include "mmu-soft.h"
 #include "interp.h"
 #include "processor-model.h"
+#include "queue.h"
+#include "hart-events.h"
+#include "console.h"
+#include "device-rom-boot.h"
+#include "device-rom-sbi.h"
+#include "device-rom-string.h"
+#include "device-config.h"
+#include "device-rtc.h"
+#include "device-timer.h"
+#include "device-plic.h"
+#include "device-uart.h"
+#include "device-mipi.h"
+#include "device-gpio.h"
+#include "device-rand.h"
+#include "device-htif.h"
+#include "device-virtio-blk.h"
 #include "mmu-proxy.h"
 #include "unknown-abi.h"
 #include "processor-proxy.h"
+#include "processor-priv-1.9.h"
 #include "debug-cli.h"
 
 #include "asmjit.h"
@@ -76,6 +100,7 @@
 #include "fusion-decode.h"
 #include "fusion-base.h"
 #include "fusion-emitter.h"
+#include "fusion-perf.h"
 #include "fusion-tracer.h"
 #include "fusion-runloop.h"
 
@@ -87,6 +112,9 @@ using namespace riscv;
 using proxy_jit_rv64imafdc = fusion_runloop<processor_proxy
 	<processor_rv64imafdc_model<fusion_decode,processor_rv64imafd,mmu_proxy_rv64>>>;
 
+using priv_jit_rv64imafdc = fusion_runloop<processor_privileged
+	<processor_rv64imafdc_model<fusion_decode,processor_priv_rv64imafd,mmu_soft_rv64>>>;
+
 template <typename P>
 struct rv_test_jit
 {
@@ -95,12 +123,14 @@ struct rv_test_jit
 
 	rv_test_jit() : total_tests(0), tests_passed(0) {}
 
-	void run_test(const char* test_name, P &proc, addr_t pc, size_t step)
+	void run_test(const char* test_name, P &proc, addr_t pc, size_t step,
+		fusion_type fusion = fusion_type_count)
 	{
 		printf("\n=========================================================\n");
 		printf("TEST: %s\n", test_name);
 		typename P::ireg_t save_regs[P::ireg_count];
 		size_t regfile_size = sizeof(typename P::ireg_t) * P::ireg_count;
+		size_t fregfile_size = sizeof(typename P::freg_t) * P::freg_count;
 
 		/* create 256MB RAM at 256MB */
 		proc.mmu.mem->brk = proc.mmu.mem->heap_begin = proc.mmu.mem->heap_end = 0x10000000;
@@ -109,6 +139,7 @@ struct rv_test_jit
 
 		/* clear registers */
 		memset(&proc.ireg[0], 0, regfile_size);
+		memset(&proc.freg[0], 0, fregfile_size);
 
 		/* step the interpreter */
 		printf("\n--[ interp ]---------------\n");
@@ -128,6 +159,7 @@ struct rv_test_jit
 
 		/* reset registers */
 		memset(&proc.ireg[0], 0, regfile_size);
+		memset(&proc.freg[0], 0, fregfile_size);
 
 		/* run compiled trace */
 		proc.jit_exec(proc, pc);
@@ -143,6 +175,14 @@ struct rv_test_jit
 					rv_ireg_name_sym[i], proc.ireg[i].r.xu.val);
 			}
 		}
+		if (fusion != fusion_type_count && proc.stats.fusions[fusion] == 0) {
+			pass = false;
+			printf("ERROR %s not fused\n", fusion_type_name[fusion]);
+		}
+		if (proc.audit_rate && (proc.stats.audits == 0 || proc.stats.audit_failures > 0)) {
+			pass = false;
+			printf("ERROR trace audit failed\n");
+		}
 		printf("%s\n", pass ? "PASS" : "FAIL");
 		if (pass) tests_passed++;
 		total_tests++;
@@ -1420,6 +1460,432 @@ struct rv_test_jit
 		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 5);
 	}
 
+	void test_mul_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, -7);
+		asm_lui(as, rv_ireg_a1, 0x12345);
+		asm_mul(as, rv_ireg_a2, rv_ireg_a0, rv_ireg_a1);
+		asm_mul(as, rv_ireg_s0, rv_ireg_a2, rv_ireg_a1);
+		asm_mul(as, rv_ireg_a0, rv_ireg_s0, rv_ireg_s0);
+		asm_mulw(as, rv_ireg_s1, rv_ireg_a1, rv_ireg_a1);
+		asm_mulw(as, rv_ireg_a3, rv_ireg_s0, rv_ireg_a2);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 7);
+	}
+
+	void test_mulh_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, -7);
+		asm_lui(as, rv_ireg_a1, 0x7fffffff);
+		asm_slli(as, rv_ireg_a1, rv_ireg_a1, 20);
+		asm_mulh(as, rv_ireg_a2, rv_ireg_a0, rv_ireg_a1);
+		asm_mulhsu(as, rv_ireg_a3, rv_ireg_a0, rv_ireg_a1);
+		asm_mulhu(as, rv_ireg_a4, rv_ireg_a0, rv_ireg_a1);
+		asm_mulhsu(as, rv_ireg_s0, rv_ireg_a1, rv_ireg_a0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 7);
+	}
+
+	void test_mulh_2()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_ra, rv_ireg_zero, -3);
+		asm_lui(as, rv_ireg_s0, -1);
+		asm_mulh(as, rv_ireg_s1, rv_ireg_ra, rv_ireg_s0);
+		asm_mulhu(as, rv_ireg_a0, rv_ireg_s0, rv_ireg_ra);
+		asm_mulhsu(as, rv_ireg_ra, rv_ireg_ra, rv_ireg_s0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 5);
+	}
+
+	void test_div_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_lui(as, rv_ireg_a0, -0x12345);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 7);
+		asm_div(as, rv_ireg_a2, rv_ireg_a0, rv_ireg_a1);
+		asm_divu(as, rv_ireg_a3, rv_ireg_a0, rv_ireg_a1);
+		asm_rem(as, rv_ireg_s0, rv_ireg_a0, rv_ireg_a1);
+		asm_remu(as, rv_ireg_s1, rv_ireg_a0, rv_ireg_a1);
+		asm_div(as, rv_ireg_ra, rv_ireg_a0, rv_ireg_a1);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 7);
+	}
+
+	void test_div_2()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, -1);
+		asm_slli(as, rv_ireg_a1, rv_ireg_a0, 63);
+		asm_div(as, rv_ireg_a2, rv_ireg_a1, rv_ireg_a0);
+		asm_rem(as, rv_ireg_a3, rv_ireg_a1, rv_ireg_a0);
+		asm_div(as, rv_ireg_a4, rv_ireg_a1, rv_ireg_zero);
+		asm_divu(as, rv_ireg_a5, rv_ireg_a1, rv_ireg_s0);
+		asm_rem(as, rv_ireg_s1, rv_ireg_a1, rv_ireg_zero);
+		asm_remu(as, rv_ireg_s2, rv_ireg_a1, rv_ireg_s0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 8);
+	}
+
+	void test_divw_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_lui(as, rv_ireg_a0, -0x12345);
+		asm_addi(as, rv_ireg_s0, rv_ireg_zero, 7);
+		asm_divw(as, rv_ireg_a2, rv_ireg_a0, rv_ireg_s0);
+		asm_divuw(as, rv_ireg_a3, rv_ireg_a0, rv_ireg_s0);
+		asm_remw(as, rv_ireg_s1, rv_ireg_a0, rv_ireg_s0);
+		asm_remuw(as, rv_ireg_s2, rv_ireg_a0, rv_ireg_s0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 6);
+	}
+
+	void test_divw_2()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, -1);
+		asm_lui(as, rv_ireg_a1, -0x80000000LL);
+		asm_divw(as, rv_ireg_a2, rv_ireg_a1, rv_ireg_a0);
+		asm_remw(as, rv_ireg_a3, rv_ireg_a1, rv_ireg_a0);
+		asm_divw(as, rv_ireg_a4, rv_ireg_a1, rv_ireg_zero);
+		asm_divuw(as, rv_ireg_a5, rv_ireg_a1, rv_ireg_s0);
+		asm_remw(as, rv_ireg_s1, rv_ireg_a1, rv_ireg_zero);
+		asm_remuw(as, rv_ireg_s2, rv_ireg_a1, rv_ireg_s0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 8);
+	}
+
+	void test_fadd_d_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, 3);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, -5);
+		asm_fcvt_d_l(as, rv_freg_ft0, rv_ireg_a0, rv_rm_dyn);
+		asm_fcvt_d_w(as, rv_freg_ft1, rv_ireg_a1, rv_rm_dyn);
+		asm_fadd_d(as, rv_freg_ft2, rv_freg_ft0, rv_freg_ft1, rv_rm_dyn);
+		asm_fmul_d(as, rv_freg_ft3, rv_freg_ft2, rv_freg_ft1, rv_rm_dyn);
+		asm_fdiv_d(as, rv_freg_ft4, rv_freg_ft3, rv_freg_ft0, rv_rm_dyn);
+		asm_fsub_d(as, rv_freg_ft5, rv_freg_ft4, rv_freg_ft0, rv_rm_dyn);
+		asm_fsqrt_d(as, rv_freg_ft6, rv_freg_ft3, rv_rm_dyn);
+		asm_fmv_x_d(as, rv_ireg_a2, rv_freg_ft4);
+		asm_fmv_x_d(as, rv_ireg_a3, rv_freg_ft5);
+		asm_fmv_x_d(as, rv_ireg_a4, rv_freg_ft6);
+		asm_fcvt_l_d(as, rv_ireg_a5, rv_freg_ft5, rv_rm_dyn);
+		asm_fcvt_w_d(as, rv_ireg_s0, rv_freg_ft4, rv_rm_dyn);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 15);
+	}
+
+	void test_fcmp_d_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, 7);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, -2);
+		asm_fcvt_d_l(as, rv_freg_ft0, rv_ireg_a0, rv_rm_dyn);
+		asm_fcvt_d_l(as, rv_freg_ft1, rv_ireg_a1, rv_rm_dyn);
+		asm_fmv_d_x(as, rv_freg_ft2, rv_ireg_zero);
+		asm_fdiv_d(as, rv_freg_ft3, rv_freg_ft2, rv_freg_ft2, rv_rm_dyn);
+		asm_feq_d(as, rv_ireg_a2, rv_freg_ft0, rv_freg_ft0);
+		asm_flt_d(as, rv_ireg_a3, rv_freg_ft1, rv_freg_ft0);
+		asm_fle_d(as, rv_ireg_a4, rv_freg_ft0, rv_freg_ft1);
+		asm_feq_d(as, rv_ireg_a5, rv_freg_ft3, rv_freg_ft3);
+		asm_flt_d(as, rv_ireg_a6, rv_freg_ft3, rv_freg_ft0);
+		asm_fmin_d(as, rv_freg_ft4, rv_freg_ft0, rv_freg_ft3);
+		asm_fmax_d(as, rv_freg_ft5, rv_freg_ft1, rv_freg_ft0);
+		asm_fsgnjn_d(as, rv_freg_ft6, rv_freg_ft5, rv_freg_ft1);
+		asm_fmv_x_d(as, rv_ireg_a7, rv_freg_ft4);
+		asm_fmv_x_d(as, rv_ireg_s0, rv_freg_ft6);
+		asm_fmv_x_d(as, rv_ireg_s1, rv_freg_ft3);
+		asm_fcvt_w_d(as, rv_ireg_s2, rv_freg_ft3, rv_rm_dyn);
+		asm_fcvt_l_d(as, rv_ireg_s3, rv_freg_ft3, rv_rm_dyn);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 20);
+	}
+
+	void test_fadd_s_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, 10);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, -4);
+		asm_fcvt_s_w(as, rv_freg_ft0, rv_ireg_a0, rv_rm_dyn);
+		asm_fcvt_s_l(as, rv_freg_ft1, rv_ireg_a1, rv_rm_dyn);
+		asm_fdiv_s(as, rv_freg_ft2, rv_freg_ft0, rv_freg_ft1, rv_rm_dyn);
+		asm_fadd_s(as, rv_freg_ft3, rv_freg_ft2, rv_freg_ft0, rv_rm_dyn);
+		asm_fsgnjx_s(as, rv_freg_ft4, rv_freg_ft3, rv_freg_ft1);
+		asm_fcvt_d_s(as, rv_freg_ft5, rv_freg_ft2, rv_rm_dyn);
+		asm_fcvt_s_d(as, rv_freg_ft6, rv_freg_ft5, rv_rm_dyn);
+		asm_fmv_x_s(as, rv_ireg_a2, rv_freg_ft2);
+		asm_fmv_x_s(as, rv_ireg_a3, rv_freg_ft4);
+		asm_fmv_x_d(as, rv_ireg_a4, rv_freg_ft5);
+		asm_fmv_x_s(as, rv_ireg_a5, rv_freg_ft6);
+		asm_fcvt_w_s(as, rv_ireg_a6, rv_freg_ft2, rv_rm_dyn);
+		asm_flt_s(as, rv_ireg_a7, rv_freg_ft2, rv_freg_ft0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 16);
+	}
+
+	void test_fsd_fld_1()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, 0x10000000);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 5);
+		asm_addi(as, rv_ireg_a2, rv_ireg_zero, 3);
+		asm_fcvt_d_l(as, rv_freg_ft0, rv_ireg_a1, rv_rm_dyn);
+		asm_fcvt_d_l(as, rv_freg_ft1, rv_ireg_a2, rv_rm_dyn);
+		asm_fsd(as, rv_ireg_a0, rv_freg_ft0, 8);
+		asm_fsw(as, rv_ireg_a0, rv_freg_ft1, 16);
+		asm_fld(as, rv_freg_ft2, rv_ireg_a0, 8);
+		asm_flw(as, rv_freg_ft3, rv_ireg_a0, 16);
+		asm_fmadd_d(as, rv_freg_ft4, rv_freg_ft2, rv_freg_ft1, rv_freg_ft0, rv_rm_dyn);
+		asm_fnmsub_d(as, rv_freg_ft5, rv_freg_ft2, rv_freg_ft1, rv_freg_ft0, rv_rm_dyn);
+		asm_fld(as, rv_freg_ft6, rv_ireg_a0, 16);
+		asm_ld(as, rv_ireg_a3, rv_ireg_a0, 8);
+		asm_fmv_x_d(as, rv_ireg_a4, rv_freg_ft4);
+		asm_fmv_x_d(as, rv_ireg_a5, rv_freg_ft5);
+		asm_fmv_x_s(as, rv_ireg_a6, rv_freg_ft3);
+		asm_fmv_x_d(as, rv_ireg_a7, rv_freg_ft6);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 18);
+	}
+
+	void test_sreg_loop_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_s2, rv_ireg_zero, 10);
+		asm_addi(as, rv_ireg_s3, rv_ireg_zero, 0);
+		asm_add(as, rv_ireg_s3, rv_ireg_s3, rv_ireg_s2);
+		asm_addi(as, rv_ireg_s2, rv_ireg_s2, -1);
+		asm_bne(as, rv_ireg_s2, rv_ireg_zero, -8);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 33);
+	}
+
+	void test_jalr_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_auipc(as, rv_ireg_a0, 0);
+		asm_addi(as, rv_ireg_a0, rv_ireg_a0, 17);
+		asm_jalr(as, rv_ireg_ra, rv_ireg_a0, -1);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 7);
+		asm_addi(as, rv_ireg_a2, rv_ireg_ra, 1);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 5);
+	}
+
+	void test_chain_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 3);
+		asm_addi(as, rv_ireg_a2, rv_ireg_zero, 0);
+		asm_andi(as, rv_ireg_t0, rv_ireg_a0, 1);
+		asm_beq(as, rv_ireg_t0, rv_ireg_zero, 8);
+		asm_addi(as, rv_ireg_a2, rv_ireg_a2, 5);
+		asm_addi(as, rv_ireg_a0, rv_ireg_a0, 1);
+		asm_bne(as, rv_ireg_a0, rv_ireg_a1, -16);
+		asm_ebreak(as);
+		as.link();
+
+		addr_t pc = (addr_t)as.get_section(".text")->buf.data();
+		typename P::ireg_t save_regs[P::ireg_count];
+		size_t regfile_size = sizeof(typename P::ireg_t) * P::ireg_count;
+
+		printf("\n=========================================================\n");
+		printf("TEST: %s\n", __func__);
+
+		/* step the interpreter */
+		printf("\n--[ interp ]---------------\n");
+		memset(&proc.ireg[0], 0, regfile_size);
+		proc.log = proc_log_inst;
+		proc.pc = pc;
+		proc.step(16);
+		memcpy(&save_regs[0], &proc.ireg[0], regfile_size);
+
+		/* compile the entry trace, which exits on the odd path */
+		printf("\n--[ jit ]------------------\n");
+		memset(&proc.ireg[0], 0, regfile_size);
+		proc.log = proc_log_jit_trace;
+		proc.pc = pc;
+		proc.jit_trace();
+
+		/* compile the odd path trace, linking the entry trace exit */
+		proc.pc = pc + 16;
+		proc.jit_trace();
+
+		/* run the chained traces */
+		memset(&proc.ireg[0], 0, regfile_size);
+		proc.jit_exec(proc, pc);
+
+		/* print result */
+		printf("\n--[ result ]---------------\n");
+		bool pass = true;
+		for (size_t i = 0; i < P::ireg_count; i++) {
+			if (save_regs[i].r.xu.val != proc.ireg[i].r.xu.val) {
+				pass = false;
+				printf("ERROR interp-%s=0x%016llx jit-%s=0x%016llx\n",
+					rv_ireg_name_sym[i], save_regs[i].r.xu.val,
+					rv_ireg_name_sym[i], proc.ireg[i].r.xu.val);
+			}
+		}
+		if (addr_t(proc.pc) != pc + 28) {
+			pass = false;
+			printf("ERROR jit-pc=0x%016llx expected=0x%016llx\n",
+				(addr_t)proc.pc, pc + 28);
+		}
+		printf("%s\n", pass ? "PASS" : "FAIL");
+		if (pass) tests_passed++;
+		total_tests++;
+	}
+
+	void test_code_cache_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 3);
+		asm_addi(as, rv_ireg_a2, rv_ireg_zero, 0);
+		asm_andi(as, rv_ireg_t0, rv_ireg_a0, 1);
+		asm_beq(as, rv_ireg_t0, rv_ireg_zero, 8);
+		asm_addi(as, rv_ireg_a2, rv_ireg_a2, 5);
+		asm_addi(as, rv_ireg_a0, rv_ireg_a0, 1);
+		asm_bne(as, rv_ireg_a0, rv_ireg_a1, -16);
+		asm_ebreak(as);
+		as.link();
+
+		addr_t pc = (addr_t)as.get_section(".text")->buf.data();
+		size_t regfile_size = sizeof(typename P::ireg_t) * P::ireg_count;
+		bool pass = true;
+
+		printf("\n=========================================================\n");
+		printf("TEST: %s\n", __func__);
+
+		/* a store to the trace's page retires the trace */
+		memset(&proc.ireg[0], 0, regfile_size);
+		proc.log = proc_log_jit_trace;
+		proc.pc = pc;
+		proc.jit_trace();
+		proc.code_page_store(pc);
+		if (proc.jit_exec(proc, pc) || proc.stats.invalidations != 1) {
+			pass = false;
+			printf("ERROR trace not invalidated\n");
+		}
+
+		/* a full cache evicts the least recently used trace */
+		proc.code_cache_limit = 1;
+		proc.pc = pc;
+		proc.jit_trace();
+		proc.pc = pc + 16;
+		proc.jit_trace();
+		if (proc.trace_cache.size() != 1 || proc.stats.evictions != 1 ||
+			proc.stats.recompiles != 1 || proc.code_cache_size != proc.trace_cache.begin()->second.size)
+		{
+			pass = false;
+			printf("ERROR traces=%zu evictions=%llu recompiles=%llu\n",
+				proc.trace_cache.size(), proc.stats.evictions, proc.stats.recompiles);
+		}
+		proc.jit_print_stats();
+
+		printf("%s\n", pass ? "PASS" : "FAIL");
+		if (pass) tests_passed++;
+		total_tests++;
+	}
+
+	void test_hotspot_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 9);
+		asm_addi(as, rv_ireg_a2, rv_ireg_zero, 0);
+		asm_add(as, rv_ireg_a2, rv_ireg_a2, rv_ireg_a0);
+		asm_addi(as, rv_ireg_a0, rv_ireg_a0, 1);
+		asm_bne(as, rv_ireg_a0, rv_ireg_a1, -8);
+		asm_ebreak(as);
+		as.link();
+
+		addr_t pc = (addr_t)as.get_section(".text")->buf.data();
+		size_t regfile_size = sizeof(typename P::ireg_t) * P::ireg_count;
+		bool pass = true;
+
+		printf("\n=========================================================\n");
+		printf("TEST: %s\n", __func__);
+
+		/* the loop header is traced once entered hotspot_iters times */
+		memset(&proc.ireg[0], 0, regfile_size);
+		proc.log = proc_log_jit_trap;
+		proc.hotspot_iters = 3;
+		proc.pc = pc;
+		proc.step(29);
+		if (proc.trace_cache.find(pc + 8) == proc.trace_cache.end()) {
+			pass = false;
+			printf("ERROR loop header not traced\n");
+		}
+		if (proc.ireg[rv_ireg_a2].r.xu.val != 36 || addr_t(proc.pc) != pc + 20) {
+			pass = false;
+			printf("ERROR a2=%lld pc=0x%016llx\n",
+				proc.ireg[rv_ireg_a2].r.xu.val, (addr_t)proc.pc);
+		}
+
+		printf("%s\n", pass ? "PASS" : "FAIL");
+		if (pass) tests_passed++;
+		total_tests++;
+	}
+
 	void test_lui_1()
 	{
 		P proc;
@@ -1890,12 +2356,346 @@ struct rv_test_jit
 		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 5);
 	}
 
+	void test_fusion_zext_1()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, -1);
+		asm_slli(as, rv_ireg_a1, rv_ireg_a0, 32);
+		asm_srli(as, rv_ireg_a1, rv_ireg_a1, 32);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 3,
+			fusion_type_zext);
+	}
+
+	void test_fusion_zext_2()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, -1);
+		asm_slli(as, rv_ireg_a0, rv_ireg_a0, 48);
+		asm_srli(as, rv_ireg_a0, rv_ireg_a0, 48);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 3,
+			fusion_type_zext);
+	}
+
+	void test_fusion_load_index_1()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, 0x10000000);
+		as.load_imm(rv_ireg_a1, -1);
+		as.load_imm(rv_ireg_a2, 8);
+		asm_sd(as, rv_ireg_a0, rv_ireg_a1, 8);
+		asm_add(as, rv_ireg_a3, rv_ireg_a0, rv_ireg_a2);
+		asm_ld(as, rv_ireg_a3, rv_ireg_a3, 0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 7,
+			fusion_type_load_index);
+	}
+
+	void test_fusion_load_index_2()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, 0x10000000);
+		as.load_imm(rv_ireg_a1, -1);
+		as.load_imm(rv_ireg_a2, 8);
+		asm_sd(as, rv_ireg_a0, rv_ireg_a1, 8);
+		asm_add(as, rv_ireg_a0, rv_ireg_a0, rv_ireg_a2);
+		asm_lhu(as, rv_ireg_a0, rv_ireg_a0, 2);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 7,
+			fusion_type_load_index);
+	}
+
+	void test_fusion_load_abs_1()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, 0x10000000);
+		as.load_imm(rv_ireg_a1, -1);
+		asm_sw(as, rv_ireg_a0, rv_ireg_a1, 16);
+		asm_lui(as, rv_ireg_a2, 0x10000000);
+		asm_lw(as, rv_ireg_a2, rv_ireg_a2, 16);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 6,
+			fusion_type_load_abs);
+	}
+
+	void test_fusion_cmp_branch_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 5);
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, 0);
+		asm_addi(as, rv_ireg_a0, rv_ireg_a0, 1);
+		asm_slt(as, rv_ireg_t0, rv_ireg_a0, rv_ireg_a1);
+		asm_bne(as, rv_ireg_t0, rv_ireg_zero, -8);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 17,
+			fusion_type_cmp_branch);
+	}
+
+	void test_fusion_sext_w_1()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a0, 0x40000000);
+		asm_add(as, rv_ireg_a2, rv_ireg_a0, rv_ireg_a0);
+		asm_addiw(as, rv_ireg_a2, rv_ireg_a2, 0);
+		asm_mul(as, rv_ireg_a3, rv_ireg_a2, rv_ireg_a0);
+		asm_addiw(as, rv_ireg_a3, rv_ireg_a3, 0);
+		asm_ebreak(as);
+		as.link();
+
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 6,
+			fusion_type_sext_w);
+	}
+
+	void test_audit_trace_1()
+	{
+		P proc;
+		assembler as;
+
+		as.load_imm(rv_ireg_a2, 0x10000000);
+		asm_addi(as, rv_ireg_a0, rv_ireg_zero, 3);
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 0);
+		asm_add(as, rv_ireg_a1, rv_ireg_a1, rv_ireg_a0);
+		asm_sd(as, rv_ireg_a2, rv_ireg_a1, 0);
+		asm_addi(as, rv_ireg_a0, rv_ireg_a0, -1);
+		asm_bne(as, rv_ireg_a0, rv_ireg_zero, -12);
+		asm_ebreak(as);
+		as.link();
+
+		proc.audit_rate = 1;
+		run_test(__func__, proc, (addr_t)as.get_section(".text")->buf.data(), 7);
+	}
+
 	void print_summary()
 	{
 		printf("\n%d/%d tests successful\n", tests_passed, total_tests);
 	}
 };
 
+/*
+ * privileged JIT tests
+ *
+ * a machine mode hart with bare translation runs code copied to RAM,
+ * so traces load and store through the JIT TLBs of the soft MMU and
+ * faults trap through the run loop.
+ */
+template <typename P>
+struct rv_test_jit_priv
+{
+	typedef typename P::ux UX;
+
+	enum : addr_t {
+		ram_base = 0x80000000,
+		ram_size = 0x100000,
+		data_base = ram_base + 0x10000
+	};
+
+	int &total_tests;
+	int &tests_passed;
+
+	rv_test_jit_priv(int &total_tests, int &tests_passed) :
+		total_tests(total_tests), tests_passed(tests_passed) {}
+
+	u8* ram_ptr(P &proc, addr_t mpa)
+	{
+		memory_segment<UX> *seg = nullptr;
+		return (u8*)proc.mmu.mem->mpa_to_uva(seg, UX(mpa));
+	}
+
+	/* add RAM, copy the program to its base and clear the registers */
+	void setup(P &proc, assembler &as)
+	{
+		proc.init();
+		proc.mmu.mem->add_ram(ram_base, ram_size);
+		proc.reset();
+		auto &buf = as.get_section(".text")->buf;
+		memcpy(ram_ptr(proc, ram_base), buf.data(), buf.size());
+		memset(&proc.ireg[0], 0, sizeof(typename P::ireg_t) * P::ireg_count);
+		proc.pc = ram_base;
+	}
+
+	void result(bool pass)
+	{
+		printf("%s\n", pass ? "PASS" : "FAIL");
+		if (pass) tests_passed++;
+		total_tests++;
+	}
+
+	void test_priv_tlb_miss_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_ld(as, rv_ireg_a1, rv_ireg_a0, 0);
+		asm_sd(as, rv_ireg_a0, rv_ireg_a1, 8);
+		asm_addi(as, rv_ireg_a2, rv_ireg_a1, 1);
+		asm_ebreak(as);
+		as.link();
+
+		printf("\n=========================================================\n");
+		printf("TEST: %s\n", __func__);
+		setup(proc, as);
+		bool pass = true;
+
+		/* record the trace, then run it with empty JIT TLBs */
+		*(u64*)ram_ptr(proc, data_base) = 0x1234;
+		proc.ireg[rv_ireg_a0] = data_base;
+		proc.log = proc_log_jit_trace;
+		proc.jit_trace();
+		proc.mmu.jit_flush();
+		proc.ireg[rv_ireg_a1] = proc.ireg[rv_ireg_a2] = 0;
+		proc.jit_exec(proc, ram_base, ram_base);
+
+		/* the slow path loads and stores, then fills both entries */
+		size_t i = proc.mmu.jit_tlb_index(data_base);
+		if (proc.ireg[rv_ireg_a2].r.xu.val != 0x1235 ||
+			*(u64*)ram_ptr(proc, data_base + 8) != 0x1234 ||
+			proc.mmu.jit_ltlb[i].tag != data_base ||
+			proc.mmu.jit_stlb[i].tag != data_base ||
+			addr_t(proc.pc) != ram_base + 12)
+		{
+			pass = false;
+			printf("ERROR miss a2=0x%llx pc=0x%016llx\n",
+				proc.ireg[rv_ireg_a2].r.xu.val, (addr_t)proc.pc);
+		}
+
+		/* the filled entries map the same host memory */
+		*(u64*)ram_ptr(proc, data_base) = 0x5678;
+		proc.jit_exec(proc, ram_base, ram_base);
+		if (proc.ireg[rv_ireg_a2].r.xu.val != 0x5679 ||
+			*(u64*)ram_ptr(proc, data_base + 8) != 0x5678)
+		{
+			pass = false;
+			printf("ERROR hit a2=0x%llx\n", proc.ireg[rv_ireg_a2].r.xu.val);
+		}
+
+		result(pass);
+	}
+
+	void test_priv_fault_1()
+	{
+		P proc;
+		assembler as;
+
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 1);
+		asm_addi(as, rv_ireg_a2, rv_ireg_zero, 2);
+		asm_ld(as, rv_ireg_a3, rv_ireg_a0, 0);
+		asm_addi(as, rv_ireg_a4, rv_ireg_zero, 4);
+		asm_ebreak(as);
+		as.link();
+
+		printf("\n=========================================================\n");
+		printf("TEST: %s\n", __func__);
+		setup(proc, as);
+		bool pass = true;
+
+		/* record with a valid address */
+		proc.ireg[rv_ireg_a0] = data_base;
+		proc.log = proc_log_jit_trace;
+		proc.jit_trace();
+
+		/* the load faults in the trace, the handler is the ebreak */
+		memset(&proc.ireg[0], 0, sizeof(typename P::ireg_t) * P::ireg_count);
+		proc.ireg[rv_ireg_a0] = 0x10;
+		proc.mtvec = ram_base + 16;
+		proc.pc = ram_base;
+		u64 instret = proc.instret;
+		proc.log = proc_log_jit_trap;
+		proc.step(64);
+
+		/* pc, instret and registers are those of the faulting load */
+		if (addr_t(proc.mepc) != ram_base + 8 ||
+			proc.mcause != rv_cause_fault_load ||
+			proc.mbadaddr != 0x10 ||
+			u64(proc.instret) - instret != 2 ||
+			proc.ireg[rv_ireg_a1].r.xu.val != 1 ||
+			proc.ireg[rv_ireg_a2].r.xu.val != 2 ||
+			proc.ireg[rv_ireg_a4].r.xu.val != 0)
+		{
+			pass = false;
+			printf("ERROR mepc=0x%016llx mcause=%lld instret=%llu\n",
+				(addr_t)proc.mepc, (s64)proc.mcause, u64(proc.instret) - instret);
+		}
+
+		result(pass);
+	}
+
+	void test_priv_code_store_1()
+	{
+		P proc;
+		assembler as, patch;
+
+		asm_addi(as, rv_ireg_a1, rv_ireg_zero, 1);
+		asm_sw(as, rv_ireg_a0, rv_ireg_a2, 0);
+		asm_addi(as, rv_ireg_a3, rv_ireg_zero, 3);
+		asm_addi(as, rv_ireg_a4, rv_ireg_zero, 4);
+		asm_ebreak(as);
+		as.link();
+		asm_addi(patch, rv_ireg_a4, rv_ireg_zero, 5);
+		patch.link();
+
+		printf("\n=========================================================\n");
+		printf("TEST: %s\n", __func__);
+		setup(proc, as);
+		bool pass = true;
+
+		/* record with the store to a data page */
+		proc.ireg[rv_ireg_a0] = data_base;
+		proc.log = proc_log_jit_trace;
+		proc.jit_trace();
+
+		/* the store patches the fourth instruction */
+		memset(&proc.ireg[0], 0, sizeof(typename P::ireg_t) * P::ireg_count);
+		proc.ireg[rv_ireg_a0] = ram_base + 12;
+		proc.ireg[rv_ireg_a2] = *(u32*)patch.get_section(".text")->buf.data();
+		proc.pc = ram_base;
+		u64 instret = proc.instret;
+		proc.log = proc_log_jit_trap;
+		proc.step(64);
+
+		/* the trace ends after the store and the patched code runs */
+		if (proc.ireg[rv_ireg_a3].r.xu.val != 3 ||
+			proc.ireg[rv_ireg_a4].r.xu.val != 5 ||
+			u64(proc.instret) - instret != 4 ||
+			proc.stats.invalidations != 1 ||
+			proc.trace_cache.find(ram_base) != proc.trace_cache.end())
+		{
+			pass = false;
+			printf("ERROR a4=%lld instret=%llu invalidations=%llu\n",
+				proc.ireg[rv_ireg_a4].r.xu.val, u64(proc.instret) - instret,
+				proc.stats.invalidations);
+		}
+
+		result(pass);
+	}
+};
+
 int main(int argc, char *argv[])
 {
 	rv_test_jit<proxy_jit_rv64imafdc> test;
@@ -1981,6 +2781,22 @@ int main(int argc, char *argv[])
 	test.test_sraw_1();
 	test.test_sraw_2();
 	test.test_sraw_3();
+	test.test_mul_1();
+	test.test_mulh_1();
+	test.test_mulh_2();
+	test.test_div_1();
+	test.test_div_2();
+	test.test_divw_1();
+	test.test_divw_2();
+	test.test_fadd_d_1();
+	test.test_fcmp_d_1();
+	test.test_fadd_s_1();
+	test.test_fsd_fld_1();
+	test.test_chain_1();
+	test.test_jalr_1();
+	test.test_sreg_loop_1();
+	test.test_code_cache_1();
+	test.test_hotspot_1();
 	test.test_lui_1();
 	test.test_lui_2();
 	test.test_load_imm_1();
@@ -2013,5 +2829,17 @@ int main(int argc, char *argv[])
 	test.test_sb_lbu_2();
 	test.test_sb_lbu_3();
 	test.test_sb_lbu_4();
+	test.test_fusion_zext_1();
+	test.test_fusion_zext_2();
+	test.test_fusion_load_index_1();
+	test.test_fusion_load_index_2();
+	test.test_fusion_load_abs_1();
+	test.test_fusion_cmp_branch_1();
+	test.test_fusion_sext_w_1();
+	test.test_audit_trace_1();
+	rv_test_jit_priv<priv_jit_rv64imafdc> test_priv(test.total_tests, test.tests_passed);
+	test_priv.test_priv_tlb_miss_1();
+	test_priv.test_priv_fault_1();
+	test_priv.test_priv_code_store_1();
 	test.print_summary();
 }
@@ -17,8 +17,13 @@
 #include <vector>
 #include <limits>
 #include <map>
+#include <algorithm>
+#include <atomic>
 
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "host-endian.h"
 #include "types.h"
@@ -87,6 +92,52 @@ int main(int argc, char *argv[])
 	// test that invalid_ppn is returned for (VA=0x10000, ASID=0)
 	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x10000) == nullptr);
 
+	// resize the L1 DTLB to 4 sets of 4 ways and fill set 0 (VPN 0x0, 0x4, 0x8, 0xc)
+	mmu.l1_dtlb.resize(16, 4);
+	for (u64 vpn = 0; vpn < 16; vpn += 4) {
+		mmu.l1_dtlb.insert(/* PDID */ 0, /* ASID */ 0, /* VA */ vpn << page_shift, /* PTE level */ 0, /* PTE.bits */ 0xff, /* PPN */ vpn, /* PTE UVA */ 0);
+	}
+	assert(mmu.l1_dtlb.evictions == 0);
+
+	// touch VPN 0x0 then insert VPN 0x10 into set 0, the pseudo-LRU victim must not be VPN 0x0
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x0) != nullptr);
+	mmu.l1_dtlb.insert(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x10000, /* PTE level */ 0, /* PTE.bits */ 0xff, /* PPN */ 0x10, /* PTE UVA */ 0);
+	assert(mmu.l1_dtlb.evictions == 1);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x0) != nullptr);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x10000) != nullptr);
+
+	// insert a gigapage for VA 0x40000000 and test that it translates VAs anywhere in the gigapage
+	mmu.l1_dtlb.insert_superpage(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x40000000, /* PTE level */ 2, /* PTE.bits */ 0xff, /* PPN */ 0x40000, /* PTE UVA */ 0);
+	tlb_ent = mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x7ffff000);
+	assert(tlb_ent != nullptr);
+	assert(tlb_ent->ppn == 0x40000);
+	assert(tlb_ent->ptel == 2);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x80000000) == nullptr);
+
+	// flush ASID 1 and test that ASID 2 entries are retained
+	mmu.l1_dtlb.insert(/* PDID */ 0, /* ASID */ 1, /* VA */ 0x5000, /* PTE level */ 0, /* PTE.bits */ 0xff, /* PPN */ 0x5, /* PTE UVA */ 0);
+	mmu.l1_dtlb.insert(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x5000, /* PTE level */ 0, /* PTE.bits */ 0xff, /* PPN */ 0x5, /* PTE UVA */ 0);
+	mmu.l1_dtlb.insert(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x6000, /* PTE level */ 0, /* PTE.bits */ 0xff, /* PPN */ 0x6, /* PTE UVA */ 0);
+	mmu.l1_dtlb.flush(/* PDID */ 0, /* ASID */ 1);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 1, /* VA */ 0x5000) == nullptr);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x5000) != nullptr);
+
+	// flush VA 0x5000 for ASID 2 and test that VA 0x6000 is retained
+	mmu.l1_dtlb.flush(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x5000);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x5000) == nullptr);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x6000) != nullptr);
+
+	// flush a VA inside a gigapage and test that copies of the gigapage in the page sets are gone
+	mmu.l1_dtlb.insert_superpage(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x40000000, /* PTE level */ 2, /* PTE.bits */ 0xff, /* PPN */ 0x40000, /* PTE UVA */ 0);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x40001000) != nullptr);
+	mmu.l1_dtlb.flush(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x7ffff000);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x40001000) == nullptr);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 2, /* VA */ 0x40000000) == nullptr);
+
+	// flush the L1 DTLB and test that the gigapage is gone
+	mmu.l1_dtlb.flush(0);
+	assert(mmu.l1_dtlb.lookup(/* PDID */ 0, /* ASID */ 0, /* VA */ 0x40000000) == nullptr);
+
 	// add RAM to the MMU emulation (exclude zero page)
 	mmu.mem->add_ram(0x1000, /*1GB*/0x40000000LL - 0x1000);
 
@@ -95,4 +146,34 @@ int main(int argc, char *argv[])
 	addr_t uva = mmu.mem->mpa_to_uva(segment, 0x1000);
 	assert(segment);
 	assert(uva == mmu.mem->segments.front()->uva + 0x0LL);
+
+	// add a segment overlapping the end of RAM and test that the earlier segment shadows it
+	void *buf = mmap(nullptr, 0x2000, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	assert(buf != MAP_FAILED);
+	mmu.mem->add_mmap(0x3ffff000, addr_t(buf), 0x2000, pma_type_main | pma_prot_read);
+	segment = nullptr;
+	uva = mmu.mem->mpa_to_uva(segment, 0x3ffff008);
+	assert(segment == mmu.mem->segments.front().get());
+	assert(uva == mmu.mem->segments.front()->uva + 0x3fffe008LL);
+	segment = nullptr;
+	uva = mmu.mem->mpa_to_uva(segment, 0x40000010);
+	assert(segment == mmu.mem->segments.back().get());
+	assert(uva == addr_t(buf) + 0x1010LL);
+
+	// look up unmapped Machine Physical Addresses
+	segment = nullptr;
+	assert(mmu.mem->mpa_to_uva(segment, 0x0) == 0 && segment == nullptr);
+	assert(mmu.mem->mpa_to_uva(segment, 0x40001000) == 0 && segment == nullptr);
+
+	// test that stores break reservations only on held granules
+	u32 seq = mmu.mem->resv.acquire(0x2000);
+	mmu.mem->resv.store(0x2008);
+	assert(mmu.mem->resv.valid(0x2000, seq));
+	mmu.mem->resv.store(0x2004);
+	assert(!mmu.mem->resv.valid(0x2000, seq));
+	mmu.mem->resv.release(0x2000);
+	seq = mmu.mem->resv.acquire(0x2000);
+	mmu.mem->resv.release(0x2000);
+	mmu.mem->resv.store(0x2000);
+	assert(mmu.mem->resv.valid(0x2000, seq));
 }
@@ -0,0 +1,350 @@
+//
+//  test-virtio-blk.cc
+//
+
+#undef NDEBUG
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <cinttypes>
+#include <cerrno>
+#include <climits>
+#include <limits>
+#include <array>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/select.h>
+
+#include "host-endian.h"
+#include "types.h"
+#include "bits.h"
+#include "sha512.h"
+#include "format.h"
+#include "meta.h"
+#include "util.h"
+#include "host.h"
+#include "codec.h"
+#include "pte.h"
+#include "pma.h"
+#include "amo.h"
+#include "processor-logging.h"
+#include "user-memory.h"
+#include "hart-events.h"
+#include "device-plic.h"
+#include "device-virtio-blk.h"
+
+using namespace riscv;
+
+/*
+ * virtio-blk device test
+ *
+ * builds the descriptor table and the available and used rings by
+ * hand in a RAM segment and notifies the device, as the guest driver
+ * does. the hart is a stub holding the memory map and recording the
+ * pages passed to the code page filter.
+ */
+
+struct test_hart
+{
+	typedef u64 ux;
+
+	u32 log = 0;
+	struct { std::shared_ptr<user_memory<u64>> mem; } mmu;
+	std::shared_ptr<hart_events> events;
+	std::set<addr_t> code_stores;
+
+	static thread_local test_hart *current_hart;
+
+	void code_page_store(addr_t page) { code_stores.insert(page); }
+};
+
+thread_local test_hart *test_hart::current_hart = nullptr;
+
+typedef virtio_blk_mmio_device<test_hart> blk_type;
+typedef blk_type::virtq_desc virtq_desc;
+typedef blk_type::virtq_avail virtq_avail;
+typedef blk_type::virtq_used virtq_used;
+typedef blk_type::virtio_blk_req virtio_blk_req;
+
+static const u64 ram_base = 0x80000000ULL;
+static const u64 ram_size = 0x100000ULL;
+static const u64 desc_mpa = ram_base;
+static const u64 avail_mpa = ram_base + 0x1000;
+static const u64 used_mpa = ram_base + 0x2000;
+static const u64 req_mpa = ram_base + 0x3000;
+static const u64 data_mpa = ram_base + 0x4000;
+static const u64 status_mpa = ram_base + 0x8000;
+static const u32 queue_num = 8;
+static const u32 plic_irq = 5;
+static const size_t disk_sectors = 16;
+
+struct test_buf
+{
+	u64 mpa;
+	u32 len;
+	bool write;
+};
+
+struct test_env
+{
+	test_hart hart;
+	std::shared_ptr<plic_mmio_device<test_hart>> plic;
+	std::shared_ptr<blk_type> blk;
+	u16 avail_idx = 0;
+
+	test_env(const char *image, bool read_only)
+	{
+		hart.mmu.mem = std::make_shared<user_memory<u64>>();
+		hart.mmu.mem->add_ram(ram_base, ram_size);
+		hart.events = std::make_shared<hart_events>(1);
+		plic = std::make_shared<plic_mmio_device<test_hart>>(hart, 0x40002000);
+		blk = std::make_shared<blk_type>(hart, 0x40007000, plic, plic_irq);
+		blk->open(image, read_only);
+		setup();
+	}
+
+	template <typename T> T* ram(u64 mpa)
+	{
+		memory_segment<u64> *seg = nullptr;
+		addr_t uva = hart.mmu.mem->mpa_to_uva(seg, mpa);
+		assert(uva != 0);
+		return reinterpret_cast<T*>(uva);
+	}
+
+	u32 reg(u32 offset)
+	{
+		u32 val;
+		blk->load_32(offset, val);
+		return val;
+	}
+
+	/* reset the device and set up the queue as the driver does */
+	void setup()
+	{
+		blk->store_32(blk_type::REG_STATUS, 0);
+		assert(reg(blk_type::REG_MAGIC) == blk_type::MAGIC);
+		assert(reg(blk_type::REG_DEVICE_ID) == blk_type::DEVICE_ID_BLK);
+		blk->store_32(blk_type::REG_STATUS, 0x3);
+		blk->store_32(blk_type::REG_QUEUE_SEL, 0);
+		blk->store_32(blk_type::REG_QUEUE_NUM, queue_num);
+		blk->store_32(blk_type::REG_QUEUE_DESC_LOW, u32(desc_mpa));
+		blk->store_32(blk_type::REG_QUEUE_DESC_HIGH, u32(desc_mpa >> 32));
+		blk->store_32(blk_type::REG_QUEUE_AVAIL_LOW, u32(avail_mpa));
+		blk->store_32(blk_type::REG_QUEUE_AVAIL_HIGH, u32(avail_mpa >> 32));
+		blk->store_32(blk_type::REG_QUEUE_USED_LOW, u32(used_mpa));
+		blk->store_32(blk_type::REG_QUEUE_USED_HIGH, u32(used_mpa >> 32));
+		blk->store_32(blk_type::REG_QUEUE_READY, 1);
+		blk->store_32(blk_type::REG_STATUS, 0x3 | blk_type::STATUS_DRIVER_OK);
+		memset(ram<u8>(avail_mpa), 0, 0x2000);
+		avail_idx = 0;
+	}
+
+	/* place a chain in the descriptor table and the available ring, then notify */
+	void submit(std::vector<test_buf> chain)
+	{
+		virtq_desc *desc = ram<virtq_desc>(desc_mpa);
+		for (size_t i = 0; i < chain.size(); i++) {
+			desc[i].addr = chain[i].mpa;
+			desc[i].len = chain[i].len;
+			desc[i].flags = (chain[i].write ? blk_type::DESC_F_WRITE : 0) |
+				(i + 1 < chain.size() ? blk_type::DESC_F_NEXT : 0);
+			desc[i].next = u16(i + 1);
+		}
+		virtq_avail *avail = ram<virtq_avail>(avail_mpa);
+		avail->ring[avail_idx % queue_num] = 0;
+		avail->idx = ++avail_idx;
+		blk->store_32(blk_type::REG_QUEUE_NOTIFY, 0);
+	}
+
+	/* submit a request with one data buffer, returns the status byte */
+	u8 request(u32 type, u64 sector, u64 data, u32 len, bool write)
+	{
+		virtio_blk_req *req = ram<virtio_blk_req>(req_mpa);
+		req->type = type;
+		req->reserved = 0;
+		req->sector = sector;
+		*ram<u8>(status_mpa) = 0xff;
+		std::vector<test_buf> chain;
+		chain.push_back(test_buf{ req_mpa, sizeof(virtio_blk_req), false });
+		if (len > 0) chain.push_back(test_buf{ data, len, write });
+		chain.push_back(test_buf{ status_mpa, 1, true });
+		submit(chain);
+		return *ram<u8>(status_mpa);
+	}
+
+	/* the request was completed in the used ring with len bytes written */
+	void check_used(u32 len)
+	{
+		virtq_used *used = ram<virtq_used>(used_mpa);
+		assert(used->idx == avail_idx);
+		assert(used->ring[(avail_idx - 1) % queue_num].id == 0);
+		assert(used->ring[(avail_idx - 1) % queue_num].len == len);
+	}
+
+	bool needs_reset()
+	{
+		return (reg(blk_type::REG_STATUS) & blk_type::STATUS_NEEDS_RESET) != 0;
+	}
+};
+
+static void test_requests(const char *image, int fd)
+{
+	test_env env(image, false);
+	u8 sector[512];
+
+	// read sector 2 and check the data, used ring, interrupt and code page filter
+	assert(env.request(blk_type::BLK_T_IN, 2, data_mpa, 512, true) == blk_type::BLK_S_OK);
+	assert(pread(fd, sector, sizeof(sector), 2 * 512) == ssize_t(sizeof(sector)));
+	assert(memcmp(env.ram<u8>(data_mpa), sector, sizeof(sector)) == 0);
+	env.check_used(513);
+	assert(env.reg(blk_type::REG_INTERRUPT_STATUS) == blk_type::INT_USED_RING);
+	assert(env.plic->irq_pending());
+	assert(env.hart.code_stores.count(data_mpa) == 1);
+
+	// acknowledge the interrupt and check that the PLIC irq is cleared
+	env.blk->store_32(blk_type::REG_INTERRUPT_ACK, blk_type::INT_USED_RING);
+	assert(env.reg(blk_type::REG_INTERRUPT_STATUS) == 0);
+	assert(!env.plic->irq_pending());
+
+	// write sector 3 and check the image through the file
+	memset(env.ram<u8>(data_mpa), 0x5a, 512);
+	assert(env.request(blk_type::BLK_T_OUT, 3, data_mpa, 512, false) == blk_type::BLK_S_OK);
+	env.check_used(1);
+	assert(pread(fd, sector, sizeof(sector), 3 * 512) == ssize_t(sizeof(sector)));
+	assert(sector[0] == 0x5a && sector[511] == 0x5a);
+
+	// flush
+	assert(env.request(blk_type::BLK_T_FLUSH, 0, 0, 0, false) == blk_type::BLK_S_OK);
+	env.check_used(1);
+
+	// get the device id
+	memset(env.ram<u8>(data_mpa), 0xff, blk_type::BLK_ID_BYTES);
+	assert(env.request(blk_type::BLK_T_GET_ID, 0, data_mpa, blk_type::BLK_ID_BYTES, true) == blk_type::BLK_S_OK);
+	env.check_used(blk_type::BLK_ID_BYTES + 1);
+	assert(strcmp(env.ram<char>(data_mpa), "rv-sys") == 0);
+
+	// read past the end of the disk
+	assert(env.request(blk_type::BLK_T_IN, disk_sectors, data_mpa, 512, true) == blk_type::BLK_S_IOERR);
+	assert(!env.needs_reset());
+
+	// a chain without a status buffer is malformed and needs a reset
+	virtio_blk_req *req = env.ram<virtio_blk_req>(req_mpa);
+	req->type = blk_type::BLK_T_IN;
+	req->sector = 0;
+	env.submit({ test_buf{ req_mpa, sizeof(virtio_blk_req), false } });
+	assert(env.needs_reset());
+
+	// requests are ignored until the device is reset
+	u16 used_idx = env.ram<virtq_used>(used_mpa)->idx;
+	env.request(blk_type::BLK_T_FLUSH, 0, 0, 0, false);
+	assert(env.ram<virtq_used>(used_mpa)->idx == used_idx);
+
+	// reset, then a data descriptor outside RAM needs a reset
+	env.setup();
+	assert(!env.needs_reset());
+	assert(env.request(blk_type::BLK_T_IN, 0, 0x10000000, 512, true) == 0xff);
+	assert(env.needs_reset());
+	assert(env.ram<virtq_used>(used_mpa)->idx == 0);
+
+	// reset, then a descriptor running past the end of RAM needs a reset
+	env.setup();
+	assert(env.request(blk_type::BLK_T_IN, 0, ram_base + ram_size - 256, 512, true) == 0xff);
+	assert(env.needs_reset());
+}
+
+static void test_read_only(const char *image)
+{
+	test_env env(image, true);
+
+	// read-only devices report the feature and reject writes
+	env.blk->store_32(blk_type::REG_DEVICE_FEAT_SEL, 0);
+	assert(env.reg(blk_type::REG_DEVICE_FEATURES) & blk_type::BLK_F_RO);
+	assert(env.request(blk_type::BLK_T_IN, 0, data_mpa, 512, true) == blk_type::BLK_S_OK);
+	assert(env.request(blk_type::BLK_T_OUT, 0, data_mpa, 512, false) == blk_type::BLK_S_IOERR);
+	env.check_used(1);
+	assert(!env.needs_reset());
+}
+
+static void test_concurrent_notify(const char *image)
+{
+	test_env env(image, false);
+	const u32 num_chains = queue_num / 2, num_requests = 20000;
+
+	// flush chains with their own header and status byte, in descriptor pairs
+	virtq_desc *desc = env.ram<virtq_desc>(desc_mpa);
+	for (u32 i = 0; i < num_chains; i++) {
+		virtio_blk_req *req = env.ram<virtio_blk_req>(req_mpa + i * 64);
+		req->type = blk_type::BLK_T_FLUSH;
+		desc[i * 2] = virtq_desc{ req_mpa + i * 64, sizeof(virtio_blk_req), blk_type::DESC_F_NEXT, u16(i * 2 + 1) };
+		desc[i * 2 + 1] = virtq_desc{ status_mpa + i, 1, blk_type::DESC_F_WRITE, 0 };
+	}
+
+	// other threads notify and acknowledge while requests are posted one at a time
+	std::atomic<bool> done(false);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < 3; t++) {
+		threads.push_back(std::thread([&]() {
+			while (!done) {
+				env.blk->store_32(blk_type::REG_QUEUE_NOTIFY, 0);
+				env.blk->store_32(blk_type::REG_INTERRUPT_ACK, blk_type::INT_USED_RING);
+				std::this_thread::yield();
+			}
+		}));
+	}
+	virtq_avail *avail = env.ram<virtq_avail>(avail_mpa);
+	virtq_used *used = env.ram<virtq_used>(used_mpa);
+	for (u32 n = 0; n < num_requests; n++) {
+		avail->ring[env.avail_idx % queue_num] = u16((n % num_chains) * 2);
+		__atomic_store_n(&avail->idx, ++env.avail_idx, __ATOMIC_RELEASE);
+		u16 pending;
+		while ((pending = u16(env.avail_idx - __atomic_load_n(&used->idx, __ATOMIC_ACQUIRE))) != 0 &&
+			pending <= queue_num)
+		{
+			std::this_thread::yield();
+		}
+
+		// each request completes exactly once
+		assert(__atomic_load_n(&used->idx, __ATOMIC_ACQUIRE) == env.avail_idx);
+	}
+	done = true;
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	assert(!env.needs_reset());
+	assert(env.blk->num_requests == num_requests);
+}
+
+int main(int argc, char *argv[])
+{
+	char image[] = "/tmp/test-virtio-blk.XXXXXX";
+	int fd = mkstemp(image);
+	assert(fd >= 0);
+	for (size_t i = 0; i < disk_sectors; i++) {
+		u8 sector[512];
+		for (size_t j = 0; j < sizeof(sector); j++) sector[j] = u8(i * 31 + j);
+		assert(write(fd, sector, sizeof(sector)) == ssize_t(sizeof(sector)));
+	}
+
+	test_requests(image, fd);
+	test_read_only(image);
+	test_concurrent_notify(image);
+
+	close(fd);
+	unlink(image);
+	printf("test-virtio-blk: ok\n");
+	return 0;
+}
@@ -744,8 +744,8 @@ const char* elf_file::sym_name(const Elf64_Sym *sym)
 const Elf64_Sym* elf_file::sym_by_nearest_addr(Elf64_Addr addr)
 {
 	auto ai = addr_symbol_map.lower_bound(addr);
-	if (ai == addr_symbol_map.end()) return nullptr;
-	if (ai->second == addr) return &symbols[ai->second];
+	if (ai == addr_symbol_map.begin() && ai == addr_symbol_map.end()) return nullptr;
+	if (ai != addr_symbol_map.end() && ai->first == addr) return &symbols[ai->second];
 	if (ai != addr_symbol_map.begin()) ai--;
 	return &symbols[ai->second];
 }
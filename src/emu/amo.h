@@ -61,6 +61,31 @@ namespace riscv {
 		}
 		return 0;
 	}
+
+	/*
+	 * host atomic AMO on a host pointer, returns the original value.
+	 *
+	 * swap and the logical and add operations map directly to host
+	 * atomic read-modify-write instructions, min and max use a
+	 * compare and swap loop. results are computed in UX so sign
+	 * extension matches amo_fn.
+	 */
+
+	template <typename UX, typename T> T amo_atomic(amo_op op, T *ptr, T val)
+	{
+		switch (op) {
+			case amoswap: return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+			case amoadd:  return __atomic_fetch_add(ptr, val, __ATOMIC_SEQ_CST);
+			case amoxor:  return __atomic_fetch_xor(ptr, val, __ATOMIC_SEQ_CST);
+			case amoor:   return __atomic_fetch_or (ptr, val, __ATOMIC_SEQ_CST);
+			case amoand:  return __atomic_fetch_and(ptr, val, __ATOMIC_SEQ_CST);
+			default: break;
+		}
+		T old = __atomic_load_n(ptr, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(ptr, &old, T(amo_fn<UX>(op, old, val)),
+			true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+		return old;
+	}
 }
 
 #endif
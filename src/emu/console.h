@@ -62,6 +62,8 @@ namespace riscv {
 					for (ssize_t i = 0; i < ret; i++) {
 						queue.push_back(buf[i]);
 					}
+					/* wake the hart that takes console interrupts */
+					if (proc.events) proc.events->signal(0);
 				}
 			}
 		}
@@ -166,6 +168,7 @@ namespace riscv {
 		/* shutdown console thread */
 		void shutdown()
 		{
+			if (!thread.joinable()) return;
 			/* set running flag to false and write a null byte to the FIFO */
 			running = false;
 			unsigned char c = 0;
@@ -31,8 +31,13 @@ namespace riscv {
 		enum {
 			OUT_POWER_OFF = 1,
 			OUT_RESET = 2,
+			OUT_SNAPSHOT = 4,
 		};
 
+		/* a snapshot request ends the step after the store so the emulator can save the node */
+		bool snapshot_enabled;
+		bool snapshot_requested;
+
 		enum {
 			total_size = sizeof(u32) * 4
 		};
@@ -50,7 +55,9 @@ namespace riscv {
 			proc(proc),
 			plic(plic),
 			irq(irq),
-			gpio{}
+			gpio{},
+			snapshot_enabled(false),
+			snapshot_requested(false)
 		{}
 
 		/* GPIO interface */
@@ -71,10 +78,15 @@ namespace riscv {
 		void trigger()
 		{
 			if (gpio.out & OUT_POWER_OFF) {
-				proc.raise(P::internal_cause_poweroff, proc.pc);
+				P::current_hart->raise(P::internal_cause_poweroff, P::current_hart->pc);
 			}
 			if (gpio.out & OUT_RESET) {
-				proc.reset();
+				P::current_hart->reset();
+			}
+			if ((gpio.out & OUT_SNAPSHOT) && snapshot_enabled) {
+				gpio.out &= ~OUT_SNAPSHOT;
+				snapshot_requested = true;
+				P::current_hart->raise(P::internal_cause_snapshot, P::current_hart->pc);
 			}
 		}
 
@@ -57,7 +57,7 @@ namespace riscv {
 		void handle_output()
 		{
 			if (htif_tohost == 1) {
-				proc.raise(P::internal_cause_poweroff, proc.pc);
+				P::current_hart->raise(P::internal_cause_poweroff, P::current_hart->pc);
 			}
 			u8 device = htif_device(htif_tohost);
 			u8 command = htif_command(htif_tohost);
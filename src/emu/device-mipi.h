@@ -15,21 +15,46 @@ namespace riscv {
 		typedef typename P::ux UX;
 
 		enum {
-			bits_per_word = sizeof(u32) << 3,
 			num_harts = NUM_HARTS,
-			total_size = bits_per_word * num_harts
+			total_size = sizeof(u32) * num_harts
 		};
 
 		P &proc;
 
 		/* MIPI registers */
 
-		u32 hart[NUM_HARTS];
+		/*
+		 * harts signal each other from their own threads, so the
+		 * registers are atomic. narrow stores update their bytes with
+		 * a compare and swap, and 64-bit accesses span two harts
+		 */
 
-		constexpr u8* as_u8() { return (u8*)&hart[0]; }
-		constexpr u16* as_u16() { return (u16*)&hart[0]; }
-		constexpr u32* as_u32() { return (u32*)&hart[0]; }
-		constexpr u64* as_u64() { return (u64*)&hart[0]; }
+		std::atomic<u32> hart[NUM_HARTS];
+
+		u64 read(UX va, size_t size)
+		{
+			if (size == 8) {
+				return read(va & ~UX(7), 4) | (read((va & ~UX(7)) + 4, 4) << 32);
+			}
+			va &= ~UX(size - 1);
+			u32 shift = (va & 3) << 3;
+			return (hart[va >> 2].load() >> shift) & (~0ULL >> (64 - (size << 3)));
+		}
+
+		void write(UX va, u64 val, size_t size)
+		{
+			if (size == 8) {
+				write(va & ~UX(7), val, 4);
+				write((va & ~UX(7)) + 4, val >> 32, 4);
+				return;
+			}
+			va &= ~UX(size - 1);
+			u32 shift = (va & 3) << 3;
+			u32 mask = u32(~0ULL >> (64 - (size << 3))) << shift;
+			std::atomic<u32> &reg = hart[va >> 2];
+			u32 prev = reg;
+			while (!reg.compare_exchange_weak(prev, (prev & ~mask) | ((u32(val) << shift) & mask)));
+		}
 
 		/* MIPI constructor */
 
@@ -43,14 +68,14 @@ namespace riscv {
 		void print_registers()
 		{
 			for (size_t i = 0; i < num_harts; i++) {
-				debug("mipi_mmio:hart[%04d]       0x%x", i, hart[i]);
+				debug("mipi_mmio:hart[%04d]       0x%x", i, hart[i].load());
 			}
 		}
 
 		void signal_ipi(UX hart_id, u32 value)
 		{
 			if (hart_id >= num_harts) return;
-			hart[num_harts] |= (1ULL << (hart_id & (bits_per_word-1)));
+			hart[hart_id] = value;
 		}
 
 		bool ipi_pending(UX hart_id)
@@ -63,7 +88,7 @@ namespace riscv {
 
 		void load_8 (UX va, u8  &val)
 		{
-			val = (va < total_size) ? *(as_u8() + va) : 0;
+			val = (va < total_size) ? read(va, 1) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx -> 0x%02hhx\n", addr_t(va), val);
 			}
@@ -71,7 +96,7 @@ namespace riscv {
 
 		void load_16(UX va, u16 &val)
 		{
-			val = (va < total_size - 1) ? *(as_u16() + (va>>1)) : 0;
+			val = (va < total_size - 1) ? read(va, 2) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx -> 0x%04hx\n", addr_t(va), val);
 			}
@@ -79,7 +104,7 @@ namespace riscv {
 
 		void load_32(UX va, u32 &val)
 		{
-			val = (va < total_size - 3) ? *(as_u32() + (va>>2)) : 0;
+			val = (va < total_size - 3) ? read(va, 4) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx -> 0x%08x\n", addr_t(va), val);
 			}
@@ -87,7 +112,7 @@ namespace riscv {
 
 		void load_64(UX va, u64 &val)
 		{
-			val = (va < total_size - 7) ? *(as_u64() + (va>>3)) : 0;
+			val = (va < total_size - 7) ? read(va, 8) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx -> 0x%016llx\n", addr_t(va), val);
 			}
@@ -98,7 +123,10 @@ namespace riscv {
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx <- 0x%02hhx\n", addr_t(va), val);
 			}
-			if (va < total_size) *(as_u8() + va) = val;
+			if (va < total_size) {
+				write(va, val, 1);
+				proc.events->signal_all();
+			}
 		}
 
 		void store_16(UX va, u16 val)
@@ -106,7 +134,10 @@ namespace riscv {
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx <- 0x%04hx\n", addr_t(va), val);
 			}
-			if (va < total_size - 1) *(as_u16() + (va>>1)) = val;
+			if (va < total_size - 1) {
+				write(va, val, 2);
+				proc.events->signal_all();
+			}
 		}
 
 		void store_32(UX va, u32 val)
@@ -114,7 +145,10 @@ namespace riscv {
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx <- 0x%08x\n", addr_t(va), val);
 			}
-			if (va < total_size - 3) *(as_u32() + (va>>2)) = val;
+			if (va < total_size - 3) {
+				write(va, val, 4);
+				proc.events->signal_all();
+			}
 		}
 
 		void store_64(UX va, u64 val)
@@ -122,7 +156,10 @@ namespace riscv {
 			if (proc.log & proc_log_mmio) {
 				printf("mipi_mmio:0x%04llx <- 0x%016llx\n", addr_t(va), val);
 			}
-			if (va < total_size - 7) *(as_u64() + (va>>3)) = val;
+			if (va < total_size - 7) {
+				write(va, val, 8);
+				proc.events->signal_all();
+			}
 		}
 
 	};
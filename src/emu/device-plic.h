@@ -16,10 +16,15 @@ namespace riscv {
 
 		P &proc;
 
-		/* PLIC data registers */
+		/*
+		 * PLIC data registers
+		 *
+		 * devices raise irqs from hart 0 and the virtio queue, while any
+		 * hart may claim and complete them, so the registers are atomic
+		 */
 
-		u32 pending;
-		u32 served;
+		std::atomic<u32> pending;
+		std::atomic<u32> served;
 
 		/* PLIC constructor */
 
@@ -34,16 +39,18 @@ namespace riscv {
 
 		void print_registers()
 		{
-			debug("plic_mmio:pending          0x%016llx", pending);
-			debug("plic_mmio:served           0b%016llx", served);
+			debug("plic_mmio:pending          0x%016llx", addr_t(pending));
+			debug("plic_mmio:served           0b%016llx", addr_t(served));
 		}
 
 		void set_irq(UX irq, int val)
 		{
 			if (val) {
-				pending |= (1 << irq);
+				/* wake harts sleeping in wfi when an irq becomes pending */
+				u32 prev = pending.fetch_or(1U << irq);
+				if (!(prev & (1U << irq)) && proc.events) proc.events->signal_all();
 			} else {
-				pending &= ~(1 << irq);
+				pending.fetch_and(~(1U << irq));
 			}
 		}
 
@@ -52,19 +59,31 @@ namespace riscv {
 			return (pending & ~served) > 0;
 		}
 
+		/* claim the lowest pending irq that is not being served */
+		u32 claim()
+		{
+			u32 mask, prev = served;
+			do {
+				mask = pending & ~prev;
+				if (mask == 0) return 0;
+			} while (!served.compare_exchange_weak(prev, prev | (1U << ctz(mask))));
+			return ctz(mask) + 1;
+		}
+
+		void complete(u64 val)
+		{
+			val--;
+			if (val < 32) {
+				served.fetch_and(~(1U << val));
+			}
+		}
+
 		/* PLIC MMIO */
 
 		void load_32(UX va, u32 &val)
 		{
 			if (va == 4) {
-				u32 mask = pending & ~served;
-				if (mask != 0) {
-					int i = ctz(mask);
-					served |= 1 << i;
-					val = i + 1;
-				} else {
-					val = 0;
-				}
+				val = claim();
 			} else {
 				val = 0;
 			}
@@ -76,14 +95,7 @@ namespace riscv {
 		void load_64(UX va, u64 &val)
 		{
 			if (va == 0) {
-				u32 mask = pending & ~served;
-				if (mask != 0) {
-					int i = ctz(mask);
-					served |= 1 << i;
-					val = i + 1;
-				} else {
-					val = 0;
-				}
+				val = claim();
 			} else {
 				val = 0;
 			}
@@ -98,10 +110,7 @@ namespace riscv {
 				printf("plic_mmio:0x%04llx <- 0x%08x\n", addr_t(va), val);
 			}
 			if (va == 4) {
-				val--;
-				if (val < 32) {
-					served &= ~(1 << val);
-				}
+				complete(val);
 			}
 		}
 
@@ -111,10 +120,7 @@ namespace riscv {
 				printf("plic_mmio:0x%04llx <- 0x%016llx\n", addr_t(va), val);
 			}
 			if (va == 0) {
-				val--;
-				if (val < 32) {
-					served &= ~(1 << val);
-				}
+				complete(val);
 			}
 		}
 
@@ -20,20 +20,36 @@ namespace riscv {
 
 		P &proc;
 		host_cpu &cpu;
+		std::mt19937 prng;
+		bool seeded;
 
 		/* RAND constructor */
 
 		rand_mmio_device(P &proc, UX mpa) :
 			memory_segment<UX>("RAND", mpa, /*uva*/0, /*size*/total_size,
 				pma_type_io | pma_prot_read),
-			proc(proc), cpu(host_cpu::get_instance())
+			proc(proc), cpu(host_cpu::get_instance()), seeded(false)
 		{}
 
+		/* RAND interface */
+
+		/* a seeded device returns a reproducible sequence */
+		void seed(u64 seed)
+		{
+			prng.seed(u32(seed ^ (seed >> 32)));
+			seeded = true;
+		}
+
+		u32 next()
+		{
+			return seeded ? u32(prng()) : cpu.get_random_seed();
+		}
+
 		/* RAND MMIO */
 
 		void load_8 (UX va, u8  &val)
 		{
-			u8 r = cpu.get_random_seed();
+			u8 r = next();
 			val = (va < total_size) ? r : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("rand_mmio:0x%04llx -> 0x%02hhx\n", addr_t(va), val);
@@ -42,7 +58,7 @@ namespace riscv {
 
 		void load_16(UX va, u16 &val)
 		{
-			u16 r = cpu.get_random_seed();
+			u16 r = next();
 			val = (va < total_size - 1) ? r : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("rand_mmio:0x%04llx -> 0x%04hx\n", addr_t(va), val);
@@ -51,7 +67,7 @@ namespace riscv {
 
 		void load_32(UX va, u32 &val)
 		{
-			u32 r = cpu.get_random_seed();
+			u32 r = next();
 			val = (va < total_size - 3) ? r : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("rand_mmio:0x%04llx -> 0x%08x\n", addr_t(va), val);
@@ -60,7 +76,7 @@ namespace riscv {
 
 		void load_64(UX va, u64 &val)
 		{
-			u64 r = (u64(cpu.get_random_seed()) << 32) | u64(cpu.get_random_seed());
+			u64 r = (u64(next()) << 32) | u64(next());
 			val = (va < total_size - 7) ? r : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("rand_mmio:0x%04llx -> 0x%016llx\n", addr_t(va), val);
@@ -15,22 +15,40 @@ namespace riscv {
 		typedef typename P::ux UX;
 
 		enum {
-			bits_per_word = sizeof(u64) << 3,
 			num_harts = NUM_HARTS,
-			total_size = bits_per_word * num_harts
+			total_size = sizeof(u64) * num_harts
 		};
 
 		P &proc;
 
 		/* Timer compare registers */
 
-		u64 timecmp[num_harts];
-		u64 claimed[num_harts];
+		/*
+		 * any hart may write a compare register while its hart claims
+		 * the interrupt, so the registers are atomic. narrow stores
+		 * update their bytes with a compare and swap
+		 */
 
-		constexpr u8* as_u8() { return (u8*)&timecmp[0]; }
-		constexpr u16* as_u16() { return (u16*)&timecmp[0]; }
-		constexpr u32* as_u32() { return (u32*)&timecmp[0]; }
-		constexpr u64* as_u64() { return (u64*)&timecmp[0]; }
+		std::atomic<u64> timecmp[num_harts];
+		std::atomic<u64> claimed[num_harts];
+
+		u64 read(UX va, size_t size)
+		{
+			va &= ~UX(size - 1);
+			u32 shift = (va & 7) << 3;
+			return (timecmp[va >> 3].load() >> shift) & (~0ULL >> (64 - (size << 3)));
+		}
+
+		void write(UX va, u64 val, size_t size)
+		{
+			va &= ~UX(size - 1);
+			u32 shift = (va & 7) << 3;
+			u64 mask = (~0ULL >> (64 - (size << 3))) << shift;
+			std::atomic<u64> &reg = timecmp[va >> 3];
+			u64 prev = reg;
+			while (!reg.compare_exchange_weak(prev, (prev & ~mask) | ((val << shift) & mask)));
+			claimed[va >> 3] = 0;
+		}
 
 		/* Timer constructor */
 
@@ -49,27 +67,34 @@ namespace riscv {
 		void print_registers()
 		{
 			for (size_t i = 0; i < num_harts; i++) {
-				debug("timer_mmio:timecmp[%04d]   0x%llx", i, timecmp[i]);
-				debug("timer_mmio:claimed[%04d]   0x%llx", i, claimed[i]);
+				debug("timer_mmio:timecmp[%04d]   0x%llx", i, timecmp[i].load());
+				debug("timer_mmio:claimed[%04d]   0x%llx", i, claimed[i].load());
 			}
 		}
 
 		bool timer_pending(UX hart_id, u64 time)
 		{
-			if (hart_id >= num_harts || claimed[hart_id] > 0) return false;
-			if (timecmp[hart_id] <= time) {
-				claimed[hart_id] = time;
-				return true;
-			} else {
-				return false;
+			if (hart_id >= num_harts) return false;
+			u64 prev = claimed[hart_id];
+			if (prev > 0 || timecmp[hart_id] > time) return false;
+			/* a store that rearmed the timer meanwhile wins */
+			return claimed[hart_id].compare_exchange_strong(prev, time);
+		}
+
+		/* compare value of an armed timer, or the maximum once it has fired */
+		u64 timer_deadline(UX hart_id)
+		{
+			if (hart_id >= num_harts || claimed[hart_id] > 0) {
+				return std::numeric_limits<u64>::max();
 			}
+			return timecmp[hart_id];
 		}
 
 		/* Timer MMIO */
 
 		void load_8 (UX va, u8  &val)
 		{
-			val = (va < total_size) ? *(as_u8() + va) : 0;
+			val = (va < total_size) ? read(va, 1) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("timer_mmio:0x%04llx -> 0x%02hhx\n", addr_t(va), val);
 			}
@@ -77,7 +102,7 @@ namespace riscv {
 
 		void load_16(UX va, u16 &val)
 		{
-			val = (va < total_size - 1) ? *(as_u16() + (va>>1)) : 0;
+			val = (va < total_size - 1) ? read(va, 2) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("timer_mmio:0x%04llx -> 0x%04hx\n", addr_t(va), val);
 			}
@@ -85,7 +110,7 @@ namespace riscv {
 
 		void load_32(UX va, u32 &val)
 		{
-			val = (va < total_size - 3) ? *(as_u32() + (va>>2)) : 0;
+			val = (va < total_size - 3) ? read(va, 4) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("timer_mmio:0x%04llx -> 0x%08x\n", addr_t(va), val);
 			}
@@ -93,7 +118,7 @@ namespace riscv {
 
 		void load_64(UX va, u64 &val)
 		{
-			val = (va < total_size - 7) ? *(as_u64() + (va>>3)) : 0;
+			val = (va < total_size - 7) ? read(va, 8) : 0;
 			if (proc.log & proc_log_mmio) {
 				printf("timer_mmio:0x%04llx -> 0x%016llx\n", addr_t(va), val);
 			}
@@ -105,8 +130,8 @@ namespace riscv {
 				printf("timer_mmio:0x%04llx <- 0x%02hhx\n", addr_t(va), val);
 			}
 			if (va < total_size) {
-				*(as_u8() + va) = val;
-				claimed[va >> 3] = 0;
+				write(va, val, 1);
+				proc.events->signal(va >> 3);
 			}
 		}
 
@@ -116,8 +141,8 @@ namespace riscv {
 				printf("timer_mmio:0x%04llx <- 0x%04hx\n", addr_t(va), val);
 			}
 			if (va < total_size - 1) {
-				*(as_u16() + (va>>1)) = val;
-				claimed[va >> 3] = 0;
+				write(va, val, 2);
+				proc.events->signal(va >> 3);
 			}
 		}
 
@@ -127,8 +152,8 @@ namespace riscv {
 				printf("timer_mmio:0x%04llx <- 0x%08x\n", addr_t(va), val);
 			}
 			if (va < total_size - 3) {
-				*(as_u32() + (va>>2)) = val;
-				claimed[va >> 3] = 0;
+				write(va, val, 4);
+				proc.events->signal(va >> 3);
 			}
 		}
 
@@ -138,8 +163,8 @@ namespace riscv {
 				printf("timer_mmio:0x%04llx <- 0x%016llx\n", addr_t(va), val);
 			}
 			if (va < total_size - 7) {
-				*(as_u64() + (va>>3)) = val;
-				claimed[va >> 3] = 0;
+				write(va, val, 8);
+				proc.events->signal(va >> 3);
 			}
 		}
 
@@ -0,0 +1,596 @@
+//
+//  device-virtio-blk.h
+//
+
+#ifndef rv_device_virtio_blk_h
+#define rv_device_virtio_blk_h
+
+namespace riscv {
+
+	/*
+	 * Virtio block MMIO device
+	 *
+	 * virtio-mmio (version 2) transport with a single request queue
+	 * serving virtio-blk requests from a host disk image. The image is
+	 * mmap'd shared, so requests are memcpy between guest RAM and the
+	 * page cache and multi-GB images are paged in on demand. A queue
+	 * notify drains every available request before publishing the used
+	 * index and raising the interrupt once for the batch. Guest buffers
+	 * written by DMA are passed to the code page filter of the notifying
+	 * hart so translated code is invalidated like a CPU store.
+	 *
+	 * Any hart may access the registers and notify the queue, so the
+	 * transport registers, queue state and request processing are
+	 * serialized by a mutex. Hart 0 takes it to update the PLIC.
+	 *
+	 * A device without an image reads DeviceID 0 and is ignored by the
+	 * guest driver. Linux finds the device with the kernel parameter
+	 * virtio_mmio.device=4K@0x40007000:5
+	 *
+	 * Reference: Virtual I/O Device (VIRTIO) Version 1.0, 4.2 and 5.2
+	 */
+
+	template <typename P>
+	struct virtio_blk_mmio_device : memory_segment<typename P::ux>
+	{
+		typedef typename P::ux UX;
+		typedef std::shared_ptr<plic_mmio_device<P>> plic_mmio_device_ptr;
+
+		enum : u32 {
+			REG_MAGIC            = 0x000,  /* (R ) Magic value 'virt' */
+			REG_VERSION          = 0x004,  /* (R ) Device version */
+			REG_DEVICE_ID        = 0x008,  /* (R ) Virtio subsystem device ID */
+			REG_VENDOR_ID        = 0x00c,  /* (R ) Virtio subsystem vendor ID */
+			REG_DEVICE_FEATURES  = 0x010,  /* (R ) Device features word */
+			REG_DEVICE_FEAT_SEL  = 0x014,  /* ( W) Device features word selection */
+			REG_DRIVER_FEATURES  = 0x020,  /* ( W) Driver features word */
+			REG_DRIVER_FEAT_SEL  = 0x024,  /* ( W) Driver features word selection */
+			REG_QUEUE_SEL        = 0x030,  /* ( W) Virtual queue index */
+			REG_QUEUE_NUM_MAX    = 0x034,  /* (R ) Maximum virtual queue size */
+			REG_QUEUE_NUM        = 0x038,  /* ( W) Virtual queue size */
+			REG_QUEUE_READY      = 0x044,  /* (RW) Virtual queue ready bit */
+			REG_QUEUE_NOTIFY     = 0x050,  /* ( W) Queue notifier */
+			REG_INTERRUPT_STATUS = 0x060,  /* (R ) Interrupt status */
+			REG_INTERRUPT_ACK    = 0x064,  /* ( W) Interrupt acknowledge */
+			REG_STATUS           = 0x070,  /* (RW) Device status */
+			REG_QUEUE_DESC_LOW   = 0x080,  /* ( W) Descriptor table address */
+			REG_QUEUE_DESC_HIGH  = 0x084,
+			REG_QUEUE_AVAIL_LOW  = 0x090,  /* ( W) Available ring address */
+			REG_QUEUE_AVAIL_HIGH = 0x094,
+			REG_QUEUE_USED_LOW   = 0x0a0,  /* ( W) Used ring address */
+			REG_QUEUE_USED_HIGH  = 0x0a4,
+			REG_CONFIG_GEN       = 0x0fc,  /* (R ) Configuration atomicity value */
+			REG_CONFIG           = 0x100,  /* (RW) Device configuration space */
+
+			MAGIC                = 0x74726976,
+			VERSION              = 2,
+			DEVICE_ID_BLK        = 2,
+			VENDOR_ID            = 0x554d4551,
+
+			QUEUE_NUM_MAX        = 256,
+			SECTOR_SIZE          = 512,
+
+			STATUS_DRIVER_OK     = 0x04,
+			STATUS_NEEDS_RESET   = 0x40,
+
+			INT_USED_RING        = 0x01,
+
+			DESC_F_NEXT          = 0x01,
+			DESC_F_WRITE         = 0x02,
+			AVAIL_F_NO_INTERRUPT = 0x01,
+
+			BLK_T_IN             = 0,
+			BLK_T_OUT            = 1,
+			BLK_T_FLUSH          = 4,
+			BLK_T_GET_ID         = 8,
+
+			BLK_S_OK             = 0,
+			BLK_S_IOERR          = 1,
+			BLK_S_UNSUPP         = 2,
+
+			BLK_ID_BYTES         = 20,
+		};
+
+		enum : u64 {
+			BLK_F_RO             = 1ULL << 5,   /* Disk is read-only */
+			BLK_F_BLK_SIZE       = 1ULL << 6,   /* Block size in blk_size */
+			BLK_F_FLUSH          = 1ULL << 9,   /* Cache flush command */
+			F_VERSION_1          = 1ULL << 32,  /* Virtio 1.0 compliant */
+		};
+
+		/* Virtqueue layout in guest memory (little-endian) */
+
+		struct virtq_desc
+		{
+			u64 addr;
+			u32 len;
+			u16 flags;
+			u16 next;
+		};
+
+		struct virtq_avail
+		{
+			u16 flags;
+			u16 idx;
+			u16 ring[];
+		};
+
+		struct virtq_used_elem
+		{
+			u32 id;
+			u32 len;
+		};
+
+		struct virtq_used
+		{
+			u16 flags;
+			u16 idx;
+			virtq_used_elem ring[];
+		};
+
+		struct virtio_blk_req
+		{
+			u32 type;
+			u32 reserved;
+			u64 sector;
+		};
+
+		/* guest buffer of a request, resolved to host memory */
+
+		struct dma_buffer
+		{
+			u64 mpa;
+			u8 *ptr;
+			u32 len;
+			bool write;
+		};
+
+		P &proc;
+		plic_mmio_device_ptr plic;
+		UX irq;
+
+		/* Disk image */
+
+		std::string filename;
+		u8 *image;
+		size_t image_size;
+		bool read_only;
+
+		/* Device configuration space */
+
+		struct {
+			u64 capacity;        /* Size in 512 byte sectors */
+			u32 size_max;
+			u32 seg_max;
+			u16 cylinders;
+			u8  heads;
+			u8  sectors;
+			u32 blk_size;
+		} config;
+
+		/* Transport registers */
+
+		u32 device_feat_sel;
+		u32 driver_feat_sel;
+		u64 driver_features;
+		u32 queue_sel;
+		u32 interrupt_status;
+		u32 status;
+
+		/* Request queue */
+
+		u32 queue_num;
+		u32 queue_ready;
+		u64 queue_desc;
+		u64 queue_avail;
+		u64 queue_used;
+		u16 last_avail_idx;
+		memory_range<UX> dma_range;
+
+		/* Held by register accesses, notify and service */
+
+		std::mutex lock;
+
+		/* Statistics */
+
+		u64 num_notify;
+		u64 num_requests;
+
+		/* Virtio block constructor */
+
+		virtio_blk_mmio_device(P &proc, UX mpa, plic_mmio_device_ptr plic, UX irq) :
+			memory_segment<UX>("VIRTIO-BLK", mpa, /*uva*/0, /*size*/0x200,
+				pma_type_io | pma_prot_read | pma_prot_write),
+			proc(proc),
+			plic(plic),
+			irq(irq),
+			image(nullptr),
+			image_size(0),
+			read_only(false),
+			config{0},
+			num_notify(0),
+			num_requests(0)
+		{
+			reset();
+		}
+
+		~virtio_blk_mmio_device()
+		{
+			if (image) {
+				msync(image, image_size, MS_SYNC);
+				munmap(image, image_size);
+			}
+		}
+
+		/* attach a disk image, read-only images are mapped without write access */
+		void open(std::string image_filename, bool image_read_only)
+		{
+			int fd = ::open(image_filename.c_str(), image_read_only ? O_RDONLY : O_RDWR);
+			if (fd < 0) {
+				panic("virtio-blk: open: %s: %s", image_filename.c_str(), strerror(errno));
+			}
+			struct stat statbuf;
+			if (fstat(fd, &statbuf) < 0) {
+				panic("virtio-blk: fstat: %s: %s", image_filename.c_str(), strerror(errno));
+			}
+			if (statbuf.st_size < SECTOR_SIZE) {
+				panic("virtio-blk: %s: image smaller than one sector", image_filename.c_str());
+			}
+			size_t size = size_t(statbuf.st_size) & ~size_t(SECTOR_SIZE - 1);
+			void *addr = mmap(nullptr, size,
+				PROT_READ | (image_read_only ? 0 : PROT_WRITE), MAP_SHARED, fd, 0);
+			close(fd);
+			if (addr == MAP_FAILED) {
+				panic("virtio-blk: mmap: %s: %s", image_filename.c_str(), strerror(errno));
+			}
+			filename = image_filename;
+			image = static_cast<u8*>(addr);
+			image_size = size;
+			read_only = image_read_only;
+			config.capacity = size / SECTOR_SIZE;
+			config.seg_max = QUEUE_NUM_MAX - 2;
+			config.blk_size = SECTOR_SIZE;
+		}
+
+		void reset()
+		{
+			device_feat_sel = 0;
+			driver_feat_sel = 0;
+			driver_features = 0;
+			queue_sel = 0;
+			interrupt_status = 0;
+			status = 0;
+			queue_num = QUEUE_NUM_MAX;
+			queue_ready = 0;
+			queue_desc = 0;
+			queue_avail = 0;
+			queue_used = 0;
+			last_avail_idx = 0;
+			dma_range = memory_range<UX>{1, 0, nullptr};
+		}
+
+		u64 device_features()
+		{
+			return F_VERSION_1 | BLK_F_BLK_SIZE | BLK_F_FLUSH | (read_only ? BLK_F_RO : 0);
+		}
+
+		void service()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			update_irq();
+		}
+
+		/* called with the lock held */
+		void update_irq()
+		{
+			plic->set_irq(irq, interrupt_status ? 1 : 0);
+		}
+
+		void print_registers()
+		{
+			debug("vblk_mmio:image            %s", image ? filename.c_str() : "(none)");
+			debug("vblk_mmio:capacity         %lld", config.capacity);
+			debug("vblk_mmio:status           0x%x", status);
+			debug("vblk_mmio:interrupt_status 0x%x", interrupt_status);
+			debug("vblk_mmio:queue_num        %d", queue_num);
+			debug("vblk_mmio:queue_ready      %d", queue_ready);
+			debug("vblk_mmio:queue_desc       0x%016llx", queue_desc);
+			debug("vblk_mmio:queue_avail      0x%016llx", queue_avail);
+			debug("vblk_mmio:queue_used       0x%016llx", queue_used);
+			debug("vblk_mmio:last_avail_idx   %d", last_avail_idx);
+			debug("vblk_mmio:notify           %lld", num_notify);
+			debug("vblk_mmio:requests         %lld", num_requests);
+		}
+
+		/* Virtio block MMIO interface */
+
+		void load_8 (UX va, u8  &val)
+		{
+			val = 0;
+			if (va >= REG_CONFIG) load_config(va - REG_CONFIG, &val, sizeof(val));
+		}
+
+		void load_16(UX va, u16 &val)
+		{
+			val = 0;
+			if (va >= REG_CONFIG) load_config(va - REG_CONFIG, &val, sizeof(val));
+		}
+
+		void load_64(UX va, u64 &val)
+		{
+			val = 0;
+			if (va >= REG_CONFIG) load_config(va - REG_CONFIG, &val, sizeof(val));
+		}
+
+		void load_config(UX offset, void *val, size_t len)
+		{
+			if (offset + len <= sizeof(config)) {
+				memcpy(val, (u8*)&config + offset, len);
+			}
+			if (proc.log & proc_log_mmio) {
+				printf("vblk_mmio:0x%04llx -> config[%zu]\n", addr_t(offset + REG_CONFIG), len);
+			}
+		}
+
+		void load_32(UX va, u32 &val)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			switch (va) {
+				case REG_MAGIC:            val = MAGIC; break;
+				case REG_VERSION:          val = VERSION; break;
+				case REG_DEVICE_ID:        val = image ? DEVICE_ID_BLK : 0; break;
+				case REG_VENDOR_ID:        val = VENDOR_ID; break;
+				case REG_DEVICE_FEATURES:
+					val = device_feat_sel < 2 ? u32(device_features() >> (device_feat_sel * 32)) : 0;
+					break;
+				case REG_QUEUE_NUM_MAX:    val = queue_sel == 0 ? QUEUE_NUM_MAX : 0; break;
+				case REG_QUEUE_READY:      val = queue_sel == 0 ? queue_ready : 0; break;
+				case REG_INTERRUPT_STATUS: val = interrupt_status; break;
+				case REG_STATUS:           val = status; break;
+				case REG_CONFIG_GEN:       val = 0; break;
+				default:
+					val = 0;
+					if (va >= REG_CONFIG) {
+						load_config(va - REG_CONFIG, &val, sizeof(val));
+						return;
+					}
+					break;
+			}
+			if (proc.log & proc_log_mmio) {
+				printf("vblk_mmio:0x%04llx -> 0x%08x\n", addr_t(va), val);
+			}
+		}
+
+		void store_32(UX va, u32 val)
+		{
+			if (proc.log & proc_log_mmio) {
+				printf("vblk_mmio:0x%04llx <- 0x%08x\n", addr_t(va), val);
+			}
+			std::lock_guard<std::mutex> guard(lock);
+			switch (va) {
+				case REG_DEVICE_FEAT_SEL:  device_feat_sel = val; break;
+				case REG_DRIVER_FEAT_SEL:  driver_feat_sel = val; break;
+				case REG_DRIVER_FEATURES:
+					if (driver_feat_sel < 2) {
+						u32 shift = driver_feat_sel * 32;
+						driver_features = (driver_features & ~(0xffffffffULL << shift)) |
+							((u64(val) << shift) & device_features());
+					}
+					break;
+				case REG_QUEUE_SEL:        queue_sel = val; break;
+				case REG_QUEUE_NUM:
+					if (queue_sel == 0 && val > 0 && val <= QUEUE_NUM_MAX && !(val & (val - 1))) {
+						queue_num = val;
+					}
+					break;
+				case REG_QUEUE_READY:      if (queue_sel == 0) queue_ready = val & 1; break;
+				case REG_QUEUE_NOTIFY:     if (val == 0) notify(); break;
+				case REG_INTERRUPT_ACK:
+					interrupt_status &= ~val;
+					update_irq();
+					break;
+				case REG_STATUS:
+					if (val == 0) {
+						reset();
+						update_irq();
+					} else {
+						status = val;
+					}
+					break;
+				case REG_QUEUE_DESC_LOW:   set_low(queue_desc, val); break;
+				case REG_QUEUE_DESC_HIGH:  set_high(queue_desc, val); break;
+				case REG_QUEUE_AVAIL_LOW:  set_low(queue_avail, val); break;
+				case REG_QUEUE_AVAIL_HIGH: set_high(queue_avail, val); break;
+				case REG_QUEUE_USED_LOW:   set_low(queue_used, val); break;
+				case REG_QUEUE_USED_HIGH:  set_high(queue_used, val); break;
+				default: break;
+			}
+		}
+
+		void set_low(u64 &reg, u32 val) { if (queue_sel == 0) reg = (reg & ~0xffffffffULL) | val; }
+		void set_high(u64 &reg, u32 val) { if (queue_sel == 0) reg = (reg & 0xffffffffULL) | (u64(val) << 32); }
+
+		/* Virtio block implementation */
+
+		/* resolve a guest physical range in RAM to host memory */
+		u8* dma(u64 mpa, size_t len)
+		{
+			memory_segment<UX> *seg = nullptr;
+			if (len == 0 || mpa + len < mpa || UX(mpa) != mpa) return nullptr;
+			addr_t uva = proc.mmu.mem->mpa_to_uva(seg, UX(mpa), dma_range);
+			if (!uva || !seg->direct || !(seg->flags & pma_type_main) ||
+				mpa - seg->mpa + len > seg->size)
+			{
+				return nullptr;
+			}
+			return reinterpret_cast<u8*>(uva);
+		}
+
+		/* DMA to guest memory invalidates translated code like a CPU store */
+		void dma_written(u64 mpa, size_t len)
+		{
+			P *hart = P::current_hart ? P::current_hart : &proc;
+			for (u64 page = mpa & ~u64(page_size - 1); page < mpa + len; page += page_size) {
+				hart->code_page_store(page);
+			}
+		}
+
+		/* called with the lock held */
+		void notify()
+		{
+			num_notify++;
+			if (!image || !queue_ready || !(status & STATUS_DRIVER_OK) ||
+				(status & STATUS_NEEDS_RESET))
+			{
+				return;
+			}
+
+			size_t num = queue_num;
+			virtq_desc *desc = reinterpret_cast<virtq_desc*>(dma(queue_desc, sizeof(virtq_desc) * num));
+			virtq_avail *avail = reinterpret_cast<virtq_avail*>(dma(queue_avail, sizeof(virtq_avail) + sizeof(u16) * num));
+			virtq_used *used = reinterpret_cast<virtq_used*>(dma(queue_used, sizeof(virtq_used) + sizeof(virtq_used_elem) * num));
+			if (!desc || !avail || !used) {
+				device_error("queue not in RAM");
+				return;
+			}
+
+			/* process the batch of available requests, then publish it once */
+			u16 used_idx = used->idx;
+			size_t completed = 0;
+			u16 avail_idx;
+			bool ok = true;
+			while (ok && (avail_idx = __atomic_load_n(&avail->idx, __ATOMIC_ACQUIRE)) != last_avail_idx) {
+				if (u16(avail_idx - last_avail_idx) > num) {
+					device_error("available index out of range");
+					break;
+				}
+				while (last_avail_idx != avail_idx) {
+					u16 head = avail->ring[last_avail_idx % num];
+					u32 len = 0;
+					if (!(ok = process_request(desc, num, head, len))) break;
+					used->ring[used_idx % num] = virtq_used_elem{ head, len };
+					last_avail_idx++;
+					used_idx++;
+					completed++;
+				}
+				__atomic_store_n(&used->idx, used_idx, __ATOMIC_RELEASE);
+			}
+			dma_written(queue_used, sizeof(virtq_used) + sizeof(virtq_used_elem) * num);
+
+			if (completed > 0 && !(avail->flags & AVAIL_F_NO_INTERRUPT)) {
+				interrupt_status |= INT_USED_RING;
+				update_irq();
+				proc.events->signal_all();
+			}
+		}
+
+		/* the driver broke the protocol, stop processing until reset */
+		void device_error(const char *reason)
+		{
+			debug("virtio-blk: %s", reason);
+			status |= STATUS_NEEDS_RESET;
+		}
+
+		/* process one descriptor chain, len is set to the bytes written to the guest */
+		bool process_request(virtq_desc *desc, size_t num, u16 head, u32 &len)
+		{
+			dma_buffer bufs[QUEUE_NUM_MAX];
+			size_t nbufs = 0;
+			u16 i = head;
+			for (;;) {
+				if (i >= num || nbufs == num) {
+					device_error("descriptor chain out of range");
+					return false;
+				}
+				virtq_desc &d = desc[i];
+				u8 *ptr = dma(d.addr, d.len);
+				if (!ptr) {
+					device_error("descriptor not in RAM");
+					return false;
+				}
+				bufs[nbufs++] = dma_buffer{ d.addr, ptr, d.len, (d.flags & DESC_F_WRITE) != 0 };
+				if (!(d.flags & DESC_F_NEXT)) break;
+				i = d.next;
+			}
+
+			/* header is the first buffer, status is the last byte of the last buffer */
+			dma_buffer &hdr = bufs[0], &st = bufs[nbufs - 1];
+			if (nbufs < 2 || hdr.write || hdr.len < sizeof(virtio_blk_req) || !st.write) {
+				device_error("malformed request");
+				return false;
+			}
+			virtio_blk_req req;
+			memcpy(&req, hdr.ptr, sizeof(req));
+			st.len--;
+
+			num_requests++;
+			u8 result = BLK_S_OK;
+			switch (req.type) {
+				case BLK_T_IN:
+				case BLK_T_OUT:
+					result = transfer(req, bufs + 1, nbufs - 1, len);
+					break;
+				case BLK_T_FLUSH:
+					if (msync(image, image_size, MS_SYNC) < 0) result = BLK_S_IOERR;
+					break;
+				case BLK_T_GET_ID:
+				{
+					char id[BLK_ID_BYTES] = { 0 };
+					strncpy(id, "rv-sys", sizeof(id));
+					result = copy_out(bufs + 1, nbufs - 1, id, sizeof(id), len) ? BLK_S_OK : BLK_S_IOERR;
+					break;
+				}
+				default:
+					result = BLK_S_UNSUPP;
+					break;
+			}
+			st.ptr[st.len] = result;
+			dma_written(st.mpa + st.len, 1);
+			len++;
+			return true;
+		}
+
+		/* copy between the image and the data buffers of a read or write */
+		u8 transfer(virtio_blk_req &req, dma_buffer *bufs, size_t nbufs, u32 &len)
+		{
+			bool in = req.type == BLK_T_IN;
+			if (!in && read_only) return BLK_S_IOERR;
+			u64 offset = req.sector * SECTOR_SIZE;
+			if (req.sector >= config.capacity) return BLK_S_IOERR;
+			for (size_t i = 0; i < nbufs; i++) {
+				dma_buffer &b = bufs[i];
+				if (b.len == 0) continue;
+				if (b.write != in || b.len > image_size - offset) return BLK_S_IOERR;
+				if (in) {
+					memcpy(b.ptr, image + offset, b.len);
+					dma_written(b.mpa, b.len);
+					len += b.len;
+				} else {
+					memcpy(image + offset, b.ptr, b.len);
+				}
+				offset += b.len;
+			}
+			return BLK_S_OK;
+		}
+
+		/* copy device data to the writable data buffers */
+		bool copy_out(dma_buffer *bufs, size_t nbufs, const void *data, size_t size, u32 &len)
+		{
+			const u8 *src = static_cast<const u8*>(data);
+			for (size_t i = 0; i < nbufs && size > 0; i++) {
+				dma_buffer &b = bufs[i];
+				if (!b.write) return false;
+				size_t n = std::min(size_t(b.len), size);
+				memcpy(b.ptr, src, n);
+				dma_written(b.mpa, n);
+				src += n;
+				size -= n;
+				len += u32(n);
+			}
+			return true;
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+//
+//  hart-events.h
+//
+
+#ifndef rv_hart_events_h
+#define rv_hart_events_h
+
+namespace riscv {
+
+	/*
+	 * Hart events
+	 *
+	 * harts executing wfi sleep on a per hart pipe until their next
+	 * timer deadline. devices, the console thread and other harts write
+	 * to the pipe of a hart to wake it when they may have made one of
+	 * its interrupts pending. a wakeup sent before the hart sleeps
+	 * leaves the pipe readable, so it is not lost. the hart thread may
+	 * longjmp out of a sleep from a signal handler, so no locks are held.
+	 */
+
+	struct hart_events
+	{
+		std::vector<std::array<int,2>> pipes;
+
+		hart_events(size_t num_harts) : pipes(num_harts)
+		{
+			for (auto &fds : pipes) {
+				if (pipe(fds.data()) < 0) {
+					panic("hart_events: pipe failed: %s", strerror(errno));
+				}
+				for (int fd : fds) {
+					if (fcntl(fd, F_SETFD, FD_CLOEXEC) < 0 || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+						panic("hart_events: fcntl failed: %s", strerror(errno));
+					}
+				}
+			}
+		}
+
+		~hart_events()
+		{
+			for (auto &fds : pipes) {
+				close(fds[0]);
+				close(fds[1]);
+			}
+		}
+
+		/* wake a hart, a full pipe already has a wakeup pending */
+		void signal(size_t hart_id)
+		{
+			if (hart_id >= pipes.size()) return;
+			u8 c = 0;
+			if (write(pipes[hart_id][1], &c, 1) < 0 && errno != EAGAIN) {
+				debug("hart_events: write: %s", strerror(errno));
+			}
+		}
+
+		void signal_all()
+		{
+			for (size_t i = 0; i < pipes.size(); i++) {
+				signal(i);
+			}
+		}
+
+		/* sleep until signalled or timeout_ns elapses, consuming wakeups */
+		void wait(size_t hart_id, u64 timeout_ns)
+		{
+			if (hart_id >= pipes.size()) return;
+			int fd = pipes[hart_id][0];
+			fd_set rfds;
+			FD_ZERO(&rfds);
+			FD_SET(fd, &rfds);
+			u64 timeout_us = (timeout_ns + 999) / 1000;
+			struct timeval tv;
+			tv.tv_sec = timeout_us / 1000000;
+			tv.tv_usec = timeout_us % 1000000;
+			if (select(fd + 1, &rfds, nullptr, nullptr, &tv) < 0 && errno != EINTR) {
+				panic("hart_events: select failed: %s", strerror(errno));
+			}
+			u8 buf[64];
+			while (read(fd, buf, sizeof(buf)) > 0);
+		}
+	};
+
+}
+
+#endif
@@ -245,12 +245,12 @@ riscv::addr_t exec_inst_rv32(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_lr_w:
 			if (rva) {
-				proc.lr = proc.ireg[dec.rs1]; s32 t; proc.mmu.template load<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+				s32 t; proc.mmu.template lr<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
 			};
 			break;
 		case rv_op_sc_w:
 			if (rva) {
-				ux res = 0; if (proc.lr != proc.ireg[dec.rs1]) res = 1; else proc.mmu.template store<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : res;
+				proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val);
 			};
 			break;
 		case rv_op_amoswap_w:
@@ -310,22 +310,22 @@ riscv::addr_t exec_inst_rv32(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_fmadd_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val + proc.freg[dec.rs3].r.s.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fmsub_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val - proc.freg[dec.rs3].r.s.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fnmsub_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -(proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val - proc.freg[dec.rs3].r.s.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fnmadd_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -(proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val + proc.freg[dec.rs3].r.s.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fadd_s:
@@ -440,22 +440,22 @@ riscv::addr_t exec_inst_rv32(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_fmadd_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val + proc.freg[dec.rs3].r.d.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fmsub_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val - proc.freg[dec.rs3].r.d.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fnmsub_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -(proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val - proc.freg[dec.rs3].r.d.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fnmadd_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -(proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val + proc.freg[dec.rs3].r.d.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fadd_d:
@@ -886,12 +886,12 @@ riscv::addr_t exec_inst_rv64(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_lr_w:
 			if (rva) {
-				proc.lr = proc.ireg[dec.rs1]; s32 t; proc.mmu.template load<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+				s32 t; proc.mmu.template lr<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
 			};
 			break;
 		case rv_op_sc_w:
 			if (rva) {
-				ux res = 0; if (proc.lr != proc.ireg[dec.rs1]) res = 1; else proc.mmu.template store<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : res;
+				proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val);
 			};
 			break;
 		case rv_op_amoswap_w:
@@ -941,12 +941,12 @@ riscv::addr_t exec_inst_rv64(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_lr_d:
 			if (rva) {
-				proc.lr = proc.ireg[dec.rs1]; s64 t; proc.mmu.template load<P,s64>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+				s64 t; proc.mmu.template lr<P,s64>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
 			};
 			break;
 		case rv_op_sc_d:
 			if (rva) {
-				ux res = 0; if (proc.lr != proc.ireg[dec.rs1]) res = 1; else proc.mmu.template store<P,s64>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.l.val); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : res;
+				proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s64>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.l.val);
 			};
 			break;
 		case rv_op_amoswap_d:
@@ -1006,22 +1006,22 @@ riscv::addr_t exec_inst_rv64(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_fmadd_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val + proc.freg[dec.rs3].r.s.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fmsub_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val - proc.freg[dec.rs3].r.s.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fnmsub_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -(proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val - proc.freg[dec.rs3].r.s.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fnmadd_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -(proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val + proc.freg[dec.rs3].r.s.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fadd_s:
@@ -1156,22 +1156,22 @@ riscv::addr_t exec_inst_rv64(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_fmadd_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val + proc.freg[dec.rs3].r.d.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fmsub_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val - proc.freg[dec.rs3].r.d.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fnmsub_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -(proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val - proc.freg[dec.rs3].r.d.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fnmadd_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -(proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val + proc.freg[dec.rs3].r.d.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fadd_d:
@@ -1632,12 +1632,12 @@ riscv::addr_t exec_inst_rv128(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_lr_w:
 			if (rva) {
-				proc.lr = proc.ireg[dec.rs1]; s32 t; proc.mmu.template load<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+				s32 t; proc.mmu.template lr<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
 			};
 			break;
 		case rv_op_sc_w:
 			if (rva) {
-				ux res = 0; if (proc.lr != proc.ireg[dec.rs1]) res = 1; else proc.mmu.template store<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : res;
+				proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val);
 			};
 			break;
 		case rv_op_amoswap_w:
@@ -1687,12 +1687,12 @@ riscv::addr_t exec_inst_rv128(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_lr_d:
 			if (rva) {
-				proc.lr = proc.ireg[dec.rs1]; s64 t; proc.mmu.template load<P,s64>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+				s64 t; proc.mmu.template lr<P,s64>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
 			};
 			break;
 		case rv_op_sc_d:
 			if (rva) {
-				ux res = 0; if (proc.lr != proc.ireg[dec.rs1]) res = 1; else proc.mmu.template store<P,s64>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.l.val); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : res;
+				proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s64>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.l.val);
 			};
 			break;
 		case rv_op_amoswap_d:
@@ -1752,22 +1752,22 @@ riscv::addr_t exec_inst_rv128(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_fmadd_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val + proc.freg[dec.rs3].r.s.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fmsub_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val - proc.freg[dec.rs3].r.s.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fnmsub_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -(proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val - proc.freg[dec.rs3].r.s.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fnmadd_s:
 			if (rvf) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -(proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val + proc.freg[dec.rs3].r.s.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
 			};
 			break;
 		case rv_op_fadd_s:
@@ -1902,22 +1902,22 @@ riscv::addr_t exec_inst_rv128(T &dec, P &proc, riscv::addr_t pc_offset)
 			break;
 		case rv_op_fmadd_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val + proc.freg[dec.rs3].r.d.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fmsub_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val - proc.freg[dec.rs3].r.d.val;
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fnmsub_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -(proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val - proc.freg[dec.rs3].r.d.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fnmadd_d:
 			if (rvd) {
-				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -(proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val + proc.freg[dec.rs3].r.d.val);
+				fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
 			};
 			break;
 		case rv_op_fadd_d:
@@ -2055,4 +2055,6622 @@ riscv::addr_t exec_inst_rv128(T &dec, P &proc, riscv::addr_t pc_offset)
 	return pc_offset;
 }
 
+#if defined(__GNUC__)
+
+/* Execute Threaded Instructions RV32 */
+
+template <bool rvi, bool rvm, bool rva, bool rvs, bool rvf, bool rvd, bool rvq, bool rvc, typename I, typename P>
+bool exec_threaded_rv32(I *&inst, I *end, P &proc, riscv::u64 inststop)
+{
+	using namespace riscv;
+	enum { xlen = 32 };
+	typedef s32 sx;
+	typedef u32 ux;
+
+	static const void* dispatch[] = {
+		&&op_illegal,
+		&&op_lui,
+		&&op_auipc,
+		&&op_jal,
+		&&op_jalr,
+		&&op_beq,
+		&&op_bne,
+		&&op_blt,
+		&&op_bge,
+		&&op_bltu,
+		&&op_bgeu,
+		&&op_lb,
+		&&op_lh,
+		&&op_lw,
+		&&op_lbu,
+		&&op_lhu,
+		&&op_sb,
+		&&op_sh,
+		&&op_sw,
+		&&op_addi,
+		&&op_slti,
+		&&op_sltiu,
+		&&op_xori,
+		&&op_ori,
+		&&op_andi,
+		&&op_slli,
+		&&op_srli,
+		&&op_srai,
+		&&op_add,
+		&&op_sub,
+		&&op_sll,
+		&&op_slt,
+		&&op_sltu,
+		&&op_xor,
+		&&op_srl,
+		&&op_sra,
+		&&op_or,
+		&&op_and,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_mul,
+		&&op_mulh,
+		&&op_mulhsu,
+		&&op_mulhu,
+		&&op_div,
+		&&op_divu,
+		&&op_rem,
+		&&op_remu,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_lr_w,
+		&&op_sc_w,
+		&&op_amoswap_w,
+		&&op_amoadd_w,
+		&&op_amoxor_w,
+		&&op_amoor_w,
+		&&op_amoand_w,
+		&&op_amomin_w,
+		&&op_amomax_w,
+		&&op_amominu_w,
+		&&op_amomaxu_w,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_flw,
+		&&op_fsw,
+		&&op_fmadd_s,
+		&&op_fmsub_s,
+		&&op_fnmsub_s,
+		&&op_fnmadd_s,
+		&&op_fadd_s,
+		&&op_fsub_s,
+		&&op_fmul_s,
+		&&op_fdiv_s,
+		&&op_fsgnj_s,
+		&&op_fsgnjn_s,
+		&&op_fsgnjx_s,
+		&&op_fmin_s,
+		&&op_fmax_s,
+		&&op_fsqrt_s,
+		&&op_fle_s,
+		&&op_flt_s,
+		&&op_feq_s,
+		&&op_fcvt_w_s,
+		&&op_fcvt_wu_s,
+		&&op_fcvt_s_w,
+		&&op_fcvt_s_wu,
+		&&op_fmv_x_s,
+		&&op_fclass_s,
+		&&op_fmv_s_x,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_fld,
+		&&op_fsd,
+		&&op_fmadd_d,
+		&&op_fmsub_d,
+		&&op_fnmsub_d,
+		&&op_fnmadd_d,
+		&&op_fadd_d,
+		&&op_fsub_d,
+		&&op_fmul_d,
+		&&op_fdiv_d,
+		&&op_fsgnj_d,
+		&&op_fsgnjn_d,
+		&&op_fsgnjx_d,
+		&&op_fmin_d,
+		&&op_fmax_d,
+		&&op_fcvt_s_d,
+		&&op_fcvt_d_s,
+		&&op_fsqrt_d,
+		&&op_fle_d,
+		&&op_flt_d,
+		&&op_feq_d,
+		&&op_fcvt_w_d,
+		&&op_fcvt_wu_d,
+		&&op_fcvt_d_w,
+		&&op_fcvt_d_wu,
+		&&op_fclass_d,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+	};
+
+	if (inst == end) return true;
+	goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+
+op_lui:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_auipc:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_jal:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + pc_offset; pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_jalr:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + pc_offset; pc_offset = (proc.ireg[dec.rs1] + dec.imm - proc.pc) & ~1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_beq:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val == proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bne:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val != proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_blt:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bge:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val >= proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bltu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bgeu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.xu.val >= proc.ireg[dec.rs2].r.xu.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lb:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s8 t; proc.mmu.template load<P,s8>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s16 t; proc.mmu.template load<P,s16>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s32 t; proc.mmu.template load<P,s32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lbu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u8 t; proc.mmu.template load<P,u8>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lhu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u16 t; proc.mmu.template load<P,u16>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sb:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s8>(proc, proc.ireg[dec.rs1] + dec.imm, s8(proc.ireg[dec.rs2]));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s16>(proc, proc.ireg[dec.rs1] + dec.imm, s16(proc.ireg[dec.rs2]));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s32>(proc, proc.ireg[dec.rs1] + dec.imm, proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addi:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val + sx(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slti:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val < sx(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sltiu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val < ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_xori:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val ^ ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_ori:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val | ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_andi:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val & ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slli:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val << dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srli:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srai:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_add:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val + proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sub:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val - proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sll:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val << (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slt:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sltu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_xor:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val ^ proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srl:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val >> (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sra:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val >> (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_or:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val | proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_and:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val & proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mul:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val * proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulh(proc.ireg[dec.rs1].r.x.val, proc.ireg[dec.rs2].r.x.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulhsu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulhsu(proc.ireg[dec.rs1].r.x.val, proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulhu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulhu(proc.ireg[dec.rs1].r.xu.val, proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_div:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val == std::numeric_limits<sx>::min() && proc.ireg[dec.rs2].r.x.val == -1 ? std::numeric_limits<sx>::min() : proc.ireg[dec.rs2].r.x.val == 0 ? -1 : proc.ireg[dec.rs1].r.x.val / proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? -1 : sx(proc.ireg[dec.rs1].r.xu.val / proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_rem:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val == std::numeric_limits<sx>::min() && proc.ireg[dec.rs2].r.x.val == -1 ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? proc.ireg[dec.rs1].r.x.val : proc.ireg[dec.rs1].r.x.val % proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? proc.ireg[dec.rs1].r.x.val : sx(proc.ireg[dec.rs1].r.xu.val % proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lr_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t; proc.mmu.template lr<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sc_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoswap_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoswap, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoadd_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoadd, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoxor_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoxor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoor_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoand_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoand, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomin_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomin, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomax_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomax, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amominu_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amominu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomaxu_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomaxu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			u32 t; proc.mmu.template load<P,u32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.freg[dec.rd].r.wu.val = t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.mmu.template store<P,f32>(proc, proc.ireg[dec.rs1] + dec.imm, proc.freg[dec.rs2].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val + proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val - proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmul_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fdiv_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val / proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnj_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = (proc.freg[dec.rs1].r.wu.val & u32(~(1U<<31))) | (proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjn_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = (proc.freg[dec.rs1].r.wu.val & u32(~(1U<<31))) | (~proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjx_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = proc.freg[dec.rs1].r.wu.val ^ (proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmin_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.s.val = (proc.freg[dec.rs1].r.s.val < proc.freg[dec.rs2].r.s.val) || std::isnan(proc.freg[dec.rs2].r.s.val) ? proc.freg[dec.rs1].r.s.val : proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmax_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.s.val = (proc.freg[dec.rs1].r.s.val > proc.freg[dec.rs2].r.s.val) || std::isnan(proc.freg[dec.rs2].r.s.val) ? proc.freg[dec.rs1].r.s.val : proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsqrt_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = riscv::f32_sqrt(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fle_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val <= proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flt_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val < proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_feq_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val == proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_w_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_w(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_wu_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_wu(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_wu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_x_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : std::isnan(proc.freg[dec.rs1].r.s.val) ? s32(0x7fc00000) : proc.freg[dec.rs1].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fclass_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : f32_classify(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_s_x:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = proc.ireg[dec.rs1].r.wu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fld:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			u64 t; proc.mmu.template load<P,u64>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.freg[dec.rd].r.lu.val = t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsd:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.mmu.template store<P,f64>(proc, proc.ireg[dec.rs1] + dec.imm, proc.freg[dec.rs2].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val + proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val - proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmul_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fdiv_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val / proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnj_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = (proc.freg[dec.rs1].r.lu.val & u64(~(1ULL<<63))) | (proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjn_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = (proc.freg[dec.rs1].r.lu.val & u64(~(1ULL<<63))) | (~proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjx_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = proc.freg[dec.rs1].r.lu.val ^ (proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmin_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.d.val = (proc.freg[dec.rs1].r.d.val < proc.freg[dec.rs2].r.d.val) || std::isnan(proc.freg[dec.rs2].r.d.val) ? proc.freg[dec.rs1].r.d.val : proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmax_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.d.val = (proc.freg[dec.rs1].r.d.val > proc.freg[dec.rs2].r.d.val) || std::isnan(proc.freg[dec.rs2].r.d.val) ? proc.freg[dec.rs1].r.d.val : proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsqrt_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = riscv::f64_sqrt(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fle_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val <= proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flt_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val < proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_feq_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val == proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_w_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_w(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_wu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_wu(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_wu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fclass_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : f64_classify(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_illegal:
+	return true;
+}
+
+/* Execute Threaded Instructions RV64 */
+
+template <bool rvi, bool rvm, bool rva, bool rvs, bool rvf, bool rvd, bool rvq, bool rvc, typename I, typename P>
+bool exec_threaded_rv64(I *&inst, I *end, P &proc, riscv::u64 inststop)
+{
+	using namespace riscv;
+	enum { xlen = 64 };
+	typedef s64 sx;
+	typedef u64 ux;
+
+	static const void* dispatch[] = {
+		&&op_illegal,
+		&&op_lui,
+		&&op_auipc,
+		&&op_jal,
+		&&op_jalr,
+		&&op_beq,
+		&&op_bne,
+		&&op_blt,
+		&&op_bge,
+		&&op_bltu,
+		&&op_bgeu,
+		&&op_lb,
+		&&op_lh,
+		&&op_lw,
+		&&op_lbu,
+		&&op_lhu,
+		&&op_sb,
+		&&op_sh,
+		&&op_sw,
+		&&op_addi,
+		&&op_slti,
+		&&op_sltiu,
+		&&op_xori,
+		&&op_ori,
+		&&op_andi,
+		&&op_slli,
+		&&op_srli,
+		&&op_srai,
+		&&op_add,
+		&&op_sub,
+		&&op_sll,
+		&&op_slt,
+		&&op_sltu,
+		&&op_xor,
+		&&op_srl,
+		&&op_sra,
+		&&op_or,
+		&&op_and,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_lwu,
+		&&op_ld,
+		&&op_sd,
+		&&op_addiw,
+		&&op_slliw,
+		&&op_srliw,
+		&&op_sraiw,
+		&&op_addw,
+		&&op_subw,
+		&&op_sllw,
+		&&op_srlw,
+		&&op_sraw,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_mul,
+		&&op_mulh,
+		&&op_mulhsu,
+		&&op_mulhu,
+		&&op_div,
+		&&op_divu,
+		&&op_rem,
+		&&op_remu,
+		&&op_mulw,
+		&&op_divw,
+		&&op_divuw,
+		&&op_remw,
+		&&op_remuw,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_lr_w,
+		&&op_sc_w,
+		&&op_amoswap_w,
+		&&op_amoadd_w,
+		&&op_amoxor_w,
+		&&op_amoor_w,
+		&&op_amoand_w,
+		&&op_amomin_w,
+		&&op_amomax_w,
+		&&op_amominu_w,
+		&&op_amomaxu_w,
+		&&op_lr_d,
+		&&op_sc_d,
+		&&op_amoswap_d,
+		&&op_amoadd_d,
+		&&op_amoxor_d,
+		&&op_amoor_d,
+		&&op_amoand_d,
+		&&op_amomin_d,
+		&&op_amomax_d,
+		&&op_amominu_d,
+		&&op_amomaxu_d,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_flw,
+		&&op_fsw,
+		&&op_fmadd_s,
+		&&op_fmsub_s,
+		&&op_fnmsub_s,
+		&&op_fnmadd_s,
+		&&op_fadd_s,
+		&&op_fsub_s,
+		&&op_fmul_s,
+		&&op_fdiv_s,
+		&&op_fsgnj_s,
+		&&op_fsgnjn_s,
+		&&op_fsgnjx_s,
+		&&op_fmin_s,
+		&&op_fmax_s,
+		&&op_fsqrt_s,
+		&&op_fle_s,
+		&&op_flt_s,
+		&&op_feq_s,
+		&&op_fcvt_w_s,
+		&&op_fcvt_wu_s,
+		&&op_fcvt_s_w,
+		&&op_fcvt_s_wu,
+		&&op_fmv_x_s,
+		&&op_fclass_s,
+		&&op_fmv_s_x,
+		&&op_fcvt_l_s,
+		&&op_fcvt_lu_s,
+		&&op_fcvt_s_l,
+		&&op_fcvt_s_lu,
+		&&op_fld,
+		&&op_fsd,
+		&&op_fmadd_d,
+		&&op_fmsub_d,
+		&&op_fnmsub_d,
+		&&op_fnmadd_d,
+		&&op_fadd_d,
+		&&op_fsub_d,
+		&&op_fmul_d,
+		&&op_fdiv_d,
+		&&op_fsgnj_d,
+		&&op_fsgnjn_d,
+		&&op_fsgnjx_d,
+		&&op_fmin_d,
+		&&op_fmax_d,
+		&&op_fcvt_s_d,
+		&&op_fcvt_d_s,
+		&&op_fsqrt_d,
+		&&op_fle_d,
+		&&op_flt_d,
+		&&op_feq_d,
+		&&op_fcvt_w_d,
+		&&op_fcvt_wu_d,
+		&&op_fcvt_d_w,
+		&&op_fcvt_d_wu,
+		&&op_fclass_d,
+		&&op_fcvt_l_d,
+		&&op_fcvt_lu_d,
+		&&op_fmv_x_d,
+		&&op_fcvt_d_l,
+		&&op_fcvt_d_lu,
+		&&op_fmv_d_x,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+	};
+
+	if (inst == end) return true;
+	goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+
+op_lui:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_auipc:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_jal:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + pc_offset; pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_jalr:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + pc_offset; pc_offset = (proc.ireg[dec.rs1] + dec.imm - proc.pc) & ~1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_beq:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val == proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bne:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val != proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_blt:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bge:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val >= proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bltu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bgeu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.xu.val >= proc.ireg[dec.rs2].r.xu.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lb:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s8 t; proc.mmu.template load<P,s8>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s16 t; proc.mmu.template load<P,s16>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s32 t; proc.mmu.template load<P,s32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lbu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u8 t; proc.mmu.template load<P,u8>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lhu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u16 t; proc.mmu.template load<P,u16>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sb:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s8>(proc, proc.ireg[dec.rs1] + dec.imm, s8(proc.ireg[dec.rs2]));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s16>(proc, proc.ireg[dec.rs1] + dec.imm, s16(proc.ireg[dec.rs2]));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s32>(proc, proc.ireg[dec.rs1] + dec.imm, proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addi:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val + sx(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slti:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val < sx(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sltiu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val < ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_xori:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val ^ ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_ori:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val | ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_andi:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val & ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_add:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val + proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sub:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val - proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sll:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val << (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slt:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sltu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_xor:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val ^ proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srl:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val >> (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sra:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val >> (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_or:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val | proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_and:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val & proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lwu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u32 t; proc.mmu.template load<P,u32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_ld:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s64 t; proc.mmu.template load<P,s64>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sd:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s64>(proc, proc.ireg[dec.rs1] + dec.imm, proc.ireg[dec.rs2].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slli:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val << dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srli:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srai:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addiw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val + dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slliw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val << dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srliw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val >> dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sraiw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.w.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val + proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_subw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val - proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sllw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val << (proc.ireg[dec.rs2] & 0b11111));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srlw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val >> (proc.ireg[dec.rs2] & 0b11111));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sraw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val >> (proc.ireg[dec.rs2] & 0b11111));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mul:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val * proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulh(proc.ireg[dec.rs1].r.x.val, proc.ireg[dec.rs2].r.x.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulhsu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulhsu(proc.ireg[dec.rs1].r.x.val, proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulhu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulhu(proc.ireg[dec.rs1].r.xu.val, proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_div:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val == std::numeric_limits<sx>::min() && proc.ireg[dec.rs2].r.x.val == -1 ? std::numeric_limits<sx>::min() : proc.ireg[dec.rs2].r.x.val == 0 ? -1 : proc.ireg[dec.rs1].r.x.val / proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? -1 : sx(proc.ireg[dec.rs1].r.xu.val / proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_rem:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val == std::numeric_limits<sx>::min() && proc.ireg[dec.rs2].r.x.val == -1 ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? proc.ireg[dec.rs1].r.x.val : proc.ireg[dec.rs1].r.x.val % proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? proc.ireg[dec.rs1].r.x.val : sx(proc.ireg[dec.rs1].r.xu.val % proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val * proc.ireg[dec.rs2].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.w.val == std::numeric_limits<s32>::min() && proc.ireg[dec.rs2].r.w.val == -1 ? std::numeric_limits<s32>::min() : proc.ireg[dec.rs2].r.w.val == 0 ? -1 : proc.ireg[dec.rs1].r.w.val / proc.ireg[dec.rs2].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divuw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.w.val == 0 ? -1 : s32(proc.ireg[dec.rs1].r.wu.val / proc.ireg[dec.rs2].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.w.val == std::numeric_limits<s32>::min() && proc.ireg[dec.rs2].r.w.val == -1 ? 0 : proc.ireg[dec.rs2].r.w.val == 0 ? proc.ireg[dec.rs1].r.w.val : proc.ireg[dec.rs1].r.w.val % proc.ireg[dec.rs2].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remuw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.w.val == 0 ? proc.ireg[dec.rs1].r.w.val : s32(proc.ireg[dec.rs1].r.wu.val % proc.ireg[dec.rs2].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lr_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t; proc.mmu.template lr<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sc_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoswap_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoswap, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoadd_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoadd, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoxor_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoxor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoor_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoand_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoand, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomin_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomin, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomax_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomax, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amominu_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amominu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomaxu_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomaxu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lr_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t; proc.mmu.template lr<P,s64>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sc_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s64>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoswap_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoswap, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoadd, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoxor_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoxor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoor_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoand_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoand, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomin_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amomin, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomax_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amomax, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amominu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amominu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomaxu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amomaxu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			u32 t; proc.mmu.template load<P,u32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.freg[dec.rd].r.wu.val = t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.mmu.template store<P,f32>(proc, proc.ireg[dec.rs1] + dec.imm, proc.freg[dec.rs2].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val + proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val - proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmul_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fdiv_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val / proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnj_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = (proc.freg[dec.rs1].r.wu.val & u32(~(1U<<31))) | (proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjn_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = (proc.freg[dec.rs1].r.wu.val & u32(~(1U<<31))) | (~proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjx_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = proc.freg[dec.rs1].r.wu.val ^ (proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmin_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.s.val = (proc.freg[dec.rs1].r.s.val < proc.freg[dec.rs2].r.s.val) || std::isnan(proc.freg[dec.rs2].r.s.val) ? proc.freg[dec.rs1].r.s.val : proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmax_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.s.val = (proc.freg[dec.rs1].r.s.val > proc.freg[dec.rs2].r.s.val) || std::isnan(proc.freg[dec.rs2].r.s.val) ? proc.freg[dec.rs1].r.s.val : proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsqrt_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = riscv::f32_sqrt(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fle_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val <= proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flt_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val < proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_feq_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val == proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_w_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_w(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_wu_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_wu(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_wu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_x_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : std::isnan(proc.freg[dec.rs1].r.s.val) ? s32(0x7fc00000) : proc.freg[dec.rs1].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fclass_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : f32_classify(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_s_x:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = proc.ireg[dec.rs1].r.wu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_l_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_l(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_lu_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_lu(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_l:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_lu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.lu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fld:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			u64 t; proc.mmu.template load<P,u64>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.freg[dec.rd].r.lu.val = t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsd:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.mmu.template store<P,f64>(proc, proc.ireg[dec.rs1] + dec.imm, proc.freg[dec.rs2].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val + proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val - proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmul_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fdiv_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val / proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnj_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = (proc.freg[dec.rs1].r.lu.val & u64(~(1ULL<<63))) | (proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjn_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = (proc.freg[dec.rs1].r.lu.val & u64(~(1ULL<<63))) | (~proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjx_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = proc.freg[dec.rs1].r.lu.val ^ (proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmin_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.d.val = (proc.freg[dec.rs1].r.d.val < proc.freg[dec.rs2].r.d.val) || std::isnan(proc.freg[dec.rs2].r.d.val) ? proc.freg[dec.rs1].r.d.val : proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmax_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.d.val = (proc.freg[dec.rs1].r.d.val > proc.freg[dec.rs2].r.d.val) || std::isnan(proc.freg[dec.rs2].r.d.val) ? proc.freg[dec.rs1].r.d.val : proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsqrt_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = riscv::f64_sqrt(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fle_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val <= proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flt_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val < proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_feq_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val == proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_w_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_w(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_wu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_wu(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_wu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fclass_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : f64_classify(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_l_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_l(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_lu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_lu(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_x_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : std::isnan(proc.freg[dec.rs1].r.d.val) ? s64(0x7ff8000000000000ULL) : proc.freg[dec.rs1].r.l.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_l:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_lu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.lu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_d_x:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = proc.ireg[dec.rs1].r.lu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_illegal:
+	return true;
+}
+
+/* Execute Threaded Instructions RV128 */
+
+template <bool rvi, bool rvm, bool rva, bool rvs, bool rvf, bool rvd, bool rvq, bool rvc, typename I, typename P>
+bool exec_threaded_rv128(I *&inst, I *end, P &proc, riscv::u64 inststop)
+{
+	using namespace riscv;
+	enum { xlen = 128 };
+	typedef s128 sx;
+	typedef u128 ux;
+
+	static const void* dispatch[] = {
+		&&op_illegal,
+		&&op_lui,
+		&&op_auipc,
+		&&op_jal,
+		&&op_jalr,
+		&&op_beq,
+		&&op_bne,
+		&&op_blt,
+		&&op_bge,
+		&&op_bltu,
+		&&op_bgeu,
+		&&op_lb,
+		&&op_lh,
+		&&op_lw,
+		&&op_lbu,
+		&&op_lhu,
+		&&op_sb,
+		&&op_sh,
+		&&op_sw,
+		&&op_addi,
+		&&op_slti,
+		&&op_sltiu,
+		&&op_xori,
+		&&op_ori,
+		&&op_andi,
+		&&op_slli,
+		&&op_srli,
+		&&op_srai,
+		&&op_add,
+		&&op_sub,
+		&&op_sll,
+		&&op_slt,
+		&&op_sltu,
+		&&op_xor,
+		&&op_srl,
+		&&op_sra,
+		&&op_or,
+		&&op_and,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_lwu,
+		&&op_ld,
+		&&op_sd,
+		&&op_addiw,
+		&&op_slliw,
+		&&op_srliw,
+		&&op_sraiw,
+		&&op_addw,
+		&&op_subw,
+		&&op_sllw,
+		&&op_srlw,
+		&&op_sraw,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_mul,
+		&&op_mulh,
+		&&op_mulhsu,
+		&&op_mulhu,
+		&&op_div,
+		&&op_divu,
+		&&op_rem,
+		&&op_remu,
+		&&op_mulw,
+		&&op_divw,
+		&&op_divuw,
+		&&op_remw,
+		&&op_remuw,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_lr_w,
+		&&op_sc_w,
+		&&op_amoswap_w,
+		&&op_amoadd_w,
+		&&op_amoxor_w,
+		&&op_amoor_w,
+		&&op_amoand_w,
+		&&op_amomin_w,
+		&&op_amomax_w,
+		&&op_amominu_w,
+		&&op_amomaxu_w,
+		&&op_lr_d,
+		&&op_sc_d,
+		&&op_amoswap_d,
+		&&op_amoadd_d,
+		&&op_amoxor_d,
+		&&op_amoor_d,
+		&&op_amoand_d,
+		&&op_amomin_d,
+		&&op_amomax_d,
+		&&op_amominu_d,
+		&&op_amomaxu_d,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_flw,
+		&&op_fsw,
+		&&op_fmadd_s,
+		&&op_fmsub_s,
+		&&op_fnmsub_s,
+		&&op_fnmadd_s,
+		&&op_fadd_s,
+		&&op_fsub_s,
+		&&op_fmul_s,
+		&&op_fdiv_s,
+		&&op_fsgnj_s,
+		&&op_fsgnjn_s,
+		&&op_fsgnjx_s,
+		&&op_fmin_s,
+		&&op_fmax_s,
+		&&op_fsqrt_s,
+		&&op_fle_s,
+		&&op_flt_s,
+		&&op_feq_s,
+		&&op_fcvt_w_s,
+		&&op_fcvt_wu_s,
+		&&op_fcvt_s_w,
+		&&op_fcvt_s_wu,
+		&&op_fmv_x_s,
+		&&op_fclass_s,
+		&&op_fmv_s_x,
+		&&op_fcvt_l_s,
+		&&op_fcvt_lu_s,
+		&&op_fcvt_s_l,
+		&&op_fcvt_s_lu,
+		&&op_fld,
+		&&op_fsd,
+		&&op_fmadd_d,
+		&&op_fmsub_d,
+		&&op_fnmsub_d,
+		&&op_fnmadd_d,
+		&&op_fadd_d,
+		&&op_fsub_d,
+		&&op_fmul_d,
+		&&op_fdiv_d,
+		&&op_fsgnj_d,
+		&&op_fsgnjn_d,
+		&&op_fsgnjx_d,
+		&&op_fmin_d,
+		&&op_fmax_d,
+		&&op_fcvt_s_d,
+		&&op_fcvt_d_s,
+		&&op_fsqrt_d,
+		&&op_fle_d,
+		&&op_flt_d,
+		&&op_feq_d,
+		&&op_fcvt_w_d,
+		&&op_fcvt_wu_d,
+		&&op_fcvt_d_w,
+		&&op_fcvt_d_wu,
+		&&op_fclass_d,
+		&&op_fcvt_l_d,
+		&&op_fcvt_lu_d,
+		&&op_fmv_x_d,
+		&&op_fcvt_d_l,
+		&&op_fcvt_d_lu,
+		&&op_fmv_d_x,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+		&&op_illegal,
+	};
+
+	if (inst == end) return true;
+	goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+
+op_lui:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_auipc:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_jal:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + pc_offset; pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_jalr:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.pc + pc_offset; pc_offset = (proc.ireg[dec.rs1] + dec.imm - proc.pc) & ~1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_beq:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val == proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bne:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val != proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_blt:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bge:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.x.val >= proc.ireg[dec.rs2].r.x.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bltu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_bgeu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			if (proc.ireg[dec.rs1].r.xu.val >= proc.ireg[dec.rs2].r.xu.val) pc_offset = dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lb:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s8 t; proc.mmu.template load<P,s8>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s16 t; proc.mmu.template load<P,s16>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s32 t; proc.mmu.template load<P,s32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lbu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u8 t; proc.mmu.template load<P,u8>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lhu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u16 t; proc.mmu.template load<P,u16>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sb:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s8>(proc, proc.ireg[dec.rs1] + dec.imm, s8(proc.ireg[dec.rs2]));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s16>(proc, proc.ireg[dec.rs1] + dec.imm, s16(proc.ireg[dec.rs2]));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s32>(proc, proc.ireg[dec.rs1] + dec.imm, proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addi:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val + sx(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slti:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val < sx(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sltiu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val < ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_xori:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val ^ ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_ori:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val | ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_andi:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val & ux(dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_add:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val + proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sub:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val - proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sll:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val << (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slt:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sltu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_xor:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val ^ proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srl:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val >> (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sra:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val >> (proc.ireg[dec.rs2] & 0b1111111);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_or:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val | proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_and:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val & proc.ireg[dec.rs2].r.xu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lwu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			u32 t; proc.mmu.template load<P,u32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_ld:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			s64 t; proc.mmu.template load<P,s64>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sd:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.mmu.template store<P,s64>(proc, proc.ireg[dec.rs1] + dec.imm, proc.ireg[dec.rs2].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addiw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val + dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slliw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val << dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srliw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val >> dec.imm);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sraiw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.w.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_addw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val + proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_subw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val - proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sllw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val << (proc.ireg[dec.rs2] & 0b11111));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srlw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val >> (proc.ireg[dec.rs2] & 0b11111));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sraw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.w.val >> (proc.ireg[dec.rs2] & 0b11111));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_slli:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val << dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srli:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.xu.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_srai:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvi) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val >> dec.imm;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mul:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val * proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulh:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulh(proc.ireg[dec.rs1].r.x.val, proc.ireg[dec.rs2].r.x.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulhsu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulhsu(proc.ireg[dec.rs1].r.x.val, proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulhu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::mulhu(proc.ireg[dec.rs1].r.xu.val, proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_div:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val == std::numeric_limits<sx>::min() && proc.ireg[dec.rs2].r.x.val == -1 ? std::numeric_limits<sx>::min() : proc.ireg[dec.rs2].r.x.val == 0 ? -1 : proc.ireg[dec.rs1].r.x.val / proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? -1 : sx(proc.ireg[dec.rs1].r.xu.val / proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_rem:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.x.val == std::numeric_limits<sx>::min() && proc.ireg[dec.rs2].r.x.val == -1 ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? proc.ireg[dec.rs1].r.x.val : proc.ireg[dec.rs1].r.x.val % proc.ireg[dec.rs2].r.x.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.x.val == 0 ? proc.ireg[dec.rs1].r.x.val : sx(proc.ireg[dec.rs1].r.xu.val % proc.ireg[dec.rs2].r.xu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_mulw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : s32(proc.ireg[dec.rs1].r.wu.val * proc.ireg[dec.rs2].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.w.val == std::numeric_limits<s32>::min() && proc.ireg[dec.rs2].r.w.val == -1 ? std::numeric_limits<s32>::min() : proc.ireg[dec.rs2].r.w.val == 0 ? -1 : proc.ireg[dec.rs1].r.w.val / proc.ireg[dec.rs2].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_divuw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.w.val == 0 ? -1 : s32(proc.ireg[dec.rs1].r.wu.val / proc.ireg[dec.rs2].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs1].r.w.val == std::numeric_limits<s32>::min() && proc.ireg[dec.rs2].r.w.val == -1 ? 0 : proc.ireg[dec.rs2].r.w.val == 0 ? proc.ireg[dec.rs1].r.w.val : proc.ireg[dec.rs1].r.w.val % proc.ireg[dec.rs2].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_remuw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvm) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.ireg[dec.rs2].r.w.val == 0 ? proc.ireg[dec.rs1].r.w.val : s32(proc.ireg[dec.rs1].r.wu.val % proc.ireg[dec.rs2].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lr_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t; proc.mmu.template lr<P,s32>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sc_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s32>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoswap_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoswap, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoadd_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoadd, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoxor_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoxor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoor_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoand_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amoand, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomin_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomin, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomax_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomax, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amominu_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amominu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomaxu_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s32 t1, t2 = proc.ireg[dec.rs2].r.w.val; proc.mmu.template amo<P,s32>(proc, amomaxu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_lr_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t; proc.mmu.template lr<P,s64>(proc, proc.ireg[dec.rs1], t); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_sc_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.mmu.template sc<P,s64>(proc, proc.ireg[dec.rs1], proc.ireg[dec.rs2].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoswap_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoswap, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoadd, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoxor_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoxor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoor_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoor, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amoand_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amoand, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomin_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amomin, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomax_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amomax, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amominu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amominu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_amomaxu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rva) {
+			s64 t1, t2 = proc.ireg[dec.rs2].r.l.val; proc.mmu.template amo<P,s64>(proc, amomaxu, proc.ireg[dec.rs1], t1, t2); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : t1;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			u32 t; proc.mmu.template load<P,u32>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.freg[dec.rd].r.wu.val = t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsw:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.mmu.template store<P,f32>(proc, proc.ireg[dec.rs1] + dec.imm, proc.freg[dec.rs2].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, -proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = -fmaf(proc.freg[dec.rs1].r.s.val, proc.freg[dec.rs2].r.s.val, proc.freg[dec.rs3].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fadd_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val + proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsub_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val - proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmul_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val * proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fdiv_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = proc.freg[dec.rs1].r.s.val / proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnj_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = (proc.freg[dec.rs1].r.wu.val & u32(~(1U<<31))) | (proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjn_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = (proc.freg[dec.rs1].r.wu.val & u32(~(1U<<31))) | (~proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjx_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = proc.freg[dec.rs1].r.wu.val ^ (proc.freg[dec.rs2].r.wu.val & u32(1U<<31));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmin_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.s.val = (proc.freg[dec.rs1].r.s.val < proc.freg[dec.rs2].r.s.val) || std::isnan(proc.freg[dec.rs2].r.s.val) ? proc.freg[dec.rs1].r.s.val : proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmax_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.s.val = (proc.freg[dec.rs1].r.s.val > proc.freg[dec.rs2].r.s.val) || std::isnan(proc.freg[dec.rs2].r.s.val) ? proc.freg[dec.rs1].r.s.val : proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsqrt_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = riscv::f32_sqrt(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fle_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val <= proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flt_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val < proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_feq_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.s.val == proc.freg[dec.rs2].r.s.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_w_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_w(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_wu_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_wu(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_wu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_x_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : std::isnan(proc.freg[dec.rs1].r.s.val) ? s32(0x7fc00000) : proc.freg[dec.rs1].r.w.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fclass_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : f32_classify(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_s_x:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			proc.freg[dec.rd].r.wu.val = proc.ireg[dec.rs1].r.wu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_l_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_l(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_lu_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_lu(proc.fcsr, proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_l:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_lu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvf) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.ireg[dec.rs1].r.lu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fld:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			u64 t; proc.mmu.template load<P,u64>(proc, proc.ireg[dec.rs1] + dec.imm, t); proc.freg[dec.rd].r.lu.val = t;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsd:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.mmu.template store<P,f64>(proc, proc.ireg[dec.rs1] + dec.imm, proc.freg[dec.rs2].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, -proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fnmadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = -fma(proc.freg[dec.rs1].r.d.val, proc.freg[dec.rs2].r.d.val, proc.freg[dec.rs3].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fadd_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val + proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsub_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val - proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmul_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val * proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fdiv_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = proc.freg[dec.rs1].r.d.val / proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnj_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = (proc.freg[dec.rs1].r.lu.val & u64(~(1ULL<<63))) | (proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjn_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = (proc.freg[dec.rs1].r.lu.val & u64(~(1ULL<<63))) | (~proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsgnjx_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = proc.freg[dec.rs1].r.lu.val ^ (proc.freg[dec.rs2].r.lu.val & u64(1ULL<<63));
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmin_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.d.val = (proc.freg[dec.rs1].r.d.val < proc.freg[dec.rs2].r.d.val) || std::isnan(proc.freg[dec.rs2].r.d.val) ? proc.freg[dec.rs1].r.d.val : proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmax_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.d.val = (proc.freg[dec.rs1].r.d.val > proc.freg[dec.rs2].r.d.val) || std::isnan(proc.freg[dec.rs2].r.d.val) ? proc.freg[dec.rs1].r.d.val : proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_s_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.s.val = f32(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_s:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.freg[dec.rs1].r.s.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fsqrt_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = riscv::f64_sqrt(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fle_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val <= proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_flt_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val < proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_feq_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : proc.freg[dec.rs1].r.d.val == proc.freg[dec.rs2].r.d.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_w_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_w(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_wu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_wu(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_w:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.w.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_wu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.wu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fclass_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : f64_classify(proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_l_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_l(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_lu_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : riscv::fcvt_lu(proc.fcsr, proc.freg[dec.rs1].r.d.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_x_d:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.ireg[dec.rd] = (dec.rd == 0) ? 0 : std::isnan(proc.freg[dec.rs1].r.d.val) ? s64(0x7ff8000000000000ULL) : proc.freg[dec.rs1].r.l.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_l:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.l.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fcvt_d_lu:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			fenv_setrm((proc.fcsr >> 5) & 0b111); proc.freg[dec.rd].r.d.val = f64(proc.ireg[dec.rs1].r.lu.val);
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_fmv_d_x:
+	{
+		auto &dec = inst->dec;
+		addr_t pc_offset = inst->pc_offset;
+		if (rvd) {
+			proc.freg[dec.rd].r.lu.val = proc.ireg[dec.rs1].r.lu.val;
+		};
+		proc.pc += pc_offset;
+		proc.cycle++;
+		proc.instret++;
+		if (pc_offset != inst->pc_offset) return false;
+		if (++inst == end || proc.instret >= inststop) return true;
+		goto *(inst->handler ? inst->handler : (inst->handler = dispatch[inst->dec.op]));
+	}
+op_illegal:
+	return true;
+}
+
+#endif
+
 #endif
@@ -38,41 +38,69 @@ namespace riscv {
 			memory_top = 0x40000000
 		};
 
+		/* guest addresses are host addresses so there is no JIT TLB */
+		enum : bool { jit_mem_direct = true };
+		enum : size_t { jit_tlb_size = 0 };
+
 		memory_type mem;
+		addr_t inst_mpa;
 
 		/* MMU constructor */
 
-		mmu_proxy() : mem(std::make_shared<MEMORY>()) {}
-		mmu_proxy(memory_type mem) : mem(mem) {}
+		mmu_proxy() : mem(std::make_shared<MEMORY>()), inst_mpa(0) {}
+		mmu_proxy(memory_type mem) : mem(mem), inst_mpa(0) {}
 
 		template <typename P> inst_t inst_fetch(P &proc, UX pc, addr_t &pc_offset)
 		{
 			/* record pc histogram using machine physical address */
 			if (proc.log & proc_log_hist_pc) {
-				size_t iters = proc.histogram_add_pc(pc);
-				if (proc.log & proc_log_jit_trap) {
-					switch (iters) {
-						case P::hostspot_trace_skip:
-							break;
-						default:
-							if (iters >= proc.hotspot_iters) {
-								proc.raise(P::internal_cause_hotspot, pc);
-							}
-							break;
-					}
-				}
+				proc.histogram_add_pc(pc);
 			}
+			proc.code_page_fetch(pc);
+			inst_mpa = pc;
 			return riscv::inst_fetch(pc, pc_offset);
 		}
 
+		void jit_flush() {}
+		void* jit_tlb(bool store) { return nullptr; }
+		template <typename P> void jit_sync(P &proc) {}
+		template <typename P> void jit_fill(P &proc, UX va, bool store) {}
+
+		/* instruction fetch translation context (tags pre-decoded code) */
+		template <typename P> constexpr addr_t code_tag(P &proc)
+		{
+			return 0;
+		}
+
 		/* Note: in this simple proxy MMU model, stores beyond memory top wrap */
 
 		template <typename P, typename T>
 		void amo(P &proc, const amo_op a_op, UX va, T &val1, T val2)
 		{
-			val1 = UX(*(T*)addr_t(va & (memory_top - 1)));
-			val2 = amo_fn<UX>(a_op, val1, val2);
-			*((T*)addr_t(va & (memory_top - 1))) = val2;
+			val1 = amo_atomic<UX>(a_op, (T*)addr_t(va & (memory_top - 1)), val2);
+			proc.code_page_store(va);
+		}
+
+		/* Note: the proxy MMU has one hart so the reservation is local */
+
+		template <typename P, typename T> void lr(P &proc, UX va, T &val)
+		{
+			val = __atomic_load_n((T*)addr_t(va & (memory_top - 1)), __ATOMIC_ACQUIRE);
+			proc.lr = va;
+			proc.lr_val = val;
+			proc.lr_valid = true;
+		}
+
+		template <typename P, typename T> UX sc(P &proc, UX va, T val)
+		{
+			T expect = T(proc.lr_val);
+			bool success = proc.lr_valid && proc.lr == addr_t(va) &&
+				__atomic_compare_exchange_n((T*)addr_t(va & (memory_top - 1)),
+					&expect, val, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+			proc.lr_valid = false;
+			if (!success) return 1;
+			proc.code_page_store(va);
+			return 0;
 		}
 
 		template <typename P, typename T> void load(P &proc, UX va, T &val)
@@ -83,6 +111,7 @@ namespace riscv {
 		template <typename P, typename T> void store(P &proc, UX va, T val)
 		{
 			*((T*)addr_t(va & (memory_top - 1))) = val;
+			proc.code_page_store(va);
 		}
 	};
 
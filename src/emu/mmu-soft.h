@@ -21,17 +21,48 @@ namespace riscv {
 			op_store
 		};
 
+		/*
+		 * JIT TLB
+		 *
+		 * compiled traces look up loads and stores in direct mapped tables
+		 * of {guest page, host address - guest address} indexed by page
+		 * number, and call load or store on a miss. entries are
+		 * filled after a successful access to a page of a direct mapped
+		 * segment and flushed when the translation context changes. store
+		 * entries are not filled for pages in the code page filter, nor
+		 * with more than one hart as stores through them do not break
+		 * LR/SC reservations. empty entries hold a page that indexes a
+		 * different entry so they never match.
+		 */
+
+		enum : bool { jit_mem_direct = false };
+		enum : size_t { jit_tlb_size = 256 };
+
+		struct jit_tlb_ent
+		{
+			addr_t tag;
+			addr_t addend;
+		};
+
 		/* MMU properties */
 
 		tlb_type       l1_itlb;     /* L1 Instruction TLB */
 		tlb_type       l1_dtlb;     /* L1 Data TLB */
 		pma_type       pma;         /* PMA table */
 		memory_type    mem;         /* memory device */
+		memory_range<UX> last_range; /* last memory range hit */
+		addr_t         inst_mpa;    /* machine physical address of the last fetch */
+		jit_tlb_ent    jit_ltlb[jit_tlb_size]; /* JIT load TLB */
+		jit_tlb_ent    jit_stlb[jit_tlb_size]; /* JIT store TLB */
+		addr_t         jit_ctx;     /* translation context of the JIT TLBs */
+		addr_t         jit_sptbr;   /* page table base of the JIT TLBs */
 
 		/* MMU constructor */
 
-		mmu_soft() : mem(std::make_shared<MEMORY>()) {}
-		mmu_soft(memory_type mem) : mem(mem) {}
+		mmu_soft() : mem(std::make_shared<MEMORY>()), last_range{1, 0, nullptr},
+			inst_mpa(0), jit_ctx(-1), jit_sptbr(0) { jit_flush(); }
+		mmu_soft(memory_type mem) : mem(mem), last_range{1, 0, nullptr},
+			inst_mpa(0), jit_ctx(-1), jit_sptbr(0) { jit_flush(); }
 
 		/* MMU methods */
 
@@ -100,6 +131,27 @@ namespace riscv {
 			);
 		}
 
+		/* convert machine physical address to user virtual address using
+		 * the page mapping cached in the TLB entry, filling it on a miss */
+		inline addr_t page_mpa_to_uva(typename tlb_type::tlb_entry_t* tlb_ent,
+			memory_segment<UX>* &segment, UX mpa)
+		{
+			if (tlb_ent && tlb_ent->seg) {
+				segment = tlb_ent->seg;
+				return tlb_ent->page_uva + (mpa & (page_size - 1));
+			}
+			addr_t uva = mem->mpa_to_uva(segment, mpa, last_range);
+			if (tlb_ent && segment) {
+				UX page_mpa = mpa & page_mask;
+				if (page_mpa >= last_range.first &&
+					page_mpa + (page_size - 1) <= last_range.last) {
+					tlb_ent->seg = segment;
+					tlb_ent->page_uva = uva - (mpa - page_mpa);
+				}
+			}
+			return uva;
+		}
+
 		/* instruction fetch */
 		template <typename P, const mmu_op op = op_fetch>
 		inst_t inst_fetch(P &proc, UX pc, addr_t &pc_offset)
@@ -117,7 +169,7 @@ namespace riscv {
 			addr_t mpa = translate_addr<P,op>(proc, pc, tlb_ent);
 
 			/* translate to user virtual (null segment indicates no mapping) */
-			addr_t uva = mem->mpa_to_uva(segment, mpa);
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
 
 			/* Check PTE flags */
 			if (unlikely(!segment ||
@@ -131,6 +183,12 @@ namespace riscv {
 					proc.histogram_add_pc(mpa);
 				}
 
+				/* mark the page so that stores invalidate cached code */
+				inst_mpa = mpa;
+				if (unlikely(proc.code_page_fetch(mpa))) {
+					jit_tlb_flush(jit_stlb);
+				}
+
 				/* fetch instruction using memory segment interface */
 				u32 inst_32;
 				segment->load(uva, inst_32);
@@ -172,7 +230,7 @@ namespace riscv {
 			addr_t mpa = translate_addr<P,op>(proc, va, tlb_ent);
 
 			/* translate to user virtual (null segment indicates no mapping) */
-			addr_t uva = mem->mpa_to_uva(segment, mpa);
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
 
 			/* Check PTE flags */
 			if (unlikely(!segment ||
@@ -181,11 +239,105 @@ namespace riscv {
 			{
 				proc.raise(rv_cause_fault_load, va);
 			} else {
-				/* TODO - we need some locking magic for SMP on non RISC-V */
-				segment->load(uva, val1);
-				val2 = amo_fn<UX>(a_op, val1, val2);
-				segment->store(uva, val2);
+				if (segment->direct) {
+					val1 = amo_atomic<UX>(a_op, (T*)uva, val2);
+				} else {
+					segment->load(uva, val1);
+					val2 = amo_fn<UX>(a_op, val1, val2);
+					segment->store(uva, val2);
+				}
+				mem->resv.store(mpa);
+				proc.code_page_store(mpa);
+			}
+		}
+
+		/* load reserved */
+		template <typename P, typename T, const mmu_op op = op_load>
+		void lr(P &proc, UX va, T &val)
+		{
+			typename tlb_type::tlb_entry_t* tlb_ent = nullptr;
+			memory_segment<UX> *segment = nullptr;
+
+			/* raise exception if address is misalligned */
+			if (unlikely(misaligned<T>(va))) {
+				proc.raise(rv_cause_misaligned_load, va);
+			}
+
+			/* translate to machine physical (raises exception on fault) */
+			addr_t mpa = translate_addr<P,op>(proc, va, tlb_ent);
+
+			/* translate to user virtual (null segment indicates no mapping) */
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
+
+			/* Check PTE flags */
+			if (unlikely(!segment ||
+				load_access_fault(proc, proc.mode, uva, tlb_ent)))
+			{
+				proc.raise(rv_cause_fault_load, va);
+			}
+
+			/* sample the granule sequence before reading the value */
+			if (proc.lr_valid) {
+				mem->resv.release(proc.lr);
+			}
+			proc.lr = mpa;
+			proc.lr_seq = mem->resv.acquire(mpa);
+			proc.lr_valid = true;
+			if (segment->direct) {
+				val = __atomic_load_n((T*)uva, __ATOMIC_ACQUIRE);
+			} else {
+				segment->load(uva, val);
 			}
+			proc.lr_val = val;
+		}
+
+		/* store conditional (returns 0 on success) */
+		template <typename P, typename T, const mmu_op op = op_store>
+		UX sc(P &proc, UX va, T val)
+		{
+			typename tlb_type::tlb_entry_t* tlb_ent = nullptr;
+			memory_segment<UX> *segment = nullptr;
+
+			/* raise exception if address is misalligned */
+			if (unlikely(misaligned<T>(va))) {
+				proc.raise(rv_cause_misaligned_store, va);
+			}
+
+			/* translate to machine physical (raises exception on fault) */
+			addr_t mpa = translate_addr<P,op>(proc, va, tlb_ent);
+
+			/* translate to user virtual (null segment indicates no mapping) */
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
+
+			/* Check PTE flags */
+			if (unlikely(!segment ||
+				store_access_fault(proc, proc.mode, uva, tlb_ent)))
+			{
+				proc.raise(rv_cause_fault_store, va);
+			}
+
+			/* fail if the reservation is missing, moved or broken */
+			if (!proc.lr_valid) return 1;
+			bool success = false;
+			if (proc.lr == mpa && mem->resv.valid(mpa, proc.lr_seq)) {
+				T expect = T(proc.lr_val);
+				if (segment->direct) {
+					success = __atomic_compare_exchange_n((T*)uva, &expect, val,
+						false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+				} else {
+					T cur;
+					segment->load(uva, cur);
+					if ((success = (cur == expect))) {
+						segment->store(uva, val);
+					}
+				}
+			}
+			mem->resv.release(proc.lr);
+			proc.lr_valid = false;
+			if (!success) return 1;
+			mem->resv.store(mpa);
+			proc.code_page_store(mpa);
+			return 0;
 		}
 
 		/* load */
@@ -204,7 +356,7 @@ namespace riscv {
 			addr_t mpa = translate_addr<P,op>(proc, va, tlb_ent);
 
 			/* translate to user virtual (null segment indicates no mapping) */
-			addr_t uva = mem->mpa_to_uva(segment, mpa);
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
 
 			/* Check PTE flags */
 			if (unlikely(!segment ||
@@ -232,7 +384,7 @@ namespace riscv {
 			addr_t mpa = translate_addr<P,op>(proc, va, tlb_ent);
 
 			/* translate to user virtual (null segment indicates no mapping) */
-			addr_t uva = mem->mpa_to_uva(segment, mpa);
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
 
 			/* Check PTE flags */
 			if (unlikely(!segment ||
@@ -241,9 +393,78 @@ namespace riscv {
 				proc.raise(rv_cause_fault_store, va);
 			} else {
 				segment->store(uva, val);
+				mem->resv.store(mpa);
+				proc.code_page_store(mpa);
 			}
 		}
 
+		/* instruction fetch translation context (tags pre-decoded code) */
+		template <typename P> constexpr addr_t code_tag(P &proc)
+		{
+			return addr_t(proc.sptbr >> tlb_type::ppn_bits) << 8 |
+				addr_t(proc.mstatus.r.vm) << 2 | addr_t(proc.mode);
+		}
+
+		static size_t jit_tlb_index(addr_t va)
+		{
+			return (va >> page_shift) & (jit_tlb_size - 1);
+		}
+
+		static void jit_tlb_flush(jit_tlb_ent *tlb)
+		{
+			for (size_t i = 0; i < jit_tlb_size; i++) {
+				tlb[i].tag = addr_t((i + 1) & (jit_tlb_size - 1)) << page_shift;
+				tlb[i].addend = 0;
+			}
+		}
+
+		void jit_flush()
+		{
+			jit_tlb_flush(jit_ltlb);
+			jit_tlb_flush(jit_stlb);
+		}
+
+		void* jit_tlb(bool store)
+		{
+			return store ? jit_stlb : jit_ltlb;
+		}
+
+		/* flush the JIT TLBs if the data translation context has changed */
+		template <typename P> void jit_sync(P &proc)
+		{
+			addr_t ctx = addr_t(proc.mstatus.r.vm) << 8 |
+				addr_t(proc.mstatus.r.mxr) << 7 |
+				addr_t(proc.mstatus.r.pum) << 6 |
+				addr_t(effective_mode(proc, op_load));
+			if (ctx != jit_ctx || addr_t(proc.sptbr) != jit_sptbr) {
+				jit_flush();
+				jit_ctx = ctx;
+				jit_sptbr = proc.sptbr;
+			}
+		}
+
+		/* fill the JIT TLB entry for an address that was just accessed */
+		template <typename P> void jit_fill(P &proc, UX va, bool store)
+		{
+			typename tlb_type::tlb_entry_t* tlb_ent = nullptr;
+			memory_segment<UX> *segment = nullptr;
+
+			addr_t mpa = store ? translate_addr<P,op_store>(proc, va, tlb_ent)
+				: translate_addr<P,op_load>(proc, va, tlb_ent);
+			addr_t uva = page_mpa_to_uva(tlb_ent, segment, mpa);
+
+			/* only whole pages of direct mapped segments */
+			UX page_mpa = mpa & page_mask;
+			if (!segment || !segment->direct) return;
+			if (tlb_ent ? !tlb_ent->seg : (page_mpa < last_range.first ||
+				page_mpa + (page_size - 1) > last_range.last)) return;
+			if (store && (proc.num_harts > 1 || proc.code_page_marked(mpa))) return;
+
+			jit_tlb_ent &ent = (store ? jit_stlb : jit_ltlb)[jit_tlb_index(va)];
+			ent.tag = addr_t(va) & ~addr_t(page_size - 1);
+			ent.addend = uva - addr_t(va);
+		}
+
 		template <typename P> constexpr UX effective_mode(P &proc, const mmu_op op)
 		{
 			/*
@@ -316,27 +537,24 @@ namespace riscv {
 			P &proc, UX va, mmu_op op,
 			tlb_type &tlb, typename tlb_type::tlb_entry_t* &tlb_ent)
 		{
-			/*
-			 * The simple direct mapped TLB implementation currently maps page_size
-			 * entries so as a byproduct, the code will rewalk the page table every
-			 * page_size interval, even if the PTE points to a megapage or gigapage.
-			 * Can be solved by adding a secondary TLB with larger scoped entries.
-			 */
-
 			typename PTM::pte_type pte;
 			addr_t pte_uva;
 			UX level;
 
-			/* TODO: TLB statistics */
-
 			/* Walk the page table to find a leaf PTE entry
 			 * (access fault is raised if leaf PTE is not found) */
 			addr_t pa = walk_page_table<P,PTM>(proc, va, op, tlb, tlb_ent,
 				pte, pte_uva, level);
 
-			/* Insert the virtual to physical mapping into the TLB */
-			tlb_ent = tlb.insert(proc.pdid, proc.sptbr >> tlb_type::ppn_bits,
-				va, level, pte.val.flags, pte.val.ppn, pte_uva);
+			/* Insert the virtual to physical mapping into the TLB,
+			 * megapages and gigapages are cached at their native size */
+			if (level > 0) {
+				tlb_ent = tlb.insert_superpage(proc.pdid, proc.sptbr >> tlb_type::ppn_bits,
+					va, level, pte.val.flags, pte.val.ppn, pte_uva);
+			} else {
+				tlb_ent = tlb.insert(proc.pdid, proc.sptbr >> tlb_type::ppn_bits,
+					va, level, pte.val.flags, pte.val.ppn, pte_uva);
+			}
 
 			return pa;
 		}
@@ -375,7 +593,7 @@ namespace riscv {
 
 				/* map the ppn into the host address space */
 				memory_segment<UX> *segment = nullptr;
-				pte_uva = mem->mpa_to_uva(segment, pte_mpa);
+				pte_uva = mem->mpa_to_uva(segment, pte_mpa, last_range);
 				if (!segment) goto fault;
 				segment->load(pte_uva, pte);
 
@@ -429,8 +647,8 @@ namespace riscv {
 		}
 	};
 
-	typedef tagged_tlb_rv32<128> tlb_type_rv32;
-	typedef tagged_tlb_rv64<128> tlb_type_rv64;
+	typedef tagged_tlb_rv32<512> tlb_type_rv32;
+	typedef tagged_tlb_rv64<512> tlb_type_rv64;
 
 	typedef pma_table<u32,8> pma_table_rv32;
 	typedef pma_table<u64,8> pma_table_rv64;
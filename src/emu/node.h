@@ -8,112 +8,92 @@
 namespace riscv {
 
 	/*
-	 * work-in-progress node class for eventual SMP implementation
+	 * node
+	 *
+	 * a node is a set of harts that share the machine physical memory map
+	 * and the devices created by the first hart. each hart has its own
+	 * registers, TLBs and code caches.
+	 *
+	 * hart 0 runs on the calling thread and handles asynchronous signals,
+	 * the other harts each run on their own host thread with asynchronous
+	 * signals blocked. when any hart stops, all of the harts are stopped.
 	 *
 	 * TODO
 	 *
-	 *  - change rv-sys to create a node with n harts
-	 *  - move the shared memory map into the node class
 	 *  - rewire debug CLI to node and allow selection of hart
 	 */
 
 	template <typename P>
-	struct node_processor : P, std::thread
+	struct node
 	{
-		node_processor() : P(), std::thread(&node_processor::mainloop) {}
+		std::vector<std::shared_ptr<P>> harts;
+		std::vector<std::thread> threads;
 
-		void mainloop()
+		node(size_t num_harts)
 		{
-			P::init();
-			P::run();
+			for (size_t i = 0; i < num_harts; i++) {
+				auto hart = std::make_shared<P>();
+				hart->hart_id = i;
+				hart->mhartid = i;
+				hart->num_harts = num_harts;
+				if (i > 0) {
+					hart->primary = harts[0].get();
+					hart->mmu.mem = harts[0]->mmu.mem;
+				}
+				harts.push_back(hart);
+			}
 		}
-	};
-
-	struct node_fault
-	{
-		static node_fault *current;
-	};
 
-	node_fault* node_fault::current = nullptr;
+		~node() { shutdown(); }
 
-	template <typename P>
-	struct node : node_fault
-	{
-		std::vector<std::shared_ptr<P>> nodes;
+		P& primary() { return *harts[0]; }
 
-		node(size_t num_nodes)
+		void init()
 		{
-			init();
-			for (size_t i = 0; i < num_nodes; i++) {
-				nodes.push_back(std::make_shared<P>());
+			for (auto &hart : harts) {
+				hart->init();
 			}
 		}
 
-		static void signal_handler(int signum, siginfo_t *info, void *)
+		void reset()
 		{
-			static_cast<node<P>*>
-				(node_fault::current)->signal_dispatch(signum, info);
+			for (auto &hart : harts) {
+				hart->reset();
+			}
 		}
 
-		void signal_dispatch(int signum, siginfo_t *info)
+		void run(exit_cause ex)
 		{
-			printf("SIGNAL   :%s\n", signal_name(signum));
+			for (size_t i = 1; i < harts.size(); i++) {
+				threads.push_back(std::thread(&node<P>::hart_main, this, harts[i]));
+			}
+			harts[0]->run(ex);
+			shutdown();
 		}
 
-		void init()
+		void hart_main(std::shared_ptr<P> hart)
 		{
-			/*
-			 * Note: the processor currently runs in the main thread.
-			 * When SMP is implemented, hart threads will be changed
-			 * to block all interrupts except for SIGSEGV and the main
-			 * thread will be configured to monitor for interrupts and
-			 * signals to deliver to the hart threads.
-			 */
-
-			// block signals before so we don't deadlock in signal handlers
-			sigset_t set;
-			sigemptyset(&set);
-			sigaddset(&set, SIGSEGV);
-			sigaddset(&set, SIGTERM);
-			sigaddset(&set, SIGQUIT);
-			sigaddset(&set, SIGINT);
-			sigaddset(&set, SIGHUP);
-			sigaddset(&set, SIGUSR1);
-			if (pthread_sigmask(SIG_BLOCK, &set, NULL) != 0) {
-				panic("can't set thread signal mask: %s", strerror(errno));
-			}
-
-			// disable unwanted signals
-			sigset_t sigpipe_set;
-			sigemptyset(&sigpipe_set);
-			sigaddset(&sigpipe_set, SIGPIPE);
-			sigprocmask(SIG_BLOCK, &sigpipe_set, nullptr);
-
-			// install signal handler
-			struct sigaction sigaction_handler;
-			memset(&sigaction_handler, 0, sizeof(sigaction_handler));
-			sigaction_handler.sa_sigaction = &node<P>::signal_handler;
-			sigaction_handler.sa_flags = SA_SIGINFO;
-			sigaction(SIGSEGV, &sigaction_handler, nullptr);
-			sigaction(SIGTERM, &sigaction_handler, nullptr);
-			sigaction(SIGQUIT, &sigaction_handler, nullptr);
-			sigaction(SIGINT, &sigaction_handler, nullptr);
-			sigaction(SIGHUP, &sigaction_handler, nullptr);
-			sigaction(SIGUSR1, &sigaction_handler, nullptr);
-			node_fault::current = this;
+			hart->init_thread();
+			hart->run(exit_cause_continue);
+			halt();
+		}
 
-			/* unblock signals */
-			if (pthread_sigmask(SIG_UNBLOCK, &set, NULL) != 0) {
-				panic("can't set thread signal mask: %s", strerror(errno));
+		void halt()
+		{
+			for (auto &hart : harts) {
+				hart->running = false;
 			}
+			/* wake harts sleeping in wfi */
+			if (harts[0]->events) harts[0]->events->signal_all();
 		}
 
 		void shutdown()
 		{
-			for (auto &node : nodes) {
-				node->shutdown();
-				node->join();
+			halt();
+			for (auto &thread : threads) {
+				thread.join();
 			}
+			threads.clear();
 		}
 	};
 
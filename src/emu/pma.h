@@ -31,6 +31,7 @@ namespace riscv {
 		enum {
 			asid_bits    = 10,       /* RV32 address space identifier bits */
 			ppn_bits     = 22,       /* RV32 physical page number bits */
+			level_bits   = 10,       /* RV32 virtual page number bits per page table level */
 		};
 	};
 
@@ -40,7 +41,8 @@ namespace riscv {
 
 		enum {
 			asid_bits    = 26,       /* RV64 address space identifier bits */
-			ppn_bits     = 38        /* RV64 physical page number bits */
+			ppn_bits     = 38,       /* RV64 physical page number bits */
+			level_bits   = 9         /* RV64 virtual page number bits per page table level */
 		};
 	};
 
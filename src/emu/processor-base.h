@@ -162,13 +162,17 @@ namespace riscv {
 		u16 node_id;                  /* Node Identifier */
 		u16 hart_id;                  /* Hardware Thread Identifier */
 		u32 log;                      /* Log flags */
-		SX lr;                        /* Load Reservation (TODO - global) */
+		addr_t lr;                    /* Load Reservation address */
+		u64 lr_val;                   /* Load Reservation value */
+		u32 lr_seq;                   /* Load Reservation sequence */
+		bool lr_valid;                /* Load Reservation held */
 		SX badaddr;                   /* Fault address */
 		jmp_buf env;                  /* Fault handler */
-		bool running;                 /* Run Loop control */
+		std::atomic<bool> running;    /* Run Loop control, cleared by other harts */
 		bool debugging;               /* Debug Step control */
 		UX breakpoint;                /* Breakpoint */
 		UX hotspot_iters;             /* Number of iterations */
+		u32 chain_budget;             /* Chained trace exits before return */
 
 		/* Base ISA Control and Status Registers */
 
@@ -178,8 +182,9 @@ namespace riscv {
 		UX fcsr;                      /* Floating-Point Control and Status Register */
 
 		processor_base() : pc(0), ireg(), freg(),
-			node_id(0), hart_id(0), log(0), lr(0), badaddr(0), env(),
-			running(true), debugging(false), breakpoint(0), hotspot_iters(0),
+			node_id(0), hart_id(0), log(0),
+			lr(0), lr_val(0), lr_seq(0), lr_valid(false), badaddr(0), env(),
+			running(true), debugging(false), breakpoint(0), hotspot_iters(0), chain_budget(0),
 			time(0), cycle(0), instret(0), fcsr(0) {}
 
 		/* Internal setjmp/longjump causes */
@@ -191,13 +196,12 @@ namespace riscv {
 			internal_cause_cli      = 0x1001,
 			internal_cause_poweroff = 0x1002,
 			internal_cause_fatal    = 0x1003,
-			internal_cause_hotspot  = 0x1004
+			internal_cause_snapshot = 0x1004
 		};
 
 		/* program counter histogram sentinels */
 		enum : size_t {
-			hostspot_trace_limit = std::numeric_limits<size_t>::max() - 1,
-			hostspot_trace_skip = std::numeric_limits<size_t>::max()
+			hostspot_trace_limit = std::numeric_limits<size_t>::max() - 1
 		};
 
 		[[noreturn]] void raise(int cause, ux addr)
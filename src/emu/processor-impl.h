@@ -40,16 +40,84 @@ namespace riscv {
 		typedef P processor_type;
 		typedef M mmu_type;
 
+		/* code page filter dimensions (one bit per page, aliases every 256MiB) */
+		enum : size_t {
+			code_page_bits = 16,
+			code_page_words = (1ULL << code_page_bits) >> 6
+		};
+
+		/* code store address sentinel (flush without a known address) */
+		enum : addr_t {
+			code_store_none = addr_t(-1)
+		};
+
 		mmu_type mmu;
 		hist_pc_map_t hist_pc;
 		hist_reg_map_t hist_reg;
+		u64 code_gen;                         /* Code generation (invalidates cached code) */
+		u64 code_map_gen;                     /* Code generation bumps due to sfence.vm */
+		u64 code_pages[code_page_words];      /* Pages instructions have been fetched from */
+		addr_t code_store_addr;               /* Store address that last hit the filter */
 
-		processor_impl() : P()
+		processor_impl() : P(), code_gen(0), code_map_gen(0), code_pages(),
+			code_store_addr(code_store_none)
 		{
 			hist_pc.set_empty_key(0);
 			hist_pc.set_deleted_key(-1);
 		}
 
+		/*
+		 * Self-modifying code detection
+		 *
+		 * The MMU marks pages in the code page filter on instruction fetch
+		 * and calls code_page_store on every store. A store to a marked page,
+		 * fence.i and sfence.vm bump the code generation, which invalidates
+		 * all pre-decoded code held by the run loop. The filter is hashed by
+		 * page number so aliasing pages cause spurious (but safe) flushes.
+		 * The address of the hitting store is kept in code_store_addr so
+		 * that run loops holding translated code can flush selectively.
+		 * sfence.vm also counts in code_map_gen, as code held by physical
+		 * address survives a change of translation.
+		 */
+
+		/* returns true if the page was not already marked */
+		inline bool code_page_fetch(addr_t addr)
+		{
+			addr_t page = addr >> page_shift;
+			u64 &word = code_pages[(page >> 6) & (code_page_words - 1)];
+			u64 bit = 1ULL << (page & 63);
+			if (likely(word & bit)) return false;
+			word |= bit;
+			return true;
+		}
+
+		inline bool code_page_marked(addr_t addr)
+		{
+			addr_t page = addr >> page_shift;
+			return (code_pages[(page >> 6) & (code_page_words - 1)] & (1ULL << (page & 63))) != 0;
+		}
+
+		inline void code_page_store(addr_t addr)
+		{
+			addr_t page = addr >> page_shift;
+			if (unlikely(code_pages[(page >> 6) & (code_page_words - 1)] & (1ULL << (page & 63)))) {
+				code_store_addr = addr;
+				code_flush();
+			}
+		}
+
+		void code_flush()
+		{
+			code_gen++;
+			memset(code_pages, 0, sizeof(code_pages));
+		}
+
+		void code_remap()
+		{
+			code_map_gen++;
+			code_gen++;
+		}
+
 		std::string format_inst(inst_t inst)
 		{
 			std::string buf;
@@ -19,6 +19,12 @@ namespace riscv {
 	#define RV_IMAFD  /*I*/true, /*M*/true,  /*A*/true,  /*S*/true, /*F*/true, /*D*/true, /*Q*/false,/*C*/false
 	#define RV_IMAFDC /*I*/true, /*M*/true,  /*A*/true,  /*S*/true, /*F*/true, /*D*/true, /*Q*/false,/*C*/true
 
+	/* Threaded interpreter uses labels as values. e.g. -DRV_NO_THREADED_INTERP to disable */
+
+	#if defined(__GNUC__) && !defined(RV_NO_THREADED_INTERP)
+	#define RV_USE_THREADED_INTERP 1
+	#endif
+
 	template <typename P>
 	static constexpr typename P::ux BASE(rv_isa isa) { return typename P::ux(isa) << (P::xlen-2); }
 	static constexpr int EXT(char x) { return 1 << (x - 'A'); }
@@ -42,6 +48,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv32<RV_I>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv32<RV_I>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -61,6 +73,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv32<RV_IMA>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv32<RV_IMA>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -81,6 +99,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv32<RV_IMAC>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv32<RV_IMAC>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -100,6 +124,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv32<RV_IMAFD>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv32<RV_IMAFD>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -120,6 +150,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv32<RV_IMAFDC>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv32<RV_IMAFDC>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 
@@ -142,6 +178,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv64<RV_I>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv64<RV_I>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -161,6 +203,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv64<RV_IMA>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv64<RV_IMA>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -181,6 +229,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv64<RV_IMAC>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv64<RV_IMAC>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -200,6 +254,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv64<RV_IMAFD>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv64<RV_IMAFD>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -220,6 +280,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv64<RV_IMAFDC>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv64<RV_IMAFDC>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 
@@ -242,6 +308,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv128<RV_I>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv128<RV_I>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -261,6 +333,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv128<RV_IMA>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv128<RV_IMA>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -281,6 +359,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv128<RV_IMAC>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv128<RV_IMAC>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -300,6 +384,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv128<RV_IMAFD>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv128<RV_IMAFD>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 	template <typename T, typename P, typename M, typename B = processor_impl<T,P,M>>
@@ -320,6 +410,12 @@ namespace riscv {
 		addr_t inst_exec(T &dec, addr_t pc_offset) {
 			return exec_inst_rv128<RV_IMAFDC>(dec, *this, pc_offset);
 		}
+
+	#if RV_USE_THREADED_INTERP
+		template <typename I> bool inst_exec_threaded(I *&inst, I *end, u64 inststop) {
+			return exec_threaded_rv128<RV_IMAFDC>(inst, end, *this, inststop);
+		}
+	#endif
 	};
 
 }
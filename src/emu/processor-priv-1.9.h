@@ -243,6 +243,9 @@ namespace riscv {
 	template <typename P>
 	struct processor_privileged : P
 	{
+		/* wakes harts from wfi, destroyed after the console thread that signals it */
+		std::shared_ptr<hart_events> events;
+
 		std::shared_ptr<console_device<processor_privileged>> console;
 		std::shared_ptr<sbi_mmio_device<processor_privileged>> device_sbi;
 		std::shared_ptr<boot_mmio_device<processor_privileged>> device_boot;
@@ -254,9 +257,55 @@ namespace riscv {
 		std::shared_ptr<gpio_mmio_device<processor_privileged>> device_gpio;
 		std::shared_ptr<rand_mmio_device<processor_privileged>> device_rand;
 		std::shared_ptr<htif_mmio_device<processor_privileged>> device_htif;
+		std::shared_ptr<virtio_blk_mmio_device<processor_privileged>> device_blk;
 		std::shared_ptr<config_mmio_device<processor_privileged>> device_config;
 		std::shared_ptr<string_mmio_device<processor_privileged>> device_string;
 
+		/* SMP harts share the devices of the primary hart, serviced by hart 0 */
+		processor_privileged *primary = nullptr;
+		size_t num_harts = 1;
+
+		/* hart running on the calling thread, used by devices to raise */
+		static thread_local processor_privileged *current_hart;
+
+		/*
+		 * event scheduling
+		 *
+		 * the next event of a hart is its armed timer compare value.
+		 * each step is bounded to the instructions expected to retire
+		 * before it, using the retire rate per RTC tick measured over
+		 * previous steps, so timer interrupts are taken close to their
+		 * deadline rather than at the next inst_step boundary. UART,
+		 * PLIC and IPI state is level triggered and serviced at step
+		 * boundaries. devices are serviced by hart 0 only, the other
+		 * harts read the atomic PLIC pending bits. wfi sleeps until the
+		 * next event unless an interrupt enabled in mie is pending, and
+		 * devices signal the shared hart events to wake sleeping harts.
+		 */
+		u64 rate_time = 0;
+		u64 rate_instret = 0;
+		u64 retire_rate = 1;
+
+		static const u64 rate_span = 1000;                  /* 100us */
+		static const size_t event_step_min = 1000;
+		static const u64 wfi_sleep_max = 100000000ULL;      /* 100ms */
+
+		/*
+		 * icount mode
+		 *
+		 * guest time advances one RTC tick every 2^icount_shift retired
+		 * instructions plus the idle time skipped by wfi, instead of
+		 * following the host clock, so runs of a single hart are
+		 * reproducible. steps end exactly at timer deadlines and wfi
+		 * advances time to the next deadline instead of sleeping.
+		 */
+		bool icount = false;
+		u32 icount_shift = 0;
+		u64 icount_skip = 0;
+
+		/* added to the host clock so a restored snapshot resumes at its saved time */
+		u64 time_offset = 0;
+
 		const char* name() { return "rv-sys"; }
 
 		const u64 RTC_FREQ = 10000000;
@@ -264,11 +313,15 @@ namespace riscv {
 
 		u64 get_time()
 		{
+			if (icount) {
+				return (u64(P::instret) >> icount_shift) + icount_skip;
+			}
+
 			/*
 			 * TODO - add hz to config string
 			 * 10MHz is currently hardcoded in BBL
 			 */
-			return host_cpu::get_instance().get_time_ns() / RTC_DIV;
+			return host_cpu::get_instance().get_time_ns() / RTC_DIV + time_offset;
 		}
 
 		std::string create_config_string()
@@ -305,15 +358,24 @@ ram {
   };
 };
 core {
-  0 {
+%s};)CONFIG";
+			static const char* kCoreFormat =
+R"CONFIG(  %d {
     0 {
       isa rv64imafd;
       ipi 0x%x;
       timecmp 0x%x;
     };
   };
-};)CONFIG";
-			std::string cfg_str;
+)CONFIG";
+			std::string core_str, cfg_str;
+			for (size_t i = 0; i < num_harts; i++) {
+				std::string hart_str;
+				sprintf(hart_str, kCoreFormat, i,
+					device_mipi->mpa + i * sizeof(u32),
+					device_timer->mpa + i * sizeof(u64));
+				core_str += hart_str;
+			}
 			sprintf(cfg_str, kConfigFormat,
 				device_rtc->mpa,
 				RTC_FREQ,
@@ -321,17 +383,44 @@ core {
 				device_htif->mpa,
 				device_htif->mpa + 8,
 				ram_base, ram_size,
-				device_mipi->mpa,
-				device_timer->mpa);
+				core_str.c_str());
 			return cfg_str;
 		}
 
+		/* devices in the memory map keep the console, stop its thread while this hart exists */
+		~processor_privileged()
+		{
+			if (console && !primary) console->shutdown();
+		}
+
 		void init()
 		{
 			/* set initial value for misa register */
 			P::misa = P::misa_default;
 
+			/* secondary harts use the devices of the primary hart */
+			if (primary) {
+				events = primary->events;
+				console = primary->console;
+				device_sbi = primary->device_sbi;
+				device_boot = primary->device_boot;
+				device_rtc = primary->device_rtc;
+				device_mipi = primary->device_mipi;
+				device_plic = primary->device_plic;
+				device_uart = primary->device_uart;
+				device_timer = primary->device_timer;
+				device_gpio = primary->device_gpio;
+				device_rand = primary->device_rand;
+				device_htif = primary->device_htif;
+				device_blk = primary->device_blk;
+				device_config = primary->device_config;
+				device_string = primary->device_string;
+				return;
+			}
+			current_hart = this;
+
 			/* create TIME, MIPI, PLIC and UART devices */
+			events = std::make_shared<hart_events>(num_harts);
 			console = std::make_shared<console_device<processor_privileged>>(*this);
 			device_sbi = std::make_shared<sbi_mmio_device<processor_privileged>>(*this, s32(0xfffff000));
 			device_boot = std::make_shared<boot_mmio_device<processor_privileged>>(*this, 0x1000);
@@ -343,6 +432,7 @@ core {
 			device_gpio = std::make_shared<gpio_mmio_device<processor_privileged>>(*this, 0x40005000, device_plic, 4);
 			device_rand = std::make_shared<rand_mmio_device<processor_privileged>>(*this, 0x40006000);
 			device_htif = std::make_shared<htif_mmio_device<processor_privileged>>(*this, 0x40008000, console);
+			device_blk = std::make_shared<virtio_blk_mmio_device<processor_privileged>>(*this, 0x40007000, device_plic, 5);
 			device_config = std::make_shared<config_mmio_device<processor_privileged>>(*this, 0x4000f000);
 			device_string  = std::make_shared<string_mmio_device<processor_privileged>>(*this, 0x40010000, create_config_string());
 
@@ -361,10 +451,16 @@ core {
 			P::mmu.mem->add_segment(device_gpio);
 			P::mmu.mem->add_segment(device_rand);
 			P::mmu.mem->add_segment(device_htif);
+			P::mmu.mem->add_segment(device_blk);
 			P::mmu.mem->add_segment(device_config);
 			P::mmu.mem->add_segment(device_string);
 		}
 
+		void init_thread()
+		{
+			current_hart = this;
+		}
+
 		void print_device_registers()
 		{
 			device_rtc->print_registers();
@@ -374,6 +470,7 @@ core {
 			device_timer->print_registers();
 			device_gpio->print_registers();
 			device_htif->print_registers();
+			device_blk->print_registers();
 			device_config->print_registers();
 		}
 
@@ -657,15 +754,23 @@ core {
 					}
 				case rv_op_sfence_vm:
 					if (P::mode >= rv_mode_S) {
-						P::mmu.l1_itlb.flush(P::pdid, P::sptbr >> P::mmu_type::tlb_type::ppn_bits);
-						P::mmu.l1_dtlb.flush(P::pdid, P::sptbr >> P::mmu_type::tlb_type::ppn_bits);
+						/* rs1 selects a single virtual address, otherwise flush the current ASID */
+						typename P::ux asid = P::sptbr >> P::mmu_type::tlb_type::ppn_bits;
+						if (dec.rs1 != rv_ireg_zero) {
+							P::mmu.l1_itlb.flush(P::pdid, asid, P::ireg[dec.rs1]);
+							P::mmu.l1_dtlb.flush(P::pdid, asid, P::ireg[dec.rs1]);
+						} else {
+							P::mmu.l1_itlb.flush(P::pdid, asid);
+							P::mmu.l1_dtlb.flush(P::pdid, asid);
+						}
+						P::code_remap();
 						return pc_offset;
 					} else {
 						return -1; /* illegal instruction */
 					}
 				case rv_op_wfi:
 					if (P::mode >= rv_mode_S) {
-						std::this_thread::yield();
+						wfi_sleep();
 						return pc_offset;
 					} else {
 						return -1; /* illegal instruction */
@@ -673,6 +778,7 @@ core {
 				case rv_op_fence:
 					return pc_offset;
 				case rv_op_fence_i:
+					P::code_flush();
 					return pc_offset;
 				default: break;
 			}
@@ -707,12 +813,83 @@ core {
 			}
 		}
 
-		void isr()
+		/* instructions to step before the next event, at most count */
+		size_t step_limit(size_t count)
 		{
-			/* service all external devices connected to the PLIC */
+			u64 deadline = device_timer->timer_deadline(P::hart_id);
+			if (icount) {
+				if (deadline == std::numeric_limits<u64>::max()) return count;
+				u64 ticks = deadline > icount_skip ? deadline - icount_skip : 0;
+				if (ticks > (std::numeric_limits<u64>::max() >> icount_shift)) return count;
+				u64 target = ticks << icount_shift;
+				u64 steps = target > u64(P::instret) ? target - u64(P::instret) : 0;
+				return size_t(std::max(u64(1), std::min(u64(count), steps)));
+			}
+			if (deadline <= P::time) return std::min(count, event_step_min);
+			u64 ticks = deadline - P::time;
+			if (ticks >= count) return count;
+			return size_t(std::min(u64(count), std::max(ticks * retire_rate, u64(event_step_min))));
+		}
 
+		/* update the PLIC from the external devices, on hart 0 only */
+		void service_devices()
+		{
+			if (P::hart_id != 0) return;
 			device_uart->service();
 			device_gpio->service();
+			device_blk->service();
+		}
+
+		/* an interrupt enabled in mie is pending, regardless of mstatus */
+		bool wfi_pending()
+		{
+			service_devices();
+			bool eip = device_plic->irq_pending();
+			bool tip = device_timer->timer_deadline(P::hart_id) <= get_time();
+			bool sip = device_mipi->ipi_pending(P::hart_id) ||
+				(P::hart_id == 0 && console->has_char());
+			return (P::mip.xu.val & P::mie.xu.val) ||
+				(eip && (P::mie.r.meie || P::mie.r.seie)) ||
+				(tip && (P::mie.r.mtie || P::mie.r.stie)) ||
+				(sip && (P::mie.r.msie || P::mie.r.ssie));
+		}
+
+		/* sleep until an interrupt is pending, the next timer deadline or a wakeup */
+		void wfi_sleep()
+		{
+			if (!P::running.load(std::memory_order_relaxed) || P::debugging || wfi_pending()) return;
+			u64 deadline = device_timer->timer_deadline(P::hart_id);
+			u64 now = get_time();
+			if (deadline <= now) return;
+
+			/* skip idle time, an unarmed timer waits for a device */
+			if (icount && deadline != std::numeric_limits<u64>::max()) {
+				icount_skip += deadline - now;
+				return;
+			}
+
+			u64 ticks = deadline - now;
+			u64 timeout_ns = ticks < wfi_sleep_max / RTC_DIV ? ticks * RTC_DIV : wfi_sleep_max;
+			events->wait(P::hart_id, timeout_ns);
+
+			/* exclude the sleep from the retire rate */
+			rate_time = get_time();
+			rate_instret = P::instret;
+		}
+
+		void isr()
+		{
+			/* measure the retire rate */
+			u64 now = P::time = get_time();
+			if (now - rate_time >= rate_span) {
+				retire_rate = std::max(u64(1), u64(P::instret - rate_instret) / (now - rate_time));
+				rate_time = now;
+				rate_instret = P::instret;
+			}
+
+			/* service all external devices connected to the PLIC */
+
+			service_devices();
 
 			/*
 			 * service external interrupts from the PLIC if enabled
@@ -762,7 +939,8 @@ core {
 			 */
 
 			/* NOTE: delegation is implicit based on enable bits in this model */
-			bool sip = device_mipi->ipi_pending(P::hart_id) || console->has_char();
+			bool sip = device_mipi->ipi_pending(P::hart_id) ||
+				(P::hart_id == 0 && console->has_char());
 			if (sip) {
 				P::mip.r.msip = 1;
 				P::mip.r.ssip = 1;
@@ -797,6 +975,17 @@ core {
 			/* check for reset */
 			if (cause == P::internal_cause_reset) return;
 
+			/* a snapshot request retires the GPIO store and stops the hart */
+			if (cause == P::internal_cause_snapshot) {
+				addr_t pc_offset;
+				P::mmu.inst_fetch(*this, P::pc, pc_offset);
+				P::pc += pc_offset;
+				P::cycle++;
+				P::instret++;
+				P::running = false;
+				return;
+			}
+
 			/* translate causes that we catch as illegal instructions */
 			if (cause == rv_cause_illegal_instruction) {
 				switch (dec.op) {
@@ -912,6 +1101,9 @@ core {
 
 	};
 
+	template <typename P>
+	thread_local processor_privileged<P>* processor_privileged<P>::current_hart = nullptr;
+
 }
 
 #endif
@@ -56,12 +56,15 @@ namespace riscv {
 				case rv_op_csrrwi: return inst_csr(dec, csr_rw, dec.imm, dec.rs1, pc_offset);
 				case rv_op_csrrsi: return inst_csr(dec, csr_rs, dec.imm, dec.rs1, pc_offset);
 				case rv_op_csrrci: return inst_csr(dec, csr_rc, dec.imm, dec.rs1, pc_offset);
+				case rv_op_fence:  return pc_offset;
+				case rv_op_fence_i: P::code_flush(); return pc_offset;
 				default: break;
 			}
 			return -1; /* illegal instruction */
 		}
 
 		void isr() {}
+		size_t step_limit(size_t count) { return count; }
 		void debug_enter() {}
 		void debug_leave() {}
 
@@ -7,19 +7,21 @@
 
 namespace riscv {
 
-	/* Simple processor stepper with instruction cache */
+	/* Simple processor stepper with instruction cache and basic block cache */
 
 	struct processor_fault
 	{
-		static processor_fault *current;
+		static thread_local processor_fault *current;
 	};
 
-	processor_fault* processor_fault::current = nullptr;
+	thread_local processor_fault* processor_fault::current = nullptr;
 
 	template <typename P>
 	struct processor_runloop : processor_fault, P
 	{
 		static const size_t inst_cache_size = 8191;
+		static const size_t block_cache_size = 1024;
+		static const size_t block_inst_max = 32;
 		static const int inst_step = 100000;
 
 		std::shared_ptr<debug_cli<P>> cli;
@@ -30,10 +32,42 @@ namespace riscv {
 			typename P::decode_type dec;
 		};
 
+		/*
+		 * Basic block cache
+		 *
+		 * A direct mapped cache of pre-decoded instruction runs indexed by
+		 * program counter and tagged with the fetch translation context and
+		 * the code generation. Blocks are recorded as they are executed and
+		 * run until a taken control transfer, a privileged instruction or a
+		 * page boundary. A block that falls through its last entry is extended
+		 * the next time through, so not-taken branches do not end a block.
+		 */
+
+		struct rv_block_inst
+		{
+			typename P::decode_type dec;
+			inst_t inst;
+			addr_t pc_offset;
+			const void *handler;
+		};
+
+		struct rv_block_cache_ent
+		{
+			typename P::ux pc;
+			addr_t tag;
+			u64 gen;
+			size_t len;
+			rv_block_inst insts[block_inst_max];
+		};
+
 		rv_inst_cache_ent inst_cache[inst_cache_size];
+		std::vector<rv_block_cache_ent> block_cache;
+		rv_block_inst *block_inst;
 
-		processor_runloop() : cli(std::make_shared<debug_cli<P>>()), inst_cache() {}
-		processor_runloop(std::shared_ptr<debug_cli<P>> cli) : cli(cli), inst_cache() {}
+		processor_runloop() : cli(std::make_shared<debug_cli<P>>()), inst_cache(),
+			block_cache(block_cache_size), block_inst(nullptr) {}
+		processor_runloop(std::shared_ptr<debug_cli<P>> cli) : cli(cli), inst_cache(),
+			block_cache(block_cache_size), block_inst(nullptr) {}
 
 		static void signal_handler(int signum, siginfo_t *info, void *)
 		{
@@ -51,6 +85,37 @@ namespace riscv {
 		}
 
 		void init()
+		{
+			/* signals are handled on the main thread by hart 0 */
+			if (P::hart_id == 0) {
+				init_signals();
+			}
+
+			/* processor initialization */
+			P::init();
+		}
+
+		/* secondary hart thread initialization */
+		void init_thread()
+		{
+			/* leave asynchronous signals to the main thread */
+			sigset_t set;
+			sigemptyset(&set);
+			sigaddset(&set, SIGTERM);
+			sigaddset(&set, SIGQUIT);
+			sigaddset(&set, SIGINT);
+			sigaddset(&set, SIGHUP);
+			sigaddset(&set, SIGUSR1);
+			if (pthread_sigmask(SIG_BLOCK, &set, NULL) != 0) {
+				panic("can't set thread signal mask: %s", strerror(errno));
+			}
+
+			/* faults on this thread are dispatched to this hart */
+			processor_fault::current = this;
+			P::init_thread();
+		}
+
+		void init_signals()
 		{
 			// block signals before so we don't deadlock in signal handlers
 			sigset_t set;
@@ -88,9 +153,6 @@ namespace riscv {
 			if (pthread_sigmask(SIG_UNBLOCK, &set, NULL) != 0) {
 				panic("can't set thread signal mask: %s", strerror(errno));
 			}
-
-			/* processor initialization */
-			P::init();
 		}
 
 		void run(exit_cause ex = exit_cause_continue)
@@ -100,6 +162,8 @@ namespace riscv {
 			for (;;) {
 				switch (ex) {
 					case exit_cause_continue:
+						/* another hart may have stopped the node */
+						if (!P::running.load(std::memory_order_relaxed)) return;
 						break;
 					case exit_cause_cli:
 						P::debugging = true;
@@ -122,16 +186,28 @@ namespace riscv {
 			}
 		}
 
+		inline void inst_fetch_decode(typename P::decode_type &dec, inst_t &inst, addr_t &pc_offset)
+		{
+			inst = P::mmu.inst_fetch(*this, P::pc, pc_offset);
+			inst_t inst_cache_key = inst % inst_cache_size;
+			if (inst_cache[inst_cache_key].inst == inst) {
+				dec = inst_cache[inst_cache_key].dec;
+			} else {
+				P::inst_decode(dec, inst);
+				inst_cache[inst_cache_key].inst = inst;
+				inst_cache[inst_cache_key].dec = dec;
+			}
+		}
+
 		exit_cause step(size_t count)
 		{
 			typename P::decode_type dec;
-			typename P::ux inststop = P::instret + count;
 			addr_t pc_offset, new_offset;
-			inst_t inst = 0, inst_cache_key;
+			inst_t inst = 0;
 
-			/* interrupt service routine */
-			P::time = cpu_cycle_clock();
+			/* interrupt service routine, stepping no further than the next event */
 			P::isr();
+			typename P::ux inststop = P::instret + P::step_limit(count);
 
 			/* trap return path */
 			int cause;
@@ -147,33 +223,106 @@ namespace riscv {
 					case P::internal_cause_poweroff:
 						return exit_cause_poweroff;
 				}
+				if (block_inst) {
+					dec = block_inst->dec;
+					block_inst = nullptr;
+				}
 				P::trap(dec, cause);
-				if (!P::running) return exit_cause_poweroff;
+				if (!P::running.load(std::memory_order_relaxed)) return exit_cause_poweroff;
+			}
+
+			/* the pc histogram needs to observe every instruction fetch */
+			if (unlikely(P::log & proc_log_hist_pc)) {
+				while (P::instret < inststop) {
+					if (P::pc == P::breakpoint && P::breakpoint != 0) {
+						return exit_cause_cli;
+					}
+					inst_fetch_decode(dec, inst, pc_offset);
+					if ((new_offset = P::inst_exec(dec, pc_offset)) != -1  ||
+						(new_offset = P::inst_priv(dec, pc_offset)) != -1)
+					{
+						if (P::log) P::print_log(dec, inst);
+						P::pc += new_offset;
+						P::cycle++;
+						P::instret++;
+					} else {
+						P::raise(rv_cause_illegal_instruction, P::pc);
+					}
+				}
+				return exit_cause_continue;
 			}
 
-			/* step the processor */
+			/* step the processor using the basic block cache */
 			while (P::instret < inststop) {
 				if (P::pc == P::breakpoint && P::breakpoint != 0) {
 					return exit_cause_cli;
 				}
-				inst = P::mmu.inst_fetch(*this, P::pc, pc_offset);
-				inst_cache_key = inst % inst_cache_size;
-				if (inst_cache[inst_cache_key].inst == inst) {
-					dec = inst_cache[inst_cache_key].dec;
-				} else {
-					P::inst_decode(dec, inst);
-					inst_cache[inst_cache_key].inst = inst;
-					inst_cache[inst_cache_key].dec = dec;
+
+				/* look up block, resetting the entry on a miss */
+				addr_t tag = P::mmu.code_tag(*this);
+				rv_block_cache_ent &blk = block_cache[(P::pc >> 1) & (block_cache_size - 1)];
+				if (blk.pc != P::pc || blk.tag != tag || blk.gen != P::code_gen) {
+					blk.pc = P::pc;
+					blk.tag = tag;
+					blk.gen = P::code_gen;
+					blk.len = 0;
+				}
+
+				size_t i = 0;
+
+			#if RV_USE_THREADED_INTERP
+				/* run the recorded instructions on the threaded interpreter */
+				if (blk.len > 0 && !P::log && !P::breakpoint) {
+					block_inst = blk.insts;
+					bool fallthrough = P::inst_exec_threaded(block_inst,
+						blk.insts + blk.len, inststop);
+					i = block_inst - blk.insts;
+					block_inst = nullptr;
+					if (!fallthrough || i == block_inst_max || P::instret >= inststop) continue;
+					if (i == blk.len && ((P::pc - blk.insts[i - 1].pc_offset) ^ P::pc) >> page_shift) continue;
 				}
-				if ((new_offset = P::inst_exec(dec, pc_offset)) != -1  ||
-					(new_offset = P::inst_priv(dec, pc_offset)) != -1)
-				{
+			#endif
+
+				/* execute pre-decoded instructions, recording past the end */
+				for (;;) {
+					if (i < blk.len) {
+						dec = blk.insts[i].dec;
+						inst = blk.insts[i].inst;
+						pc_offset = blk.insts[i].pc_offset;
+					} else {
+						inst_fetch_decode(dec, inst, pc_offset);
+						blk.insts[i].dec = dec;
+						blk.insts[i].inst = inst;
+						blk.insts[i].pc_offset = pc_offset;
+						blk.insts[i].handler = nullptr;
+						blk.len = i + 1;
+					}
+					new_offset = P::inst_exec(dec, pc_offset);
+					bool priv = (new_offset == -1);
+					if (priv && (new_offset = P::inst_priv(dec, pc_offset)) == -1) {
+						P::raise(rv_cause_illegal_instruction, P::pc);
+					}
 					if (P::log) P::print_log(dec, inst);
 					P::pc += new_offset;
 					P::cycle++;
 					P::instret++;
-				} else {
-					P::raise(rv_cause_illegal_instruction, P::pc);
+
+					/* privileged instructions may change mode, translation or code,
+					   wfi returns so the next step services pending interrupts */
+					if (priv) {
+						if (dec.op == rv_op_wfi) return exit_cause_continue;
+						break;
+					}
+
+					/* taken control transfer */
+					if (new_offset != pc_offset) break;
+
+					/* blocks end at page boundaries so fetch faults are precise */
+					if (++i == block_inst_max || ((P::pc - pc_offset) ^ P::pc) >> page_shift) break;
+					if (P::instret >= inststop) break;
+					if (P::pc == P::breakpoint && P::breakpoint != 0) {
+						return exit_cause_cli;
+					}
 				}
 			}
 			return exit_cause_continue;
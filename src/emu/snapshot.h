@@ -0,0 +1,408 @@
+//
+//  snapshot.h
+//
+
+#ifndef rv_snapshot_h
+#define rv_snapshot_h
+
+namespace riscv {
+
+	/*
+	 * Snapshot
+	 *
+	 * a snapshot holds a stopped node: the registers and CSRs of each
+	 * hart, the device state and the non-zero pages of main memory. the
+	 * file is a header, a state record, a table of the main memory
+	 * regions outside RAM (ELF segments), an index of physical page
+	 * numbers and the page aligned page data. restore adds the regions
+	 * and maps runs of pages from the file into them copy-on-write, so
+	 * one snapshot can be shared by many runs and each run only reads
+	 * the pages it touches. short runs are read instead, to bound the
+	 * number of host mappings.
+	 *
+	 * TLBs and translated code are not saved and start cold, LR
+	 * reservations are dropped and the disk image of the block device
+	 * is not saved, so the same image must be attached on restore. a
+	 * snapshot saved with --icount takes its time from the instruction
+	 * count and must be restored with the same shift.
+	 */
+
+	struct snapshot_header
+	{
+		u64 magic;
+		u32 version;
+		u32 xlen;
+		u32 num_harts;
+		u32 page_shift;
+		u32 icount;          /* time follows the instruction count */
+		u32 icount_shift;
+		u64 ram_base;
+		u64 ram_size;
+		u64 time;            /* RTC time when saved */
+		u64 num_pages;       /* pages in the index */
+		u64 num_regions;     /* main memory regions outside RAM */
+		u64 state_offset;
+		u64 state_size;
+		u64 region_offset;
+		u64 index_offset;
+		u64 data_offset;
+
+		enum : u64 {
+			snapshot_magic = 0x313050414e535652ULL, /* "RVSNAP01" */
+		};
+
+		enum : u32 {
+			snapshot_version = 3,
+		};
+
+		static snapshot_header read(int fd, const char *filename)
+		{
+			snapshot_header hdr;
+			if (pread(fd, &hdr, sizeof(hdr), 0) != ssize_t(sizeof(hdr)) ||
+				hdr.magic != snapshot_magic || hdr.version != snapshot_version)
+			{
+				panic("snapshot: %s: not a snapshot", filename);
+			}
+			if (hdr.page_shift != riscv::page_shift) {
+				panic("snapshot: %s: page size mismatch", filename);
+			}
+			return hdr;
+		}
+
+		static snapshot_header read(const char *filename)
+		{
+			int fd = open(filename, O_RDONLY);
+			if (fd < 0) {
+				panic("snapshot: open: %s: %s", filename, strerror(errno));
+			}
+			snapshot_header hdr = read(fd, filename);
+			close(fd);
+			return hdr;
+		}
+	};
+
+	/* main memory region outside RAM */
+	struct snapshot_region
+	{
+		u64 mpa;
+		u64 size;
+		u64 flags;
+	};
+
+	/* appends fields to a state record */
+	struct snapshot_writer
+	{
+		std::vector<u8> buf;
+
+		template <typename T>
+		void field(T &val)
+		{
+			const u8 *p = reinterpret_cast<const u8*>(&val);
+			buf.insert(buf.end(), p, p + sizeof(T));
+		}
+	};
+
+	/* reads fields back from a state record in the same order */
+	struct snapshot_reader
+	{
+		std::vector<u8> buf;
+		size_t pos = 0;
+
+		template <typename T>
+		void field(T &val)
+		{
+			if (pos + sizeof(T) > buf.size()) {
+				panic("snapshot: truncated state");
+			}
+			memcpy(reinterpret_cast<u8*>(&val), buf.data() + pos, sizeof(T));
+			pos += sizeof(T);
+		}
+	};
+
+	template <typename P>
+	struct snapshot
+	{
+		typedef typename P::ux UX;
+
+		enum : size_t {
+			map_run_min = 16    /* shorter runs of pages are read, not mapped */
+		};
+
+		/* hart state in saved order */
+		template <typename S>
+		static void hart_state(S &s, P &h)
+		{
+			s.field(h.pc);
+			s.field(h.ireg);
+			s.field(h.freg);
+			s.field(h.fcsr);
+			s.field(h.cycle);
+			s.field(h.instret);
+			s.field(h.pdid);
+			s.field(h.mode);
+			s.field(h.misa);
+			s.field(h.mstatus);
+			s.field(h.mtvec);
+			s.field(h.medeleg);
+			s.field(h.mideleg);
+			s.field(h.mip);
+			s.field(h.mie);
+			s.field(h.mhcounteren);
+			s.field(h.mscounteren);
+			s.field(h.mucounteren);
+			s.field(h.mscratch);
+			s.field(h.mepc);
+			s.field(h.mcause);
+			s.field(h.mbadaddr);
+			s.field(h.mbase);
+			s.field(h.mbound);
+			s.field(h.mibase);
+			s.field(h.mibound);
+			s.field(h.mdbase);
+			s.field(h.mdbound);
+			s.field(h.stvec);
+			s.field(h.sedeleg);
+			s.field(h.sideleg);
+			s.field(h.sscratch);
+			s.field(h.sepc);
+			s.field(h.scause);
+			s.field(h.sbadaddr);
+			s.field(h.sptbr);
+			s.field(h.icount_skip);
+		}
+
+		/* shared device state in saved order */
+		template <typename S>
+		static void device_state(S &s, P &proc)
+		{
+			s.field(proc.device_uart->com);
+			s.field(proc.device_plic->pending);
+			s.field(proc.device_plic->served);
+			s.field(proc.device_timer->timecmp);
+			s.field(proc.device_timer->claimed);
+			s.field(proc.device_rtc->mtime);
+			s.field(proc.device_mipi->hart);
+			s.field(proc.device_gpio->gpio);
+			s.field(proc.device_rand->prng);
+			s.field(proc.device_rand->seeded);
+			s.field(proc.device_config->num_harts);
+			s.field(proc.device_config->time_base);
+			s.field(proc.device_config->rom_base);
+			s.field(proc.device_config->rom_size);
+			s.field(proc.device_config->rom_entry);
+			s.field(proc.device_config->ram_base);
+			s.field(proc.device_config->ram_size);
+			s.field(proc.device_blk->device_feat_sel);
+			s.field(proc.device_blk->driver_feat_sel);
+			s.field(proc.device_blk->driver_features);
+			s.field(proc.device_blk->queue_sel);
+			s.field(proc.device_blk->interrupt_status);
+			s.field(proc.device_blk->status);
+			s.field(proc.device_blk->queue_num);
+			s.field(proc.device_blk->queue_ready);
+			s.field(proc.device_blk->queue_desc);
+			s.field(proc.device_blk->queue_avail);
+			s.field(proc.device_blk->queue_used);
+			s.field(proc.device_blk->last_avail_idx);
+		}
+
+		/* the RAM segment, ELF segments loaded at boot are added before it */
+		static memory_segment<UX>* ram_segment(P &proc, UX ram_base)
+		{
+			for (auto &seg : proc.mmu.mem->segments) {
+				if (seg->direct && (seg->flags & pma_type_main) &&
+					seg->mpa == ram_base && strcmp(seg->name, "RAM") == 0)
+				{
+					return seg.get();
+				}
+			}
+			panic("snapshot: unable to locate ram");
+		}
+
+		/* guest view of a page of main memory, ELF segments shadow RAM */
+		static u8* mem_page(P &proc, UX mpa, memory_range<UX> &range)
+		{
+			memory_segment<UX> *seg = nullptr;
+			addr_t uva = proc.mmu.mem->mpa_to_uva(seg, mpa, range);
+			if (!uva || !seg->direct || !(seg->flags & pma_type_main)) {
+				panic("snapshot: 0x%llx is not main memory", addr_t(mpa));
+			}
+			return reinterpret_cast<u8*>(uva);
+		}
+
+		static bool page_is_zero(const u8 *page)
+		{
+			const u64 *p = reinterpret_cast<const u64*>(page);
+			for (size_t i = 0; i < page_size / sizeof(u64); i++) {
+				if (p[i]) return false;
+			}
+			return true;
+		}
+
+		/* save the state of a stopped node */
+		static void save(node<P> &harts, UX ram_base, std::string filename)
+		{
+			P &proc = harts.primary();
+			memory_segment<UX> *ram_seg = ram_segment(proc, ram_base);
+			size_t ram_size = ram_seg->size;
+
+			/* ELF segments within RAM are saved through the RAM pages they shadow */
+			std::vector<snapshot_region> regions;
+			for (auto &seg : proc.mmu.mem->segments) {
+				if (seg.get() == ram_seg || !seg->direct || !(seg->flags & pma_type_main)) continue;
+				u64 seg_end = u64(seg->mpa) + seg->size;
+				if (seg->mpa >= ram_base && seg_end <= ram_base + ram_size) continue;
+				if (seg->mpa < ram_base + ram_size && seg_end > ram_base) {
+					panic("snapshot: %s segment 0x%llx overlaps the end of ram", seg->name, addr_t(seg->mpa));
+				}
+				if ((seg->mpa | seg->size) & (page_size - 1)) {
+					panic("snapshot: %s segment 0x%llx is not page aligned", seg->name, addr_t(seg->mpa));
+				}
+				regions.push_back({ seg->mpa, seg->size, seg->flags });
+			}
+
+			snapshot_writer state;
+			for (auto &hart : harts.harts) {
+				hart_state(state, *hart);
+			}
+			device_state(state, proc);
+
+			memory_range<UX> range{1, 0, nullptr};
+			std::vector<u64> index;
+			auto add_pages = [&](u64 mpa, u64 size) {
+				for (u64 page = mpa >> page_shift; page < (mpa + size) >> page_shift; page++) {
+					if (!page_is_zero(mem_page(proc, UX(page << page_shift), range))) {
+						index.push_back(page);
+					}
+				}
+			};
+			add_pages(ram_base, ram_size);
+			for (auto &r : regions) {
+				add_pages(r.mpa, r.size);
+			}
+
+			snapshot_header hdr;
+			memset(&hdr, 0, sizeof(hdr));
+			hdr.magic = snapshot_header::snapshot_magic;
+			hdr.version = snapshot_header::snapshot_version;
+			hdr.xlen = P::xlen;
+			hdr.num_harts = u32(harts.harts.size());
+			hdr.page_shift = page_shift;
+			hdr.icount = proc.icount;
+			hdr.icount_shift = proc.icount_shift;
+			hdr.ram_base = ram_base;
+			hdr.ram_size = ram_size;
+			hdr.time = proc.get_time();
+			hdr.num_pages = index.size();
+			hdr.num_regions = regions.size();
+			hdr.state_offset = sizeof(hdr);
+			hdr.state_size = state.buf.size();
+			hdr.region_offset = hdr.state_offset + hdr.state_size;
+			hdr.index_offset = hdr.region_offset + regions.size() * sizeof(snapshot_region);
+			hdr.data_offset = round_up(hdr.index_offset + index.size() * sizeof(u64), page_size);
+
+			/*
+			 * write a new file and rename it over the target, which may be
+			 * mapped by this process if it was restored from the same file
+			 */
+			std::string tmp_filename = filename + ".tmp";
+			FILE *file = fopen(tmp_filename.c_str(), "w");
+			if (!file) {
+				panic("snapshot: fopen: %s: %s", tmp_filename.c_str(), strerror(errno));
+			}
+			bool ok = fwrite(&hdr, sizeof(hdr), 1, file) == 1 &&
+				fwrite(state.buf.data(), 1, state.buf.size(), file) == state.buf.size() &&
+				fwrite(regions.data(), sizeof(snapshot_region), regions.size(), file) == regions.size() &&
+				fwrite(index.data(), sizeof(u64), index.size(), file) == index.size() &&
+				fseek(file, hdr.data_offset, SEEK_SET) == 0;
+			for (size_t i = 0; ok && i < index.size(); i++) {
+				ok = fwrite(mem_page(proc, UX(index[i] << page_shift), range), page_size, 1, file) == 1;
+			}
+			ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+			if (fclose(file) != 0 || !ok) {
+				panic("snapshot: write: %s: %s", tmp_filename.c_str(), strerror(errno));
+			}
+			if (rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+				panic("snapshot: rename: %s: %s", filename.c_str(), strerror(errno));
+			}
+		}
+
+		/* restore a snapshot into a reset node with only RAM of the saved size */
+		static void restore(node<P> &harts, std::string filename)
+		{
+			P &proc = harts.primary();
+			int fd = open(filename.c_str(), O_RDONLY);
+			if (fd < 0) {
+				panic("snapshot: open: %s: %s", filename.c_str(), strerror(errno));
+			}
+			snapshot_header hdr = snapshot_header::read(fd, filename.c_str());
+			if (hdr.xlen != P::xlen || hdr.num_harts != harts.harts.size()) {
+				panic("snapshot: %s: xlen or number of harts mismatch", filename.c_str());
+			}
+			if (ram_segment(proc, UX(hdr.ram_base))->size != hdr.ram_size) {
+				panic("snapshot: %s: ram size mismatch", filename.c_str());
+			}
+			if (hdr.icount != u32(proc.icount) || (hdr.icount && hdr.icount_shift != proc.icount_shift)) {
+				panic("snapshot: %s: saved with %s, restore with the same time base", filename.c_str(),
+					hdr.icount ? format_string("--icount %u", hdr.icount_shift).c_str() : "the host clock");
+			}
+
+			snapshot_reader state;
+			std::vector<snapshot_region> regions(hdr.num_regions);
+			std::vector<u64> index(hdr.num_pages);
+			state.buf.resize(hdr.state_size);
+			if (pread(fd, state.buf.data(), hdr.state_size, hdr.state_offset) != ssize_t(hdr.state_size) ||
+				pread(fd, regions.data(), regions.size() * sizeof(snapshot_region), hdr.region_offset) !=
+					ssize_t(regions.size() * sizeof(snapshot_region)) ||
+				pread(fd, index.data(), index.size() * sizeof(u64), hdr.index_offset) !=
+					ssize_t(index.size() * sizeof(u64)))
+			{
+				panic("snapshot: %s: truncated", filename.c_str());
+			}
+			for (auto &hart : harts.harts) {
+				hart_state(state, *hart);
+			}
+			device_state(state, proc);
+
+			/* main memory outside RAM, such as the ELF segments of the saved boot */
+			for (auto &r : regions) {
+				proc.mmu.mem->add_anon("MAIN", UX(r.mpa), r.size, UX(r.flags));
+			}
+
+			/* map runs of consecutive pages within a segment, read short runs */
+			memory_range<UX> range{1, 0, nullptr};
+			for (size_t i = 0, j; i < index.size(); i = j) {
+				UX mpa = UX(index[i] << page_shift);
+				u8 *page = mem_page(proc, mpa, range);
+				u64 last = range.last >> page_shift;
+				for (j = i + 1; j < index.size() && index[j] == index[j - 1] + 1 && index[j] <= last; j++);
+				off_t offset = hdr.data_offset + (i << page_shift);
+				size_t len = (j - i) << page_shift;
+				if (j - i >= map_run_min) {
+					proc.mmu.mem->map_fd(mpa, fd, offset, len);
+				} else if (pread(fd, page, len, offset) != ssize_t(len)) {
+					panic("snapshot: %s: truncated", filename.c_str());
+				}
+			}
+			close(fd);
+
+			/*
+			 * resume at the saved time, the saved instret and idle skip
+			 * already give it with --icount and time_offset stays zero
+			 */
+			for (auto &hart : harts.harts) {
+				hart->lr_valid = false;
+				hart->time_offset = 0;
+				hart->time_offset = hdr.time - hart->get_time();
+				hart->time = hart->get_time();
+				hart->rate_time = hart->time;
+				hart->rate_instret = hart->instret;
+				hart->code_flush();
+			}
+			proc.device_blk->dma_range = memory_range<UX>{1, 0, nullptr};
+		}
+	};
+
+}
+
+#endif
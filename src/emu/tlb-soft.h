@@ -13,6 +13,9 @@ namespace riscv {
 	 * protection domain and address space tagged virtual to physical mapping with page attributes
 	 *
 	 * tlb[PDID:ASID:VPN] = PPN:PTE.bits:PMA
+	 *
+	 * the memory segment and user virtual address of the page are filled in
+	 * on the first access so later accesses skip the physical address lookup
 	 */
 
 	template <typename PARAM>
@@ -44,6 +47,10 @@ namespace riscv {
 		addr_t  uva;                   /* User Virtual Address of PTE */
 		pdid_t  pdid;                  /* Protection Domain Identifier */
 		pma_t   pma;                   /* Physical Memory Attributes copy */
+		memory_segment<UX> *seg;       /* Memory segment of the page (cached on first access) */
+		addr_t  page_uva;              /* User Virtual Address of the page */
+		u32     gen;                   /* TLB generation at insert */
+		u32     agen;                  /* ASID generation at insert */
 
 		tagged_tlb_entry() :
 			ppn(ppn_limit),
@@ -53,7 +60,11 @@ namespace riscv {
 			pteb(0),
 			uva(0),
 			pdid(0),
-			pma(0) {}
+			pma(0),
+			seg(nullptr),
+			page_uva(0),
+			gen(0),
+			agen(0) {}
 
 		tagged_tlb_entry(UX pdid, UX asid, UX vpn, UX ptel, UX pteb, addr_t uva, UX ppn) :
 			ppn(ppn),
@@ -63,14 +74,25 @@ namespace riscv {
 			pteb(pteb),
 			uva(uva),
 			pdid(pdid),
-			pma(0) {}
+			pma(0),
+			seg(nullptr),
+			page_uva(0),
+			gen(0),
+			agen(0) {}
 	};
 
 
 	/*
 	 * tagged_tlb
 	 *
-	 * protection domain and address space tagged direct mapped tlb
+	 * protection domain and address space tagged set associative tlb
+	 * with tree pseudo-LRU replacement, and a small fully associative
+	 * superpage tlb that holds megapage and gigapage leaves at their
+	 * native size. superpage hits are copied into the page sets.
+	 *
+	 * entries are stamped with the TLB generation and the generation of
+	 * their ASID bucket, so a global or per-ASID flush is a counter bump.
+	 * entries from a stale generation are treated as invalid.
 	 *
 	 * tlb[PDID:ASID:VPN] = PPN:PTE.bits:PMA
 	 */
@@ -89,28 +111,132 @@ namespace riscv {
 			mask = (1ULL << shift) - 1,
 			key_size = sizeof(tlb_entry_t),
 			asid_bits = PARAM::asid_bits,
-			ppn_bits = PARAM::ppn_bits
+			ppn_bits = PARAM::ppn_bits,
+			level_bits = PARAM::level_bits,
+			default_ways = 4,
+			max_ways = 32,
+			superpage_size = 16,
+			asid_gen_size = 256
 		};
 
 		// TODO - map TLB to machine address space with user_memory::add_segment
 
-		tlb_entry_t tlb[size];
+		std::vector<tlb_entry_t> tlb;          /* num_sets * num_ways page entries */
+		std::vector<u32> plru;                 /* pseudo-LRU tree bits per set */
+		tlb_entry_t stlb[superpage_size];      /* superpage entries */
+		u32 stlb_plru;                         /* superpage pseudo-LRU tree bits */
+		u32 gen;                               /* current TLB generation */
+		u32 asid_gen[asid_gen_size];           /* current generation per ASID bucket */
+		size_t num_sets;
+		size_t num_ways;
+		size_t set_mask;
 
-		tagged_tlb() : tlb() {}
+		/* statistics */
+		u64 hits;
+		u64 misses;
+		u64 evictions;
 
-		void flush(UX pdid)
+		u64 flushes;
+
+		tagged_tlb() : stlb(), stlb_plru(0), gen(1), asid_gen(), hits(0), misses(0), evictions(0), flushes(0)
+		{
+			resize(size, std::min(size_t(default_ways), size_t(size)));
+		}
+
+		void resize(size_t entries, size_t ways)
 		{
-			for (size_t i = 0; i < size; i++) {
-				if (tlb[i].pdid != pdid) continue;
-				tlb[i] = tlb_entry_t();
+			if (!ispow2(entries) || !ispow2(ways) || ways > entries || ways > max_ways) {
+				panic("tlb: entries (%zu) and ways (%zu) must be powers of 2 with ways <= min(entries, %d)",
+					entries, ways, (int)max_ways);
 			}
+			num_ways = ways;
+			num_sets = entries / ways;
+			set_mask = num_sets - 1;
+			plru.assign(num_sets, 0);
+			stlb_plru = 0;
+			clear();
 		}
 
+		/* physically invalidate all entries and restart the generations */
+		void clear()
+		{
+			tlb.assign(num_sets * num_ways, tlb_entry_t());
+			for (size_t i = 0; i < superpage_size; i++) {
+				stlb[i] = tlb_entry_t();
+			}
+			for (size_t i = 0; i < asid_gen_size; i++) {
+				asid_gen[i] = 0;
+			}
+			gen = 1;
+		}
+
+		/* tree pseudo-LRU, node n has children 2n and 2n+1, leaves are ways + way */
+
+		static inline size_t plru_victim(u32 bits, size_t ways)
+		{
+			size_t node = 1;
+			while (node < ways) node = (node << 1) | ((bits >> node) & 1);
+			return node - ways;
+		}
+
+		static inline void plru_touch(u32 &bits, size_t way, size_t ways)
+		{
+			for (size_t node = way + ways; node > 1; node >>= 1) {
+				if (node & 1) bits &= ~(1U << (node >> 1));
+				else bits |= (1U << (node >> 1));
+			}
+		}
+
+		inline bool valid(tlb_entry_t &ent)
+		{
+			return ent.gen == gen && ent.agen == asid_gen[ent.asid & (asid_gen_size - 1)];
+		}
+
+		static inline bool covers(tlb_entry_t &ent, UX vpn)
+		{
+			return ((vpn ^ ent.vpn) >> (ent.ptel * level_bits)) == 0;
+		}
+
+		/* flush all entries, the PDID is not used as domains share the generation */
+		void flush(UX pdid)
+		{
+			flushes++;
+			if (++gen == 0) clear();
+		}
+
+		/* flush all entries for the ASID (and any ASID sharing its generation bucket) */
 		void flush(UX pdid, UX asid)
 		{
-			for (size_t i = 0; i < size; i++) {
-				if (asid != 0 && tlb[i].pdid != pdid && tlb[i].asid != asid) continue;
-				tlb[i] = tlb_entry_t();
+			flushes++;
+			if (++asid_gen[asid & (asid_gen_size - 1)] == 0) clear();
+		}
+
+		/* flush the entries translating VA for the ASID, including superpages covering VA */
+		void flush(UX pdid, UX asid, UX va)
+		{
+			UX vpn = va >> page_shift;
+			flushes++;
+			tlb_entry_t *ent = &tlb[(vpn & set_mask) * num_ways];
+			for (size_t way = 0; way < num_ways; way++, ent++) {
+				if (ent->vpn == vpn && ent->asid == asid && ent->pdid == pdid) {
+					*ent = tlb_entry_t();
+				}
+			}
+			for (size_t i = 0; i < superpage_size; i++) {
+				ent = stlb + i;
+				if (ent->ptel == 0 || ent->asid != asid || ent->pdid != pdid) continue;
+				if (!valid(*ent) || !covers(*ent, vpn)) continue;
+				flush_copies(*ent);
+				*ent = tlb_entry_t();
+			}
+		}
+
+		/* invalidate page set copies of a superpage entry (rare, scans the page sets) */
+		void flush_copies(tlb_entry_t &sp)
+		{
+			for (auto &ent : tlb) {
+				if (ent.ptel != sp.ptel || ent.asid != sp.asid || ent.pdid != sp.pdid) continue;
+				if (covers(sp, ent.vpn)) ent = tlb_entry_t();
 			}
 		}
 
@@ -118,19 +244,70 @@ namespace riscv {
 		tlb_entry_t* lookup(UX pdid, UX asid, UX va)
 		{
 			UX vpn = va >> page_shift;
-			size_t i = vpn & mask;
-			return tlb[i].pdid == pdid && tlb[i].asid == asid && tlb[i].vpn == vpn ?
-				tlb + i : nullptr;
+			size_t set = vpn & set_mask;
+			tlb_entry_t *ent = &tlb[set * num_ways];
+			for (size_t way = 0; way < num_ways; way++, ent++) {
+				if (ent->vpn == vpn && ent->asid == asid && ent->pdid == pdid && valid(*ent)) {
+					plru_touch(plru[set], way, num_ways);
+					hits++;
+					return ent;
+				}
+			}
+			for (size_t i = 0; i < superpage_size; i++) {
+				ent = stlb + i;
+				if (ent->ptel == 0 || ent->asid != asid || ent->pdid != pdid) continue;
+				if (!covers(*ent, vpn) || !valid(*ent)) continue;
+				plru_touch(stlb_plru, i, superpage_size);
+				hits++;
+				return insert_page(pdid, asid, vpn, ent->ptel, ent->pteb, ent->ppn, ent->uva);
+			}
+			misses++;
+			return nullptr;
 		}
 
 		// insert TLB entry for the given PDID + ASID + X:12[VA] + 11:0[PTE.bits] <- PPN]
 		tlb_entry_t* insert(UX pdid, UX asid, UX va, UX ptel, UX pteb, UX ppn, addr_t uva)
 		{
-			UX vpn = va >> page_shift;
-			size_t i = vpn & mask;
-			// we are implicitly evicting an entry by overwriting it
-			tlb[i] = tlb_entry_t(pdid, asid, vpn, ptel, pteb, uva, ppn);
-			return &tlb[i];
+			return insert_page(pdid, asid, va >> page_shift, ptel, pteb, ppn, uva);
+		}
+
+		// insert superpage TLB entry covering the PTE level (1 = megapage, 2 = gigapage, ...)
+		tlb_entry_t* insert_superpage(UX pdid, UX asid, UX va, UX ptel, UX pteb, UX ppn, addr_t uva)
+		{
+			size_t i = 0;
+			while (i < superpage_size && valid(stlb[i])) i++;
+			if (i == superpage_size) {
+				i = plru_victim(stlb_plru, superpage_size);
+				flush_copies(stlb[i]);
+				evictions++;
+			}
+			plru_touch(stlb_plru, i, superpage_size);
+			stlb[i] = tlb_entry_t(pdid, asid, va >> page_shift, ptel, pteb, uva, ppn);
+			stlb[i].gen = gen;
+			stlb[i].agen = asid_gen[asid & (asid_gen_size - 1)];
+			return insert_page(pdid, asid, va >> page_shift, ptel, pteb, ppn, uva);
+		}
+
+		tlb_entry_t* insert_page(UX pdid, UX asid, UX vpn, UX ptel, UX pteb, UX ppn, addr_t uva)
+		{
+			size_t set = vpn & set_mask, way = 0;
+			tlb_entry_t *ent = &tlb[set * num_ways];
+			while (way < num_ways && valid(ent[way])) way++;
+			if (way == num_ways) {
+				way = plru_victim(plru[set], num_ways);
+				evictions++;
+			}
+			plru_touch(plru[set], way, num_ways);
+			ent[way] = tlb_entry_t(pdid, asid, vpn, ptel, pteb, uva, ppn);
+			ent[way].gen = gen;
+			ent[way].agen = asid_gen[asid & (asid_gen_size - 1)];
+			return ent + way;
+		}
+
+		void print_stats(const char *name)
+		{
+			printf("%-9s:entries=%zu ways=%zu superpages=%d hits=%llu misses=%llu evictions=%llu flushes=%llu\n",
+				name, tlb.size(), num_ways, (int)superpage_size, hits, misses, evictions, flushes);
 		}
 	};
 
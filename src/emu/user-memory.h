@@ -15,9 +15,10 @@ namespace riscv {
 		addr_t uva;       /* segment user virtual address     (host) */
 		size_t size;      /* segment size */
 		uint32_t flags;   /* segment PMA flags */
+		bool direct;      /* segment is host memory accessed by pointer */
 
-		memory_segment(const char *name, UX mpa, addr_t uva, size_t size, UX flags) :
-			name(name), mpa(mpa), uva(uva), size(size), flags(flags) {}
+		memory_segment(const char *name, UX mpa, addr_t uva, size_t size, UX flags, bool direct = false) :
+			name(name), mpa(mpa), uva(uva), size(size), flags(flags), direct(direct) {}
 
 		virtual ~memory_segment() {}
 
@@ -61,19 +62,23 @@ namespace riscv {
 			printf("mmio     :0x%04llx <- invalid\n", addr_t(va));
 		}
 
+		/* direct segments are dereferenced inline, others use virtual dispatch */
+
 		template <typename T>
-		constexpr void load(UX va, T &val)
+		inline void load(UX va, T &val)
 		{
-			if (sizeof(T) == 1) load_8(va, *(u8*)&val);
+			if (likely(direct)) val = *static_cast<T*>((void*)(addr_t)va);
+			else if (sizeof(T) == 1) load_8(va, *(u8*)&val);
 			else if (sizeof(T) == 2) load_16(va, *(u16*)&val);
 			else if (sizeof(T) == 4) load_32(va, *(u32*)&val);
 			else if (sizeof(T) == 8) load_64(va, *(u64*)&val);
 		}
 
 		template <typename T>
-		constexpr void store(UX va, T val)
+		inline void store(UX va, T val)
 		{
-			if (sizeof(T) == 1) store_8(va, val);
+			if (likely(direct)) *static_cast<T*>((void*)(addr_t)va) = val;
+			else if (sizeof(T) == 1) store_8(va, val);
 			else if (sizeof(T) == 2) store_16(va, val);
 			else if (sizeof(T) == 4) store_32(va, val);
 			else if (sizeof(T) == 8) store_64(va, val);
@@ -86,7 +91,7 @@ namespace riscv {
 	struct mmap_memory_segment : memory_segment<UX>
 	{
 		mmap_memory_segment(const char*name, UX mpa, addr_t uva, size_t size, UX flags) :
-			memory_segment<UX>(name, mpa, uva, size, flags) {}
+			memory_segment<UX>(name, mpa, uva, size, flags, /*direct*/true) {}
 
 		~mmap_memory_segment()
 		{
@@ -105,6 +110,65 @@ namespace riscv {
 	};
 
 
+	/*  memory range is a non-overlapping piece of a segment in the lookup index,
+	    last is inclusive so that a segment ending at the top of the address
+	    space does not wrap */
+	template <typename UX>
+	struct memory_range
+	{
+		UX first;                 /* first machine physical address */
+		UX last;                  /* last machine physical address */
+		memory_segment<UX> *seg;  /* segment covering the range */
+	};
+
+	/*  memory reservations is the LR/SC reservation set shared by all harts
+	    attached to a memory. reservations are tracked per 8 byte granule of
+	    machine physical address hashed into a table. each slot holds the
+	    number of harts with a reservation in the slot and a sequence that
+	    stores bump while the slot is held. SC succeeds if the sequence
+	    sampled by LR is unchanged and a compare and swap against the value
+	    read by LR succeeds, so stores by other harts break reservations */
+	struct memory_reservations
+	{
+		enum : size_t { num_slots = 1024 };
+
+		std::atomic<u32> held[num_slots];
+		std::atomic<u32> seq[num_slots];
+
+		memory_reservations() : held(), seq() {}
+
+		static size_t slot(addr_t mpa) { return (mpa >> 3) & (num_slots - 1); }
+
+		/* acquire a reservation, returns the sequence for the granule */
+		u32 acquire(addr_t mpa)
+		{
+			size_t i = slot(mpa);
+			held[i].fetch_add(1);
+			return seq[i].load();
+		}
+
+		/* release a reservation */
+		void release(addr_t mpa)
+		{
+			held[slot(mpa)].fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		/* check a reservation sequence is current */
+		bool valid(addr_t mpa, u32 s)
+		{
+			return seq[slot(mpa)].load() == s;
+		}
+
+		/* break reservations on a granule after a store */
+		void store(addr_t mpa)
+		{
+			size_t i = slot(mpa);
+			if (unlikely(held[i].load(std::memory_order_relaxed))) {
+				seq[i].fetch_add(1, std::memory_order_release);
+			}
+		}
+	};
+
 	/*  user_memory device contains mappings for mulitple segments of emulated
 	    physical address space to user virtual address space */
 	template <typename UX>
@@ -113,9 +177,12 @@ namespace riscv {
 		typedef std::shared_ptr<memory_segment<UX>> memory_segment_type;
 
 		std::vector<memory_segment_type> segments;
+		std::vector<memory_range<UX>> ranges;   /* sorted lookup index */
+		memory_range<UX> last_range;            /* last hit */
+		memory_reservations resv;               /* LR/SC reservation set */
 		bool log;
 
-		user_memory() : log(false) {}
+		user_memory() : last_range{1, 0, nullptr}, log(false) {}
 		~user_memory() { clear_segments(); }
 
 		/* print memory */
@@ -144,6 +211,7 @@ namespace riscv {
 		void add_segment(memory_segment_type seg)
 		{
 			segments.push_back(seg);
+			rebuild_index();
 			if (log) {
 				print_memory_segment(seg);
 			}
@@ -154,35 +222,116 @@ namespace riscv {
 			add_segment(std::make_shared<mmap_memory_segment<UX>>("ELF", mpa, uva, size, flags));
 		}
 
-		/* mmap new main memory segment using fixed user physical address and size */
+		/* mmap new main memory segment using fixed user physical address and size,
+		   pages are allocated by the host on first touch */
 		void add_ram(UX mpa, size_t size)
+		{
+			add_anon("RAM", mpa, size, pma_type_main | pma_prot_read | pma_prot_write | pma_prot_execute);
+		}
+
+		/* mmap new zeroed segment with the given name and PMA flags */
+		void add_anon(const char *name, UX mpa, size_t size, UX flags)
 		{
 			void *addr = mmap(nullptr, size,
-				PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+				PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
 			if (addr == MAP_FAILED) {
 				panic("memory: error: mmap: %s", strerror(errno));
 			}
-			add_segment(std::make_shared<mmap_memory_segment<UX>>("RAM", mpa, uintptr_t(addr), size,
-				pma_type_main | pma_prot_read | pma_prot_write | pma_prot_execute));
+			add_segment(std::make_shared<mmap_memory_segment<UX>>(name, mpa, uintptr_t(addr), size, flags));
+		}
+
+		/* map a file copy-on-write over main memory at a page aligned
+		   physical address, returns the file size */
+		size_t map_file(UX mpa, const char *filename)
+		{
+			int fd = open(filename, O_RDONLY);
+			if (fd < 0) {
+				panic("memory: error: open: %s: %s", filename, strerror(errno));
+			}
+			struct stat statbuf;
+			if (fstat(fd, &statbuf) < 0) {
+				panic("memory: error: fstat: %s: %s", filename, strerror(errno));
+			}
+			size_t size = statbuf.st_size;
+			map_fd(mpa, fd, 0, size);
+			close(fd);
+			return size;
+		}
+
+		/* map part of an open file copy-on-write over main memory */
+		void map_fd(UX mpa, int fd, off_t offset, size_t size)
+		{
+			memory_segment<UX> *seg = nullptr;
+			addr_t uva = mpa_to_uva(seg, mpa);
+			if (!uva || !seg->direct || !(seg->flags & pma_type_main) || (uva & (page_size - 1))) {
+				panic("memory: error: map_fd: 0x%llx is not page aligned RAM", addr_t(mpa));
+			}
+			if (size > seg->size - (mpa - seg->mpa)) {
+				panic("memory: error: map_fd: 0x%llx size 0x%zx does not fit in RAM", addr_t(mpa), size);
+			}
+			if (size > 0 && mmap((void*)uva, round_up(size, page_size), PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_FIXED, fd, offset) == MAP_FAILED)
+			{
+				panic("memory: error: mmap: %s", strerror(errno));
+			}
 		}
 
 		/* Unmap memory segments */
 		void clear_segments()
 		{
 			segments.clear();
+			rebuild_index();
 		}
 
-		/* convert machine physical address to user virtual address */
-		addr_t mpa_to_uva(memory_segment<UX>* &out_seg, UX mpa)
+		/* rebuild the sorted range index, earlier segments shadow later ones */
+		void rebuild_index()
 		{
+			ranges.clear();
+			last_range = memory_range<UX>{1, 0, nullptr};
 			for (auto &seg : segments) {
-				if (mpa >= seg->mpa && /* note the upper limit may wrap to 0 */
-					((mpa < seg->mpa + seg->size) || (seg->mpa + seg->size == 0))) {
-					out_seg = seg.get();
-					return seg->uva + (mpa - seg->mpa);
+				if (seg->size == 0) continue;
+				std::vector<memory_range<UX>> pieces = {
+					{ seg->mpa, UX(seg->mpa + seg->size - 1), seg.get() }
+				};
+				for (auto &r : ranges) {
+					std::vector<memory_range<UX>> rest;
+					for (auto &p : pieces) {
+						if (p.last < r.first || p.first > r.last) {
+							rest.push_back(p);
+							continue;
+						}
+						if (p.first < r.first) rest.push_back({ p.first, UX(r.first - 1), p.seg });
+						if (p.last > r.last) rest.push_back({ UX(r.last + 1), p.last, p.seg });
+					}
+					pieces.swap(rest);
 				}
+				ranges.insert(ranges.end(), pieces.begin(), pieces.end());
+			}
+			std::sort(ranges.begin(), ranges.end(),
+				[](const memory_range<UX> &a, const memory_range<UX> &b) { return a.first < b.first; });
+		}
+
+		/* convert machine physical address to user virtual address */
+		addr_t mpa_to_uva(memory_segment<UX>* &out_seg, UX mpa)
+		{
+			return mpa_to_uva(out_seg, mpa, last_range);
+		}
+
+		/* convert using a caller owned last hit (one per hart) */
+		addr_t mpa_to_uva(memory_segment<UX>* &out_seg, UX mpa, memory_range<UX> &last_range)
+		{
+			if (likely(mpa >= last_range.first && mpa <= last_range.last)) {
+				out_seg = last_range.seg;
+				return out_seg->uva + (mpa - out_seg->mpa);
+			}
+			auto ri = std::upper_bound(ranges.begin(), ranges.end(), mpa,
+				[](UX mpa, const memory_range<UX> &r) { return mpa < r.first; });
+			if (ri == ranges.begin() || mpa > (--ri)->last) {
+				return 0;
 			}
-			return 0;
+			last_range = *ri;
+			out_seg = ri->seg;
+			return out_seg->uva + (mpa - out_seg->mpa);
 		}
 
 	};
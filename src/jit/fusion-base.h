@@ -9,15 +9,79 @@ namespace riscv {
 
 	using namespace asmjit;
 
-	#define proc_offset(member) offsetof(typename P::processor_type, member)
+	/* processor_priv is not standard layout so offsetof is not used */
+	#define proc_offset(member) (uintptr_t(&reinterpret_cast<typename P::processor_type*>(16)->member) - 16)
 
 	template <typename P>
 	struct fusion_base
 	{
+		/*
+		 * guest integer registers are mapped to the host registers below
+		 * by alloc_regs, hottest first. rdx comes last as it is clobbered
+		 * by multiply and divide. rax and rcx are scratch registers. the
+		 * default mapping pins ra, sp, t0, t1 and a0-a7.
+		 */
+		enum { host_reg_count = 12 };
+
 		X86Assembler as;
+		s8 reg_map[32];               /* guest register to host register */
+		int rdx_reg;                  /* guest register in rdx */
+		u32 reg_load;                 /* registers loaded on entry */
+		u32 reg_store;                /* registers stored on exit */
+
+		fusion_base() { default_regs(); }
+		fusion_base(CodeHolder &code) : as(&code) { default_regs(); }
+
+		static const int* host_regs()
+		{
+			static const int regs[host_reg_count] = {
+				3, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 2
+			};
+			return regs;
+		}
+
+		void default_regs()
+		{
+			static const int pinned[host_reg_count] = {
+				rv_ireg_sp, rv_ireg_t0, rv_ireg_t1, rv_ireg_a0,
+				rv_ireg_a1, rv_ireg_a2, rv_ireg_a3, rv_ireg_a4,
+				rv_ireg_a5, rv_ireg_a6, rv_ireg_a7, rv_ireg_ra
+			};
+			memset(reg_map, -1, sizeof(reg_map));
+			reg_map[rv_ireg_zero] = 0;
+			reg_load = reg_store = 0;
+			for (int i = 0; i < host_reg_count; i++) {
+				reg_map[pinned[i]] = host_regs()[i];
+				reg_load |= (1U << pinned[i]);
+				reg_store |= (1U << pinned[i]);
+			}
+			rdx_reg = rv_ireg_ra;
+		}
 
-		fusion_base() {}
-		fusion_base(CodeHolder &code) : as(&code) {}
+		/*
+		 * assign host registers to the most used guest registers. loaded
+		 * is the set of registers that may be read before being written
+		 * and stored is the set of registers written in the trace.
+		 */
+		void alloc_regs(const u32 uses[32], u32 loaded, u32 stored)
+		{
+			memset(reg_map, -1, sizeof(reg_map));
+			reg_map[rv_ireg_zero] = 0;
+			reg_load = reg_store = 0;
+			rdx_reg = -1;
+			for (int i = 0; i < host_reg_count; i++) {
+				int best = 0;
+				for (int reg = 1; reg < 32; reg++) {
+					if (reg_map[reg] < 0 && uses[reg] > uses[best]) best = reg;
+				}
+				if (best == 0) break;
+				int host = host_regs()[i];
+				reg_map[best] = host;
+				if (host == 2) rdx_reg = best;
+				if (loaded & (1U << best)) reg_load |= (1U << best);
+				if (stored & (1U << best)) reg_store |= (1U << best);
+			}
+		}
 
 		const char* x86_reg_str_b(int rdx)
 		{
@@ -111,24 +175,9 @@ namespace riscv {
 			return "";
 		}
 
-		static int x86_reg(int rd)
-		{
-			switch (rd) {
-				case rv_ireg_zero: return 0;
-				case rv_ireg_ra: return 2;  /* rdx */
-				case rv_ireg_sp: return 3;  /* rbx */
-				case rv_ireg_t0: return 6;  /* rsi */
-				case rv_ireg_t1: return 7;  /* rdi */
-				case rv_ireg_a0: return 8;  /* r8  */
-				case rv_ireg_a1: return 9;  /* r9  */
-				case rv_ireg_a2: return 10; /* r10 */
-				case rv_ireg_a3: return 11; /* r11 */
-				case rv_ireg_a4: return 12; /* r12 */
-				case rv_ireg_a5: return 13; /* r13 */
-				case rv_ireg_a6: return 14; /* r14 */
-				case rv_ireg_a7: return 15; /* r15 */
-			}
-			return -1;
+		int x86_reg(int rd)
+		{
+			return reg_map[rd];
 		}
 
 		const char* rbp_reg_str_d(int reg)
@@ -155,7 +204,31 @@ namespace riscv {
 			return x86::qword_ptr(x86::rbp, proc_offset(ireg) + reg * (P::xlen >> 3));
 		}
 
-		void emit_prolog()
+		const char* rbp_freg_str_d(int reg)
+		{
+			static char buf[32];
+			snprintf(buf, sizeof(buf), "dword ptr [rbp + %lu]", proc_offset(freg) + reg * sizeof(typename P::freg_t));
+			return buf;
+		}
+
+		const X86Mem rbp_freg_d(int reg)
+		{
+			return x86::dword_ptr(x86::rbp, proc_offset(freg) + reg * sizeof(typename P::freg_t));
+		}
+
+		const char* rbp_freg_str_q(int reg)
+		{
+			static char buf[32];
+			snprintf(buf, sizeof(buf), "qword ptr [rbp + %lu]", proc_offset(freg) + reg * sizeof(typename P::freg_t));
+			return buf;
+		}
+
+		const X86Mem rbp_freg_q(int reg)
+		{
+			return x86::qword_ptr(x86::rbp, proc_offset(freg) + reg * sizeof(typename P::freg_t));
+		}
+
+		void emit_push_frame()
 		{
 			as.push(x86::rbp);
 			as.push(x86::rbx);
@@ -164,34 +237,10 @@ namespace riscv {
 			as.push(x86::r14);
 			as.push(x86::r15);
 			as.mov(x86::rbp, x86::rdi);
-			as.mov(x86::rdx, rbp_reg_q(rv_ireg_ra));
-			as.mov(x86::rbx, rbp_reg_q(rv_ireg_sp));
-			as.mov(x86::rsi, rbp_reg_q(rv_ireg_t0));
-			as.mov(x86::rdi, rbp_reg_q(rv_ireg_t1));
-			as.mov(x86::r8,  rbp_reg_q(rv_ireg_a0));
-			as.mov(x86::r9,  rbp_reg_q(rv_ireg_a1));
-			as.mov(x86::r10, rbp_reg_q(rv_ireg_a2));
-			as.mov(x86::r11, rbp_reg_q(rv_ireg_a3));
-			as.mov(x86::r12, rbp_reg_q(rv_ireg_a4));
-			as.mov(x86::r13, rbp_reg_q(rv_ireg_a5));
-			as.mov(x86::r14, rbp_reg_q(rv_ireg_a6));
-			as.mov(x86::r15, rbp_reg_q(rv_ireg_a7));
 		}
 
-		void emit_epilog()
+		void emit_pop_frame()
 		{
-			as.mov(rbp_reg_q(rv_ireg_ra), x86::rdx);
-			as.mov(rbp_reg_q(rv_ireg_sp), x86::rbx);
-			as.mov(rbp_reg_q(rv_ireg_t0), x86::rsi);
-			as.mov(rbp_reg_q(rv_ireg_t1), x86::rdi);
-			as.mov(rbp_reg_q(rv_ireg_a0), x86::r8);
-			as.mov(rbp_reg_q(rv_ireg_a1), x86::r9);
-			as.mov(rbp_reg_q(rv_ireg_a2), x86::r10);
-			as.mov(rbp_reg_q(rv_ireg_a3), x86::r11);
-			as.mov(rbp_reg_q(rv_ireg_a4), x86::r12);
-			as.mov(rbp_reg_q(rv_ireg_a5), x86::r13);
-			as.mov(rbp_reg_q(rv_ireg_a6), x86::r14);
-			as.mov(rbp_reg_q(rv_ireg_a7), x86::r15);
 			as.pop(x86::r15);
 			as.pop(x86::r14);
 			as.pop(x86::r13);
@@ -200,6 +249,55 @@ namespace riscv {
 			as.pop(x86::rbp);
 			as.ret();
 		}
+
+		void emit_load_regs()
+		{
+			for (int reg = 1; reg < 32; reg++) {
+				if (reg_load & (1U << reg)) {
+					as.mov(x86::gpq(reg_map[reg]), rbp_reg_q(reg));
+				}
+			}
+		}
+
+		void emit_store_regs()
+		{
+			for (int reg = 1; reg < 32; reg++) {
+				if (reg_store & (1U << reg)) {
+					as.mov(rbp_reg_q(reg), x86::gpq(reg_map[reg]));
+				}
+			}
+		}
+
+		/* every mapped register, for reloading after a call */
+		u32 reg_mapped()
+		{
+			u32 regs = 0;
+			for (int reg = 1; reg < 32; reg++) {
+				if (reg_map[reg] > 0) regs |= (1U << reg);
+			}
+			return regs;
+		}
+
+		void emit_reload_regs()
+		{
+			for (int reg = 1; reg < 32; reg++) {
+				if (reg_map[reg] > 0) {
+					as.mov(x86::gpq(reg_map[reg]), rbp_reg_q(reg));
+				}
+			}
+		}
+
+		void emit_prolog()
+		{
+			emit_push_frame();
+			emit_load_regs();
+		}
+
+		void emit_epilog()
+		{
+			emit_store_regs();
+			emit_pop_frame();
+		}
 	};
 }
 
@@ -15,14 +15,68 @@ namespace riscv {
 		typedef typename P::decode_type decode_type;
 		typedef fusion_base<P> rv;
 
+		typedef bool (fusion_emitter<P>::*emit_fn)(decode_type &dec);
+
+		/*
+		 * traces are recorded first and emitted afterwards so that host
+		 * registers can be allocated for the guest registers the trace
+		 * uses. allocated registers that may be read before they are
+		 * written are loaded at entry and written registers are stored
+		 * on every exit.
+		 *
+		 * trace exits with a known target store registers and jump
+		 * indirectly through a slot in the trace, which initially points
+		 * at the trace return. the runloop patches slots to the entry of
+		 * the successor trace, which loads its own registers.
+		 *
+		 * with a soft MMU traces are keyed by the physical address of
+		 * their entry, so they are limited to one page and only exits
+		 * within the page are chained. such traces do not loop inside
+		 * and count retired instructions at each exit, so the runloop
+		 * regains control to service interrupts.
+		 *
+		 * audit builds of a trace are run once by the runloop's trace
+		 * audit. they do not loop inside, count retired instructions at
+		 * each exit and have no lookup stub, so the instructions they
+		 * retire can be matched against the interpreter.
+		 */
+		struct trace_exit
+		{
+			Label slot;
+			addr_t pc;
+		};
+
+		/*
+		 * jalr sites with a target other than the traced one probe an
+		 * inline cache of recently seen targets, each {pc, entry}, and
+		 * then the runloop's shared lookup stub, which refills the cache.
+		 * the initial pc of 1 never matches an aligned target.
+		 */
+		static const int jalr_cache_ways = 2;
+
+		static const bool mem_direct = P::mmu_type::jit_mem_direct;
+
 		P &proc;
 		Label term;
+		Label entry;
+		Label chain;
+		Label dispatch;
+		Label ret;
+		Label lookup;
+		std::vector<decode_type> trace;
+		std::map<addr_t,addr_t> jalr_targets;
+		std::vector<trace_exit> exits;
+		std::vector<Label> caches;
+		uintptr_t lookup_stub;
 		std::map<addr_t,Label> labels;
-		std::vector<addr_t> callstack;
 		addr_t term_pc;
+		addr_t trace_next_pc;
+		size_t emit_index;
+		bool audit;
 
 		fusion_emitter(P &proc, CodeHolder &code)
-			: fusion_base<P>(code), proc(proc), term_pc(0)
+			: fusion_base<P>(code), proc(proc), lookup_stub(0), term_pc(0),
+			trace_next_pc(0), emit_index(0), audit(false)
 		{}
 
 		void log_trace(const char* fmt, ...)
@@ -42,20 +96,261 @@ namespace riscv {
 			return false;
 		}
 
+		bool record(decode_type &dec)
+		{
+			if (!lookup_emit(dec.op)) return false;
+			for (auto &ent : trace) {
+				if (ent.pc == dec.pc) return false; /* trace complete */
+			}
+			if (!mem_direct) {
+				addr_t last = dec.pc + inst_length(dec.inst) - 1;
+				if ((last ^ dec.pc) >> page_shift) return false;
+				if (trace.size() > 0 && (dec.pc ^ trace[0].pc) >> page_shift) return false;
+			}
+			if (dec.op == rv_op_jalr) {
+				jalr_targets[dec.pc] = (proc.ireg[dec.rs1].r.xu.val + dec.imm) & ~1ULL;
+			}
+			trace.push_back(dec);
+			return true;
+		}
+
+		void alloc_regs()
+		{
+			u32 uses[32] = { 0 };
+			u32 loaded = 0, written = 0;
+			bool branched = false;
+			for (auto &dec : trace) {
+				u32 reads = 0, writes = 0;
+				switch (dec.op) {
+					case fusion_op_li:
+					case fusion_op_la:
+					case fusion_op_call:
+						writes = 1U << dec.rd;
+						break;
+					default:
+						for (const rv_operand_data *od = rv_inst_operand_data[dec.op];
+							od->type != rv_type_none; od++)
+						{
+							if (od->type != rv_type_ireg) continue;
+							switch (od->operand_name) {
+								case rv_operand_name_rd: writes |= 1U << dec.rd; break;
+								case rv_operand_name_rs1: reads |= 1U << dec.rs1; break;
+								case rv_operand_name_rs2: reads |= 1U << dec.rs2; break;
+								case rv_operand_name_rs3: reads |= 1U << dec.rs3; break;
+								default: break;
+							}
+						}
+						break;
+				}
+				for (int reg = 1; reg < 32; reg++) {
+					u32 bit = 1U << reg;
+					if (reads & bit) uses[reg]++;
+					if (writes & bit) uses[reg]++;
+				}
+				/* soft MMU accesses may leave the trace before writing rd */
+				if (!mem_direct && is_mem_op(dec.op)) branched = true;
+				/* registers read before written, or first written after a possible exit */
+				loaded |= reads & ~written;
+				if (branched) loaded |= writes & ~written;
+				written |= writes;
+				switch (dec.op) {
+					case rv_op_beq:
+					case rv_op_bne:
+					case rv_op_blt:
+					case rv_op_bge:
+					case rv_op_bltu:
+					case rv_op_bgeu:
+					case rv_op_jalr:
+						branched = true;
+						break;
+				}
+			}
+			rv::alloc_regs(uses, loaded & ~1U, written & ~1U);
+		}
+
+		static bool is_mem_op(int op)
+		{
+			switch (op) {
+				case rv_op_lb: case rv_op_lh: case rv_op_lw: case rv_op_ld:
+				case rv_op_lbu: case rv_op_lhu: case rv_op_lwu:
+				case rv_op_sb: case rv_op_sh: case rv_op_sw: case rv_op_sd:
+				case rv_op_flw: case rv_op_fld: case rv_op_fsw: case rv_op_fsd:
+					return true;
+			}
+			return false;
+		}
+
+		void emit_trace()
+		{
+			alloc_regs();
+			rv::emit_push_frame();
+			begin();
+			for (emit_index = 0; emit_index < trace.size(); emit_index++) {
+				if (!emit_fused(emit_index)) emit(trace[emit_index]);
+			}
+			emit_index = trace.size() - 1;
+			end();
+			emit_trace_data();
+		}
+
+		/* instruction pairs are fused by fusion_tracer */
+		virtual bool emit_fused(size_t index) { return false; }
+
 		void begin()
 		{
 			term = rv::as.newLabel();
+			entry = rv::as.newLabel();
+			chain = rv::as.newLabel();
+			dispatch = rv::as.newLabel();
+			ret = rv::as.newLabel();
+			lookup = rv::as.newLabel();
+			rv::as.bind(entry);
+			rv::emit_load_regs();
+			log_trace("\t\tentry:");
+			log_trace_regs("mov %s, %s", rv::reg_load, true);
+		}
+
+		void log_trace_regs(const char *fmt, u32 regs, bool load)
+		{
+			for (int reg = 1; reg < 32; reg++) {
+				if (!(regs & (1U << reg))) continue;
+				if (load) {
+					log_trace(("\t\t" + std::string(fmt)).c_str(),
+						rv::x86_reg_str_q(rv::x86_reg(reg)), rv::rbp_reg_str_q(reg));
+				} else {
+					log_trace(("\t\t" + std::string(fmt)).c_str(),
+						rv::rbp_reg_str_q(reg), rv::x86_reg_str_q(rv::x86_reg(reg)));
+				}
+			}
 		}
 
 		void end()
 		{
 			if (term_pc) {
-				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), Imm(term_pc));
 				log_trace("\t# 0x%016llx", term_pc);
-				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), term_pc);
+				emit_exit(term_pc);
 			}
-			log_trace("\t\tterm:");
+
+			/* chained exit: rcx = successor entry */
+			rv::as.bind(chain);
+			rv::emit_store_regs();
+			rv::as.dec(x86::dword_ptr(x86::rbp, proc_offset(chain_budget)));
+			rv::as.jz(ret);
+			rv::as.jmp(x86::rcx);
+			log_trace("\t\tchain:");
+			log_trace_regs("mov %s, %s", rv::reg_store, false);
+			log_trace("\t\tdec dword ptr [rbp + %lu]", proc_offset(chain_budget));
+			log_trace("\t\tjz ret");
+			log_trace("\t\tjmp rcx");
+
+			/* indirect exit: rax = target, rcx = inline cache */
+			if (caches.size() > 0) {
+				rv::as.bind(dispatch);
+				rv::emit_store_regs();
+				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), x86::rax);
+				rv::as.dec(x86::dword_ptr(x86::rbp, proc_offset(chain_budget)));
+				rv::as.jz(ret);
+				log_trace("\t\tdispatch:");
+				log_trace_regs("mov %s, %s", rv::reg_store, false);
+				log_trace("\t\tmov [rbp + %lu], rax", proc_offset(pc));
+				log_trace("\t\tdec dword ptr [rbp + %lu]", proc_offset(chain_budget));
+				log_trace("\t\tjz ret");
+				for (int i = 0; i < jalr_cache_ways; i++) {
+					Label l_next = rv::as.newLabel();
+					rv::as.cmp(x86::rax, x86::qword_ptr(x86::rcx, i * 16));
+					rv::as.jne(l_next);
+					rv::as.jmp(x86::qword_ptr(x86::rcx, i * 16 + 8));
+					rv::as.bind(l_next);
+					log_trace("\t\tcmp rax, qword ptr [rcx + %d]", i * 16);
+					log_trace("\t\tjne 1f");
+					log_trace("\t\tjmp qword ptr [rcx + %d]", i * 16 + 8);
+					log_trace("\t\t1:");
+				}
+				if (lookup_stub) {
+					rv::as.jmp(x86::qword_ptr(lookup));
+					log_trace("\t\tjmp qword ptr [lookup]");
+				} else {
+					rv::as.jmp(ret);
+					log_trace("\t\tjmp ret");
+				}
+			}
+
+			/* return to the runloop */
 			rv::as.bind(term);
+			rv::emit_store_regs();
+			rv::as.bind(ret);
+			rv::emit_pop_frame();
+			log_trace("\t\tterm:");
+			log_trace_regs("mov %s, %s", rv::reg_store, false);
+			log_trace("\t\tret:");
+			log_trace("\t\t...");
+		}
+
+		void emit_exit(addr_t exit_pc)
+		{
+			emit_retire(emit_index + 1);
+			emit_store_pc(exit_pc);
+
+			/* soft MMU traces only chain within their page */
+			if (!mem_direct && ((exit_pc ^ trace[0].pc) >> page_shift)) {
+				rv::as.jmp(term);
+				log_trace("\t\tjmp term");
+				return;
+			}
+
+			Label slot = rv::as.newLabel();
+			exits.push_back(trace_exit{slot, exit_pc});
+			rv::as.mov(x86::rcx, x86::qword_ptr(slot));
+			rv::as.jmp(chain);
+			log_trace("\t\tmov rcx, qword ptr [exit_%zu]", exits.size() - 1);
+			log_trace("\t\tjmp chain");
+		}
+
+		void emit_store_pc(addr_t addr)
+		{
+			if (s64(addr) == s64(s32(addr))) {
+				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), Imm(addr));
+				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), addr);
+			} else {
+				rv::as.mov(x86::rcx, Imm(addr));
+				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), x86::rcx);
+				log_trace("\t\tmov rcx, 0x%llx", addr);
+				log_trace("\t\tmov [rbp + %lu], rcx", proc_offset(pc));
+			}
+		}
+
+		/* soft MMU and audit traces count instructions retired before each exit */
+		void emit_retire(s64 count)
+		{
+			if ((mem_direct && !audit) || count == 0) return;
+			rv::as.add(x86::qword_ptr(x86::rbp, proc_offset(instret)), Imm(count));
+			rv::as.add(x86::qword_ptr(x86::rbp, proc_offset(cycle)), Imm(count));
+			log_trace("\t\tadd qword ptr [rbp + %lu], %lld", proc_offset(instret), count);
+			log_trace("\t\tadd qword ptr [rbp + %lu], %lld", proc_offset(cycle), count);
+		}
+
+		void emit_trace_data()
+		{
+			if (exits.size() == 0 && caches.size() == 0) return;
+			rv::as.align(kAlignData, 8);
+			for (size_t i = 0; i < exits.size(); i++) {
+				rv::as.bind(exits[i].slot);
+				rv::as.embedLabel(ret);
+				log_trace("\t\texit_%zu: .quad ret", i);
+			}
+			for (size_t i = 0; i < caches.size(); i++) {
+				const u64 way[2] = { 1, 0 };
+				rv::as.bind(caches[i]);
+				for (int j = 0; j < jalr_cache_ways; j++) {
+					rv::as.embed(way, sizeof(way));
+				}
+				log_trace("\t\tcache_%zu: .quad 1, 0 x %d", i, jalr_cache_ways);
+			}
+			if (caches.size() > 0 && lookup_stub) {
+				rv::as.bind(lookup);
+				rv::as.embed(&lookup_stub, sizeof(lookup_stub));
+				log_trace("\t\tlookup: .quad 0x%llx", (u64)lookup_stub);
+			}
 		}
 
 		void emit_sign_extend_32(decode_type &dec)
@@ -1883,6 +2178,1226 @@ namespace riscv {
 			return true;
 		}
 
+		/*
+		 * M extension
+		 *
+		 * operands are staged in rax and rcx. the one operand x86 multiply
+		 * and divide instructions clobber rdx which holds ra, so ra is
+		 * spilled to its register file slot around them and operands are
+		 * read from the slot while rdx is live with a partial result.
+		 * divide by zero and signed overflow are handled explicitly to
+		 * give RISC-V results instead of raising #DE.
+		 */
+
+		void emit_spill_rdx()
+		{
+			if (rv::rdx_reg < 0) return;
+			rv::as.mov(rv::rbp_reg_q(rv::rdx_reg), x86::rdx);
+			log_trace("\t\tmov %s, rdx", rv::rbp_reg_str_q(rv::rdx_reg));
+		}
+
+		void emit_restore_rdx()
+		{
+			if (rv::rdx_reg < 0) return;
+			rv::as.mov(x86::rdx, rv::rbp_reg_q(rv::rdx_reg));
+			log_trace("\t\tmov rdx, %s", rv::rbp_reg_str_q(rv::rdx_reg));
+		}
+
+		void emit_load_scratch_q(int x, int reg, bool spilled)
+		{
+			int regx = rv::x86_reg(reg);
+			if (reg == rv_ireg_zero) {
+				rv::as.xor_(x86::gpd(x), x86::gpd(x));
+				log_trace("\t\txor %s, %s", rv::x86_reg_str_d(x), rv::x86_reg_str_d(x));
+			} else if (regx > 0 && !(spilled && reg == rv::rdx_reg)) {
+				rv::as.mov(x86::gpq(x), x86::gpq(regx));
+				log_trace("\t\tmov %s, %s", rv::x86_reg_str_q(x), rv::x86_reg_str_q(regx));
+			} else {
+				rv::as.mov(x86::gpq(x), rv::rbp_reg_q(reg));
+				log_trace("\t\tmov %s, %s", rv::x86_reg_str_q(x), rv::rbp_reg_str_q(reg));
+			}
+		}
+
+		void emit_load_scratch_d(int x, int reg, bool spilled)
+		{
+			int regx = rv::x86_reg(reg);
+			if (reg == rv_ireg_zero) {
+				rv::as.xor_(x86::gpd(x), x86::gpd(x));
+				log_trace("\t\txor %s, %s", rv::x86_reg_str_d(x), rv::x86_reg_str_d(x));
+			} else if (regx > 0 && !(spilled && reg == rv::rdx_reg)) {
+				rv::as.mov(x86::gpd(x), x86::gpd(regx));
+				log_trace("\t\tmov %s, %s", rv::x86_reg_str_d(x), rv::x86_reg_str_d(regx));
+			} else {
+				rv::as.mov(x86::gpd(x), rv::rbp_reg_d(reg));
+				log_trace("\t\tmov %s, %s", rv::x86_reg_str_d(x), rv::rbp_reg_str_d(reg));
+			}
+		}
+
+		void emit_store_rax(decode_type &dec)
+		{
+			int rdx = rv::x86_reg(dec.rd);
+			if (rdx > 0) {
+				rv::as.mov(x86::gpq(rdx), x86::rax);
+				log_trace("\t\tmov %s, rax", rv::x86_reg_str_q(rdx));
+			} else {
+				rv::as.mov(rv::rbp_reg_q(dec.rd), x86::rax);
+				log_trace("\t\tmov %s, rax", rv::rbp_reg_str_q(dec.rd));
+			}
+		}
+
+		bool emit_mul(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			int rs2x = rv::x86_reg(dec.rs2);
+			if (dec.rd == rv_ireg_zero) {
+				// nop
+			}
+			else if (dec.rs1 == rv_ireg_zero || dec.rs2 == rv_ireg_zero) {
+				emit_zero_rd(dec);
+			}
+			else {
+				emit_load_scratch_q(0, dec.rs1, false);
+				if (rs2x > 0) {
+					rv::as.imul(x86::rax, x86::gpq(rs2x));
+					log_trace("\t\timul rax, %s", rv::x86_reg_str_q(rs2x));
+				} else {
+					rv::as.imul(x86::rax, rv::rbp_reg_q(dec.rs2));
+					log_trace("\t\timul rax, %s", rv::rbp_reg_str_q(dec.rs2));
+				}
+				emit_store_rax(dec);
+			}
+			return true;
+		}
+
+		bool emit_mulw(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			int rs2x = rv::x86_reg(dec.rs2);
+			if (dec.rd == rv_ireg_zero) {
+				// nop
+			}
+			else if (dec.rs1 == rv_ireg_zero || dec.rs2 == rv_ireg_zero) {
+				emit_zero_rd(dec);
+			}
+			else {
+				emit_load_scratch_d(0, dec.rs1, false);
+				if (rs2x > 0) {
+					rv::as.imul(x86::eax, x86::gpd(rs2x));
+					log_trace("\t\timul eax, %s", rv::x86_reg_str_d(rs2x));
+				} else {
+					rv::as.imul(x86::eax, rv::rbp_reg_d(dec.rs2));
+					log_trace("\t\timul eax, %s", rv::rbp_reg_str_d(dec.rs2));
+				}
+				rv::as.movsxd(x86::rax, x86::eax);
+				log_trace("\t\tmovsxd rax, eax");
+				emit_store_rax(dec);
+			}
+			return true;
+		}
+
+		bool emit_mulh_common(decode_type &dec, bool rs1_signed, bool rs2_signed)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (dec.rd == rv_ireg_zero) {
+				// nop
+			}
+			else if (dec.rs1 == rv_ireg_zero || dec.rs2 == rv_ireg_zero) {
+				emit_zero_rd(dec);
+			}
+			else {
+				emit_spill_rdx();
+				emit_load_scratch_q(0, dec.rs1, true);
+				emit_load_scratch_q(1, dec.rs2, true);
+				if (rs1_signed && rs2_signed) {
+					rv::as.imul(x86::rcx);
+					log_trace("\t\timul rcx");
+				} else {
+					rv::as.mul(x86::rcx);
+					log_trace("\t\tmul rcx");
+				}
+				if (rs1_signed && !rs2_signed) {
+					// high -= rs1 < 0 ? rs2 : 0
+					emit_load_scratch_q(0, dec.rs1, true);
+					rv::as.sar(x86::rax, Imm(63));
+					rv::as.and_(x86::rax, x86::rcx);
+					rv::as.sub(x86::rdx, x86::rax);
+					log_trace("\t\tsar rax, 63");
+					log_trace("\t\tand rax, rcx");
+					log_trace("\t\tsub rdx, rax");
+				}
+				rv::as.mov(x86::rax, x86::rdx);
+				log_trace("\t\tmov rax, rdx");
+				emit_restore_rdx();
+				emit_store_rax(dec);
+			}
+			return true;
+		}
+
+		bool emit_mulh(decode_type &dec)
+		{
+			return emit_mulh_common(dec, true, true);
+		}
+
+		bool emit_mulhsu(decode_type &dec)
+		{
+			return emit_mulh_common(dec, true, false);
+		}
+
+		bool emit_mulhu(decode_type &dec)
+		{
+			return emit_mulh_common(dec, false, false);
+		}
+
+		bool emit_div_common(decode_type &dec, bool is_signed, bool is_rem, bool is_word)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (dec.rd == rv_ireg_zero) {
+				return true; // nop
+			}
+
+			Label l_zero = rv::as.newLabel();
+			Label l_done = rv::as.newLabel();
+			emit_spill_rdx();
+			if (is_word) {
+				emit_load_scratch_d(0, dec.rs1, true);
+				emit_load_scratch_d(1, dec.rs2, true);
+				rv::as.test(x86::ecx, x86::ecx);
+				log_trace("\t\ttest ecx, ecx");
+			} else {
+				emit_load_scratch_q(0, dec.rs1, true);
+				emit_load_scratch_q(1, dec.rs2, true);
+				rv::as.test(x86::rcx, x86::rcx);
+				log_trace("\t\ttest rcx, rcx");
+			}
+			rv::as.je(l_zero);
+			log_trace("\t\tje 2f");
+
+			if (is_signed) {
+				// rs2 == -1 negates rs1 (wraps on overflow) or gives remainder 0
+				Label l_div = rv::as.newLabel();
+				if (is_word) {
+					rv::as.cmp(x86::ecx, Imm(-1));
+					log_trace("\t\tcmp ecx, -1");
+				} else {
+					rv::as.cmp(x86::rcx, Imm(-1));
+					log_trace("\t\tcmp rcx, -1");
+				}
+				rv::as.jne(l_div);
+				log_trace("\t\tjne 1f");
+				if (is_rem) {
+					rv::as.xor_(x86::eax, x86::eax);
+					log_trace("\t\txor eax, eax");
+				} else if (is_word) {
+					rv::as.neg(x86::eax);
+					log_trace("\t\tneg eax");
+				} else {
+					rv::as.neg(x86::rax);
+					log_trace("\t\tneg rax");
+				}
+				rv::as.jmp(l_done);
+				log_trace("\t\tjmp 3f");
+				rv::as.bind(l_div);
+				log_trace("\t\t1:");
+				if (is_word) {
+					rv::as.cdq();
+					rv::as.idiv(x86::ecx);
+					log_trace("\t\tcdq");
+					log_trace("\t\tidiv ecx");
+				} else {
+					rv::as.cqo();
+					rv::as.idiv(x86::rcx);
+					log_trace("\t\tcqo");
+					log_trace("\t\tidiv rcx");
+				}
+			} else {
+				rv::as.xor_(x86::edx, x86::edx);
+				log_trace("\t\txor edx, edx");
+				if (is_word) {
+					rv::as.div(x86::ecx);
+					log_trace("\t\tdiv ecx");
+				} else {
+					rv::as.div(x86::rcx);
+					log_trace("\t\tdiv rcx");
+				}
+			}
+			if (is_rem) {
+				rv::as.mov(x86::rax, x86::rdx);
+				log_trace("\t\tmov rax, rdx");
+			}
+			rv::as.jmp(l_done);
+			log_trace("\t\tjmp 3f");
+
+			// divide by zero gives all ones, remainder by zero gives rs1
+			rv::as.bind(l_zero);
+			log_trace("\t\t2:");
+			if (!is_rem) {
+				rv::as.mov(x86::rax, Imm(-1));
+				log_trace("\t\tmov rax, -1");
+			}
+			rv::as.bind(l_done);
+			log_trace("\t\t3:");
+			if (is_word) {
+				rv::as.movsxd(x86::rax, x86::eax);
+				log_trace("\t\tmovsxd rax, eax");
+			}
+			emit_restore_rdx();
+			emit_store_rax(dec);
+			return true;
+		}
+
+		bool emit_div(decode_type &dec)
+		{
+			return emit_div_common(dec, true, false, false);
+		}
+
+		bool emit_divu(decode_type &dec)
+		{
+			return emit_div_common(dec, false, false, false);
+		}
+
+		bool emit_rem(decode_type &dec)
+		{
+			return emit_div_common(dec, true, true, false);
+		}
+
+		bool emit_remu(decode_type &dec)
+		{
+			return emit_div_common(dec, false, true, false);
+		}
+
+		bool emit_divw(decode_type &dec)
+		{
+			return emit_div_common(dec, true, false, true);
+		}
+
+		bool emit_divuw(decode_type &dec)
+		{
+			return emit_div_common(dec, false, false, true);
+		}
+
+		bool emit_remw(decode_type &dec)
+		{
+			return emit_div_common(dec, true, true, true);
+		}
+
+		bool emit_remuw(decode_type &dec)
+		{
+			return emit_div_common(dec, false, true, true);
+		}
+
+		/*
+		 * F and D extensions
+		 *
+		 * floating point values stay in the register file and are staged
+		 * in xmm0 and xmm1 with SSE2 scalar instructions. rounding mode and
+		 * accrued exception flags are not handled per instruction: the host
+		 * MXCSR rounding mode tracks frm (it is set when fcsr or frm is
+		 * written) and the host sticky exception flags hold fflags until
+		 * fcsr or fflags is read, so a trace runs its floating point
+		 * instructions without touching MXCSR. fused multiply add uses FMA3
+		 * when the host supports it.
+		 */
+
+		static bool host_has_fma()
+		{
+			static bool fma = host_cpu::get_instance().caps["FMA"] != 0;
+			return fma;
+		}
+
+		int emit_mem_base(decode_type &dec)
+		{
+			int rs1x = rv::x86_reg(dec.rs1);
+			if (rs1x > 0) return rs1x;
+			rv::as.mov(x86::rax, rv::rbp_reg_q(dec.rs1));
+			log_trace("\t\tmov rax, %s", rv::rbp_reg_str_q(dec.rs1));
+			return 0;
+		}
+
+		/* offset of a processor_impl member from the processor in rbp */
+		size_t impl_offset(const void *member)
+		{
+			return uintptr_t(member) - uintptr_t(static_cast<typename P::processor_type*>(&proc));
+		}
+
+		void emit_mem_addr(decode_type &dec)
+		{
+			int rs1x = rv::x86_reg(dec.rs1);
+			if (rs1x > 0) {
+				rv::as.lea(x86::rax, x86::qword_ptr(x86::gpq(rs1x), dec.imm));
+				log_trace("\t\tlea rax, [%s + %lld]", rv::x86_reg_str_q(rs1x), dec.imm);
+			} else {
+				rv::as.mov(x86::rax, rv::rbp_reg_q(dec.rs1));
+				rv::as.lea(x86::rax, x86::qword_ptr(x86::rax, dec.imm));
+				log_trace("\t\tmov rax, %s", rv::rbp_reg_str_q(dec.rs1));
+				log_trace("\t\tlea rax, [rax + %lld]", dec.imm);
+			}
+		}
+
+		/*
+		 * stores probe the code page filter and leave the trace after a
+		 * store to a page instructions were fetched from, recording the
+		 * address and bumping the code generation so that the runloop
+		 * invalidates the traces built from that page.
+		 */
+		void emit_code_page_check(decode_type &dec)
+		{
+			size_t pages_offset = impl_offset(proc.code_pages);
+			size_t store_offset = impl_offset(&proc.code_store_addr);
+			size_t gen_offset = impl_offset(&proc.code_gen);
+			addr_t next_pc = dec.pc + inst_length(dec.inst);
+			Label l_clean = rv::as.newLabel();
+
+			emit_mem_addr(dec);
+			rv::as.shr(x86::rax, Imm(page_shift));
+			rv::as.mov(x86::rcx, x86::rax);
+			rv::as.shr(x86::rcx, Imm(6));
+			rv::as.and_(x86::ecx, Imm(P::code_page_words - 1));
+			rv::as.mov(x86::rcx, x86::qword_ptr(x86::rbp, x86::rcx, 3, pages_offset));
+			rv::as.bt(x86::rcx, x86::rax);
+			rv::as.jnc(l_clean);
+			log_trace("\t\tshr rax, %d", page_shift);
+			log_trace("\t\tmov rcx, rax");
+			log_trace("\t\tshr rcx, 6");
+			log_trace("\t\tand ecx, %d", P::code_page_words - 1);
+			log_trace("\t\tmov rcx, qword ptr [rbp + rcx * 8 + %lu]", pages_offset);
+			log_trace("\t\tbt rcx, rax");
+			log_trace("\t\tjnc 1f");
+
+			emit_mem_addr(dec);
+			rv::as.mov(x86::qword_ptr(x86::rbp, store_offset), x86::rax);
+			rv::as.inc(x86::qword_ptr(x86::rbp, gen_offset));
+			rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), Imm(next_pc));
+			rv::as.jmp(term);
+			rv::as.bind(l_clean);
+			log_trace("\t\tmov qword ptr [rbp + %lu], rax", store_offset);
+			log_trace("\t\tinc qword ptr [rbp + %lu]", gen_offset);
+			log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), next_pc);
+			log_trace("\t\tjmp term");
+			log_trace("\t\t1:");
+		}
+
+		/*
+		 * soft MMU loads and stores
+		 *
+		 * the guest address is looked up in the MMU's JIT TLB. xor with
+		 * the entry tag leaves the page and alignment bits clear on a hit,
+		 * then the tag is xored back and the entry addend gives the host
+		 * address. misses, misaligned accesses and MMIO call the MMU with
+		 * the registers stored and pc and instret at the instruction, so
+		 * a fault longjmps out of the trace with precise state, then all
+		 * mapped registers are reloaded. the store slow path returns
+		 * nonzero after a store to a code page, which leaves the trace.
+		 */
+
+		template <typename T>
+		static u64 mem_load_slow(typename P::processor_type *p, u64 va)
+		{
+			P &proc = *static_cast<P*>(p);
+			T val;
+			proc.mmu.template load<P,T>(proc, va, val);
+			proc.mmu.jit_fill(proc, va, false);
+			return u64(s64(val));
+		}
+
+		template <typename T>
+		static u64 mem_store_slow(typename P::processor_type *p, u64 va, u64 val)
+		{
+			P &proc = *static_cast<P*>(p);
+			u64 gen = proc.code_gen;
+			proc.mmu.template store<P,T>(proc, va, T(val));
+			if (proc.code_gen != gen) return 1;
+			proc.mmu.jit_fill(proc, va, true);
+			return 0;
+		}
+
+		static X86Mem host_ptr(size_t size)
+		{
+			switch (size) {
+				case 1: return x86::byte_ptr(x86::rax);
+				case 2: return x86::word_ptr(x86::rax);
+				case 4: return x86::dword_ptr(x86::rax);
+				default: return x86::qword_ptr(x86::rax);
+			}
+		}
+
+		static const char* host_ptr_str(size_t size)
+		{
+			switch (size) {
+				case 1: return "byte ptr [rax]";
+				case 2: return "word ptr [rax]";
+				case 4: return "dword ptr [rax]";
+				default: return "qword ptr [rax]";
+			}
+		}
+
+		X86Gp sized_reg(int x, size_t size)
+		{
+			switch (size) {
+				case 1: return x86::gpb_lo(x);
+				case 2: return x86::gpw(x);
+				case 4: return x86::gpd(x);
+				default: return x86::gpq(x);
+			}
+		}
+
+		const char* sized_reg_str(int x, size_t size)
+		{
+			switch (size) {
+				case 1: return rv::x86_reg_str_b(x);
+				case 2: return rv::x86_reg_str_w(x);
+				case 4: return rv::x86_reg_str_d(x);
+				default: return rv::x86_reg_str_q(x);
+			}
+		}
+
+		/* rax = host address, rcx = scaled JIT TLB index */
+		void emit_mem_lookup(decode_type &dec, size_t tlb_offset, size_t size, Label &l_slow)
+		{
+			s32 mask = s32(~u32(page_size - 1) | u32(size - 1));
+			emit_mem_addr(dec);
+			rv::as.mov(x86::rcx, x86::rax);
+			rv::as.shr(x86::rcx, Imm(page_shift - 4));
+			rv::as.and_(x86::ecx, Imm((P::mmu_type::jit_tlb_size - 1) << 4));
+			rv::as.xor_(x86::rax, x86::qword_ptr(x86::rbp, x86::rcx, 0, tlb_offset));
+			rv::as.test(x86::rax, Imm(mask));
+			rv::as.jnz(l_slow);
+			rv::as.xor_(x86::rax, x86::qword_ptr(x86::rbp, x86::rcx, 0, tlb_offset));
+			rv::as.add(x86::rax, x86::qword_ptr(x86::rbp, x86::rcx, 0, tlb_offset + 8));
+			log_trace("\t\tmov rcx, rax");
+			log_trace("\t\tshr rcx, %d", page_shift - 4);
+			log_trace("\t\tand ecx, %d", int((P::mmu_type::jit_tlb_size - 1) << 4));
+			log_trace("\t\txor rax, qword ptr [rbp + rcx + %lu]", tlb_offset);
+			log_trace("\t\ttest rax, %d", mask);
+			log_trace("\t\tjnz 2f");
+			log_trace("\t\txor rax, qword ptr [rbp + rcx + %lu]", tlb_offset);
+			log_trace("\t\tadd rax, qword ptr [rbp + rcx + %lu]", tlb_offset + 8);
+		}
+
+		/* call the MMU with rsi = guest address and rdx = store value */
+		void emit_mem_call(decode_type &dec, size_t tlb_offset, uintptr_t fn, bool store, bool fp)
+		{
+			rv::as.xor_(x86::rax, x86::qword_ptr(x86::rbp, x86::rcx, 0, tlb_offset));
+			rv::emit_store_regs();
+			log_trace("\t\t2:");
+			log_trace("\t\txor rax, qword ptr [rbp + rcx + %lu]", tlb_offset);
+			log_trace_regs("mov %s, %s", rv::reg_store, false);
+			emit_store_pc(dec.pc);
+			rv::as.mov(x86::rsi, x86::rax);
+			rv::as.mov(x86::rdi, x86::rbp);
+			log_trace("\t\tmov rsi, rax");
+			log_trace("\t\tmov rdi, rbp");
+			if (store && fp) {
+				rv::as.mov(x86::rdx, rv::rbp_freg_q(dec.rs2));
+				log_trace("\t\tmov rdx, %s", rv::rbp_freg_str_q(dec.rs2));
+			} else if (store && dec.rs2 == rv_ireg_zero) {
+				rv::as.xor_(x86::edx, x86::edx);
+				log_trace("\t\txor edx, edx");
+			} else if (store) {
+				rv::as.mov(x86::rdx, rv::rbp_reg_q(dec.rs2));
+				log_trace("\t\tmov rdx, %s", rv::rbp_reg_str_q(dec.rs2));
+			}
+			emit_retire(emit_index);
+			rv::as.sub(x86::rsp, Imm(8));
+			rv::as.mov(x86::rax, Imm(fn));
+			rv::as.call(x86::rax);
+			rv::as.add(x86::rsp, Imm(8));
+			log_trace("\t\tsub rsp, 8");
+			log_trace("\t\tmov rax, 0x%llx", (u64)fn);
+			log_trace("\t\tcall rax");
+			log_trace("\t\tadd rsp, 8");
+			emit_retire(-s64(emit_index));
+			rv::emit_reload_regs();
+			log_trace_regs("mov %s, %s", rv::reg_mapped(), true);
+		}
+
+		/* move a loaded value in rax to rd */
+		void emit_mem_result(decode_type &dec, size_t size, bool fp)
+		{
+			if (fp && size == 4) {
+				rv::as.mov(rv::rbp_freg_d(dec.rd), x86::eax);
+				log_trace("\t\tmov %s, eax", rv::rbp_freg_str_d(dec.rd));
+			} else if (fp) {
+				rv::as.mov(rv::rbp_freg_q(dec.rd), x86::rax);
+				log_trace("\t\tmov %s, rax", rv::rbp_freg_str_q(dec.rd));
+			} else if (dec.rd != rv_ireg_zero) {
+				emit_store_rax(dec);
+			}
+		}
+
+		template <typename T>
+		bool emit_mem_load(decode_type &dec, bool fp)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+
+			const size_t size = sizeof(T);
+			size_t tlb_offset = impl_offset(proc.mmu.jit_tlb(false));
+			int dst = fp || dec.rd == rv_ireg_zero ? 0 : std::max(rv::x86_reg(dec.rd), 0);
+			Label l_slow = rv::as.newLabel();
+			Label l_done = rv::as.newLabel();
+
+			/* fast path, loads to rd or rax */
+			emit_mem_lookup(dec, tlb_offset, size, l_slow);
+			if (size == 8) {
+				rv::as.mov(x86::gpq(dst), host_ptr(size));
+				log_trace("\t\tmov %s, %s", rv::x86_reg_str_q(dst), host_ptr_str(size));
+			} else if (size == 4 && std::is_signed<T>::value) {
+				rv::as.movsxd(x86::gpq(dst), host_ptr(size));
+				log_trace("\t\tmovsxd %s, %s", rv::x86_reg_str_q(dst), host_ptr_str(size));
+			} else if (size == 4) {
+				rv::as.mov(x86::gpd(dst), host_ptr(size));
+				log_trace("\t\tmov %s, %s", rv::x86_reg_str_d(dst), host_ptr_str(size));
+			} else if (std::is_signed<T>::value) {
+				rv::as.movsx(x86::gpq(dst), host_ptr(size));
+				log_trace("\t\tmovsx %s, %s", rv::x86_reg_str_q(dst), host_ptr_str(size));
+			} else {
+				rv::as.movzx(x86::gpd(dst), host_ptr(size));
+				log_trace("\t\tmovzx %s, %s", rv::x86_reg_str_d(dst), host_ptr_str(size));
+			}
+			if (dst == 0) emit_mem_result(dec, size, fp);
+			rv::as.jmp(l_done);
+			log_trace("\t\tjmp 1f");
+
+			/* slow path */
+			rv::as.bind(l_slow);
+			emit_mem_call(dec, tlb_offset, uintptr_t(&fusion_emitter<P>::template mem_load_slow<T>), false, fp);
+			emit_mem_result(dec, size, fp);
+			rv::as.bind(l_done);
+			log_trace("\t\t1:");
+			return true;
+		}
+
+		template <typename T>
+		bool emit_mem_store(decode_type &dec, bool fp)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+
+			const size_t size = sizeof(T);
+			size_t tlb_offset = impl_offset(proc.mmu.jit_tlb(true));
+			int rs2x = rv::x86_reg(dec.rs2);
+			Label l_slow = rv::as.newLabel();
+			Label l_done = rv::as.newLabel();
+
+			/* fast path */
+			emit_mem_lookup(dec, tlb_offset, size, l_slow);
+			if (fp) {
+				if (size == 4) {
+					rv::as.mov(x86::ecx, rv::rbp_freg_d(dec.rs2));
+					log_trace("\t\tmov ecx, %s", rv::rbp_freg_str_d(dec.rs2));
+				} else {
+					rv::as.mov(x86::rcx, rv::rbp_freg_q(dec.rs2));
+					log_trace("\t\tmov rcx, %s", rv::rbp_freg_str_q(dec.rs2));
+				}
+				rv::as.mov(host_ptr(size), sized_reg(1, size));
+				log_trace("\t\tmov %s, %s", host_ptr_str(size), sized_reg_str(1, size));
+			} else if (dec.rs2 == rv_ireg_zero) {
+				rv::as.mov(host_ptr(size), Imm(0));
+				log_trace("\t\tmov %s, 0", host_ptr_str(size));
+			} else if (rs2x > 0) {
+				rv::as.mov(host_ptr(size), sized_reg(rs2x, size));
+				log_trace("\t\tmov %s, %s", host_ptr_str(size), sized_reg_str(rs2x, size));
+			} else {
+				rv::as.mov(x86::rcx, rv::rbp_reg_q(dec.rs2));
+				rv::as.mov(host_ptr(size), sized_reg(1, size));
+				log_trace("\t\tmov rcx, %s", rv::rbp_reg_str_q(dec.rs2));
+				log_trace("\t\tmov %s, %s", host_ptr_str(size), sized_reg_str(1, size));
+			}
+			rv::as.jmp(l_done);
+			log_trace("\t\tjmp 1f");
+
+			/* slow path, leaving the trace if code was modified */
+			rv::as.bind(l_slow);
+			emit_mem_call(dec, tlb_offset, uintptr_t(&fusion_emitter<P>::template mem_store_slow<T>), true, fp);
+			rv::as.test(x86::eax, x86::eax);
+			rv::as.jz(l_done);
+			log_trace("\t\ttest eax, eax");
+			log_trace("\t\tjz 1f");
+			emit_retire(emit_index + 1);
+			emit_store_pc(term_pc);
+			rv::as.jmp(term);
+			rv::as.bind(l_done);
+			log_trace("\t\tjmp term");
+			log_trace("\t\t1:");
+			return true;
+		}
+
+		bool emit_flw(decode_type &dec)
+		{
+			if (!mem_direct) return emit_mem_load<u32>(dec, true);
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			int basex = emit_mem_base(dec);
+			rv::as.mov(x86::ecx, x86::dword_ptr(x86::gpq(basex), dec.imm));
+			rv::as.mov(rv::rbp_freg_d(dec.rd), x86::ecx);
+			log_trace("\t\tmov ecx, dword ptr [%s + %lld]", rv::x86_reg_str_q(basex), dec.imm);
+			log_trace("\t\tmov %s, ecx", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		bool emit_fld(decode_type &dec)
+		{
+			if (!mem_direct) return emit_mem_load<u64>(dec, true);
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			int basex = emit_mem_base(dec);
+			rv::as.mov(x86::rcx, x86::qword_ptr(x86::gpq(basex), dec.imm));
+			rv::as.mov(rv::rbp_freg_q(dec.rd), x86::rcx);
+			log_trace("\t\tmov rcx, qword ptr [%s + %lld]", rv::x86_reg_str_q(basex), dec.imm);
+			log_trace("\t\tmov %s, rcx", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		bool emit_fsw(decode_type &dec)
+		{
+			if (!mem_direct) return emit_mem_store<u32>(dec, true);
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			int basex = emit_mem_base(dec);
+			rv::as.mov(x86::ecx, rv::rbp_freg_d(dec.rs2));
+			rv::as.mov(x86::dword_ptr(x86::gpq(basex), dec.imm), x86::ecx);
+			log_trace("\t\tmov ecx, %s", rv::rbp_freg_str_d(dec.rs2));
+			log_trace("\t\tmov dword ptr [%s + %lld], ecx", rv::x86_reg_str_q(basex), dec.imm);
+			emit_code_page_check(dec);
+			return true;
+		}
+
+		bool emit_fsd(decode_type &dec)
+		{
+			if (!mem_direct) return emit_mem_store<u64>(dec, true);
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			int basex = emit_mem_base(dec);
+			rv::as.mov(x86::rcx, rv::rbp_freg_q(dec.rs2));
+			rv::as.mov(x86::qword_ptr(x86::gpq(basex), dec.imm), x86::rcx);
+			log_trace("\t\tmov rcx, %s", rv::rbp_freg_str_q(dec.rs2));
+			log_trace("\t\tmov qword ptr [%s + %lld], rcx", rv::x86_reg_str_q(basex), dec.imm);
+			emit_code_page_check(dec);
+			return true;
+		}
+
+		template <typename T>
+		bool emit_fop_s(decode_type &dec,
+			Error(T::*op)(const X86Xmm&, const X86Mem&), const char* opname)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.movss(x86::xmm0, rv::rbp_freg_d(dec.rs1));
+			(rv::as.*op)(x86::xmm0, rv::rbp_freg_d(dec.rs2));
+			rv::as.movss(rv::rbp_freg_d(dec.rd), x86::xmm0);
+			log_trace("\t\tmovss xmm0, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\t%s xmm0, %s", opname, rv::rbp_freg_str_d(dec.rs2));
+			log_trace("\t\tmovss %s, xmm0", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		template <typename T>
+		bool emit_fop_d(decode_type &dec,
+			Error(T::*op)(const X86Xmm&, const X86Mem&), const char* opname)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.movsd(x86::xmm0, rv::rbp_freg_q(dec.rs1));
+			(rv::as.*op)(x86::xmm0, rv::rbp_freg_q(dec.rs2));
+			rv::as.movsd(rv::rbp_freg_q(dec.rd), x86::xmm0);
+			log_trace("\t\tmovsd xmm0, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\t%s xmm0, %s", opname, rv::rbp_freg_str_q(dec.rs2));
+			log_trace("\t\tmovsd %s, xmm0", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		bool emit_fsqrt_s(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.sqrtss(x86::xmm0, rv::rbp_freg_d(dec.rs1));
+			rv::as.movss(rv::rbp_freg_d(dec.rd), x86::xmm0);
+			log_trace("\t\tsqrtss xmm0, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\tmovss %s, xmm0", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		bool emit_fsqrt_d(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.sqrtsd(x86::xmm0, rv::rbp_freg_q(dec.rs1));
+			rv::as.movsd(rv::rbp_freg_q(dec.rd), x86::xmm0);
+			log_trace("\t\tsqrtsd xmm0, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\tmovsd %s, xmm0", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		/* fmin and fmax return rs1 when rs2 is NaN, otherwise minss/maxss semantics */
+
+		template <typename T>
+		bool emit_fminmax_s(decode_type &dec,
+			Error(T::*op)(const X86Xmm&, const X86Xmm&), const char* opname)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			Label l = rv::as.newLabel();
+			rv::as.movss(x86::xmm0, rv::rbp_freg_d(dec.rs1));
+			rv::as.movss(x86::xmm1, rv::rbp_freg_d(dec.rs2));
+			rv::as.ucomiss(x86::xmm1, x86::xmm1);
+			rv::as.jp(l);
+			(rv::as.*op)(x86::xmm0, x86::xmm1);
+			rv::as.bind(l);
+			rv::as.movss(rv::rbp_freg_d(dec.rd), x86::xmm0);
+			log_trace("\t\tmovss xmm0, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\tmovss xmm1, %s", rv::rbp_freg_str_d(dec.rs2));
+			log_trace("\t\tucomiss xmm1, xmm1");
+			log_trace("\t\tjp 1f");
+			log_trace("\t\t%s xmm0, xmm1", opname);
+			log_trace("\t\t1:");
+			log_trace("\t\tmovss %s, xmm0", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		template <typename T>
+		bool emit_fminmax_d(decode_type &dec,
+			Error(T::*op)(const X86Xmm&, const X86Xmm&), const char* opname)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			Label l = rv::as.newLabel();
+			rv::as.movsd(x86::xmm0, rv::rbp_freg_q(dec.rs1));
+			rv::as.movsd(x86::xmm1, rv::rbp_freg_q(dec.rs2));
+			rv::as.ucomisd(x86::xmm1, x86::xmm1);
+			rv::as.jp(l);
+			(rv::as.*op)(x86::xmm0, x86::xmm1);
+			rv::as.bind(l);
+			rv::as.movsd(rv::rbp_freg_q(dec.rd), x86::xmm0);
+			log_trace("\t\tmovsd xmm0, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\tmovsd xmm1, %s", rv::rbp_freg_str_q(dec.rs2));
+			log_trace("\t\tucomisd xmm1, xmm1");
+			log_trace("\t\tjp 1f");
+			log_trace("\t\t%s xmm0, xmm1", opname);
+			log_trace("\t\t1:");
+			log_trace("\t\tmovsd %s, xmm0", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		/* sign injection on the raw bits: rd = (rs1 & ~sign) | f(rs2 & sign) */
+
+		bool emit_fsgnj_common_s(decode_type &dec, bool negate, bool xor_sign)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.mov(x86::eax, rv::rbp_freg_d(dec.rs1));
+			rv::as.mov(x86::ecx, rv::rbp_freg_d(dec.rs2));
+			log_trace("\t\tmov eax, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\tmov ecx, %s", rv::rbp_freg_str_d(dec.rs2));
+			if (negate) {
+				rv::as.not_(x86::ecx);
+				log_trace("\t\tnot ecx");
+			}
+			rv::as.and_(x86::ecx, Imm(0x80000000));
+			log_trace("\t\tand ecx, 0x80000000");
+			if (xor_sign) {
+				rv::as.xor_(x86::eax, x86::ecx);
+				log_trace("\t\txor eax, ecx");
+			} else {
+				rv::as.and_(x86::eax, Imm(0x7fffffff));
+				rv::as.or_(x86::eax, x86::ecx);
+				log_trace("\t\tand eax, 0x7fffffff");
+				log_trace("\t\tor eax, ecx");
+			}
+			rv::as.mov(rv::rbp_freg_d(dec.rd), x86::eax);
+			log_trace("\t\tmov %s, eax", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		bool emit_fsgnj_common_d(decode_type &dec, bool negate, bool xor_sign)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.mov(x86::rax, rv::rbp_freg_q(dec.rs1));
+			rv::as.mov(x86::rcx, rv::rbp_freg_q(dec.rs2));
+			log_trace("\t\tmov rax, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\tmov rcx, %s", rv::rbp_freg_str_q(dec.rs2));
+			if (negate) {
+				rv::as.not_(x86::rcx);
+				log_trace("\t\tnot rcx");
+			}
+			rv::as.shr(x86::rcx, Imm(63));
+			rv::as.shl(x86::rcx, Imm(63));
+			log_trace("\t\tshr rcx, 63");
+			log_trace("\t\tshl rcx, 63");
+			if (xor_sign) {
+				rv::as.xor_(x86::rax, x86::rcx);
+				log_trace("\t\txor rax, rcx");
+			} else {
+				rv::as.shl(x86::rax, Imm(1));
+				rv::as.shr(x86::rax, Imm(1));
+				rv::as.or_(x86::rax, x86::rcx);
+				log_trace("\t\tshl rax, 1");
+				log_trace("\t\tshr rax, 1");
+				log_trace("\t\tor rax, rcx");
+			}
+			rv::as.mov(rv::rbp_freg_q(dec.rd), x86::rax);
+			log_trace("\t\tmov %s, rax", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		/* fmv.x.{s,d} return the canonical NaN for any NaN (as the interpreter) */
+
+		bool emit_fmv_x_s(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (dec.rd == rv_ireg_zero) return true; // nop
+			Label l = rv::as.newLabel();
+			rv::as.movsxd(x86::rax, rv::rbp_freg_d(dec.rs1));
+			rv::as.movss(x86::xmm0, rv::rbp_freg_d(dec.rs1));
+			rv::as.ucomiss(x86::xmm0, x86::xmm0);
+			rv::as.jnp(l);
+			rv::as.mov(x86::eax, Imm(0x7fc00000));
+			rv::as.bind(l);
+			log_trace("\t\tmovsxd rax, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\tmovss xmm0, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\tucomiss xmm0, xmm0");
+			log_trace("\t\tjnp 1f");
+			log_trace("\t\tmov eax, 0x7fc00000");
+			log_trace("\t\t1:");
+			emit_store_rax(dec);
+			return true;
+		}
+
+		bool emit_fmv_x_d(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (dec.rd == rv_ireg_zero) return true; // nop
+			Label l = rv::as.newLabel();
+			rv::as.mov(x86::rax, rv::rbp_freg_q(dec.rs1));
+			rv::as.movsd(x86::xmm0, rv::rbp_freg_q(dec.rs1));
+			rv::as.ucomisd(x86::xmm0, x86::xmm0);
+			rv::as.jnp(l);
+			rv::as.mov(x86::rax, Imm(0x7ff8000000000000ULL));
+			rv::as.bind(l);
+			log_trace("\t\tmov rax, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\tmovsd xmm0, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\tucomisd xmm0, xmm0");
+			log_trace("\t\tjnp 1f");
+			log_trace("\t\tmov rax, 0x7ff8000000000000");
+			log_trace("\t\t1:");
+			emit_store_rax(dec);
+			return true;
+		}
+
+		bool emit_fmv_s_x(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			emit_load_scratch_d(0, dec.rs1, false);
+			rv::as.mov(rv::rbp_freg_d(dec.rd), x86::eax);
+			log_trace("\t\tmov %s, eax", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		bool emit_fmv_d_x(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			emit_load_scratch_q(0, dec.rs1, false);
+			rv::as.mov(rv::rbp_freg_q(dec.rd), x86::rax);
+			log_trace("\t\tmov %s, rax", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		/*
+		 * compares use the same instructions as the C comparisons in the
+		 * interpreter: feq is quiet (ucomis), flt and fle are signalling
+		 * (comis) with swapped operands so unordered compares give zero
+		 */
+
+		bool emit_fcmp(decode_type &dec, bool dbl, int cond)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (dec.rd == rv_ireg_zero) return true; // nop
+			int a = cond == 0 ? dec.rs1 : dec.rs2, b = cond == 0 ? dec.rs2 : dec.rs1;
+			if (dbl) {
+				rv::as.movsd(x86::xmm0, rv::rbp_freg_q(a));
+				log_trace("\t\tmovsd xmm0, %s", rv::rbp_freg_str_q(a));
+				if (cond == 0) rv::as.ucomisd(x86::xmm0, rv::rbp_freg_q(b));
+				else rv::as.comisd(x86::xmm0, rv::rbp_freg_q(b));
+				log_trace("\t\t%scomisd xmm0, %s", cond == 0 ? "u" : "", rv::rbp_freg_str_q(b));
+			} else {
+				rv::as.movss(x86::xmm0, rv::rbp_freg_d(a));
+				log_trace("\t\tmovss xmm0, %s", rv::rbp_freg_str_d(a));
+				if (cond == 0) rv::as.ucomiss(x86::xmm0, rv::rbp_freg_d(b));
+				else rv::as.comiss(x86::xmm0, rv::rbp_freg_d(b));
+				log_trace("\t\t%scomiss xmm0, %s", cond == 0 ? "u" : "", rv::rbp_freg_str_d(b));
+			}
+			switch (cond) {
+				case 0: /* feq */
+					rv::as.sete(x86::al);
+					rv::as.setnp(x86::cl);
+					rv::as.and_(x86::al, x86::cl);
+					log_trace("\t\tsete al");
+					log_trace("\t\tsetnp cl");
+					log_trace("\t\tand al, cl");
+					break;
+				case 1: /* flt */
+					rv::as.seta(x86::al);
+					log_trace("\t\tseta al");
+					break;
+				case 2: /* fle */
+					rv::as.setae(x86::al);
+					log_trace("\t\tsetae al");
+					break;
+			}
+			rv::as.movzx(x86::eax, x86::al);
+			log_trace("\t\tmovzx eax, al");
+			emit_store_rax(dec);
+			return true;
+		}
+
+		bool emit_feq_s(decode_type &dec) { return emit_fcmp(dec, false, 0); }
+		bool emit_flt_s(decode_type &dec) { return emit_fcmp(dec, false, 1); }
+		bool emit_fle_s(decode_type &dec) { return emit_fcmp(dec, false, 2); }
+		bool emit_feq_d(decode_type &dec) { return emit_fcmp(dec, true, 0); }
+		bool emit_flt_d(decode_type &dec) { return emit_fcmp(dec, true, 1); }
+		bool emit_fle_d(decode_type &dec) { return emit_fcmp(dec, true, 2); }
+
+		bool emit_fcvt_s_d(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.cvtsd2ss(x86::xmm0, rv::rbp_freg_q(dec.rs1));
+			rv::as.movss(rv::rbp_freg_d(dec.rd), x86::xmm0);
+			log_trace("\t\tcvtsd2ss xmm0, %s", rv::rbp_freg_str_q(dec.rs1));
+			log_trace("\t\tmovss %s, xmm0", rv::rbp_freg_str_d(dec.rd));
+			return true;
+		}
+
+		bool emit_fcvt_d_s(decode_type &dec)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			rv::as.cvtss2sd(x86::xmm0, rv::rbp_freg_d(dec.rs1));
+			rv::as.movsd(rv::rbp_freg_q(dec.rd), x86::xmm0);
+			log_trace("\t\tcvtss2sd xmm0, %s", rv::rbp_freg_str_d(dec.rs1));
+			log_trace("\t\tmovsd %s, xmm0", rv::rbp_freg_str_q(dec.rd));
+			return true;
+		}
+
+		/* integer to float: w sign extends, wu zero extends, l is signed 64-bit */
+
+		bool emit_fcvt_f_x(decode_type &dec, bool dbl, bool word, bool is_unsigned)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (word && !is_unsigned) {
+				emit_load_scratch_d(0, dec.rs1, false);
+				rv::as.movsxd(x86::rax, x86::eax);
+				log_trace("\t\tmovsxd rax, eax");
+			} else if (word) {
+				emit_load_scratch_d(0, dec.rs1, false);
+			} else {
+				emit_load_scratch_q(0, dec.rs1, false);
+			}
+			if (dbl) {
+				rv::as.cvtsi2sd(x86::xmm0, x86::rax);
+				rv::as.movsd(rv::rbp_freg_q(dec.rd), x86::xmm0);
+				log_trace("\t\tcvtsi2sd xmm0, rax");
+				log_trace("\t\tmovsd %s, xmm0", rv::rbp_freg_str_q(dec.rd));
+			} else {
+				rv::as.cvtsi2ss(x86::xmm0, x86::rax);
+				rv::as.movss(rv::rbp_freg_d(dec.rd), x86::xmm0);
+				log_trace("\t\tcvtsi2ss xmm0, rax");
+				log_trace("\t\tmovss %s, xmm0", rv::rbp_freg_str_d(dec.rd));
+			}
+			return true;
+		}
+
+		/*
+		 * float to signed integer truncates (as the interpreter) and maps
+		 * NaN and positive overflow, which x86 returns as the integer
+		 * indefinite value, to the largest signed integer
+		 */
+
+		bool emit_fcvt_x_f(decode_type &dec, bool dbl, bool word)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			if (dec.rd == rv_ireg_zero) return true; // nop
+			Label l_max = rv::as.newLabel(), l_done = rv::as.newLabel();
+			if (dbl) {
+				rv::as.movsd(x86::xmm0, rv::rbp_freg_q(dec.rs1));
+				log_trace("\t\tmovsd xmm0, %s", rv::rbp_freg_str_q(dec.rs1));
+			} else {
+				rv::as.movss(x86::xmm0, rv::rbp_freg_d(dec.rs1));
+				log_trace("\t\tmovss xmm0, %s", rv::rbp_freg_str_d(dec.rs1));
+			}
+			if (word) {
+				if (dbl) rv::as.cvttsd2si(x86::eax, x86::xmm0);
+				else rv::as.cvttss2si(x86::eax, x86::xmm0);
+				rv::as.cmp(x86::eax, Imm(std::numeric_limits<s32>::min()));
+				log_trace("\t\tcvtt%s2si eax, xmm0", dbl ? "sd" : "ss");
+				log_trace("\t\tcmp eax, 0x80000000");
+			} else {
+				if (dbl) rv::as.cvttsd2si(x86::rax, x86::xmm0);
+				else rv::as.cvttss2si(x86::rax, x86::xmm0);
+				rv::as.mov(x86::rcx, Imm(std::numeric_limits<s64>::min()));
+				rv::as.cmp(x86::rax, x86::rcx);
+				log_trace("\t\tcvtt%s2si rax, xmm0", dbl ? "sd" : "ss");
+				log_trace("\t\tmov rcx, 0x8000000000000000");
+				log_trace("\t\tcmp rax, rcx");
+			}
+			rv::as.jne(l_done);
+			rv::as.xorps(x86::xmm1, x86::xmm1);
+			if (dbl) rv::as.ucomisd(x86::xmm0, x86::xmm1);
+			else rv::as.ucomiss(x86::xmm0, x86::xmm1);
+			rv::as.jp(l_max);
+			rv::as.jbe(l_done);
+			rv::as.bind(l_max);
+			log_trace("\t\tjne 2f");
+			log_trace("\t\txorps xmm1, xmm1");
+			log_trace("\t\tucomi%s xmm0, xmm1", dbl ? "sd" : "ss");
+			log_trace("\t\tjp 1f");
+			log_trace("\t\tjbe 2f");
+			log_trace("\t\t1:");
+			if (word) {
+				rv::as.mov(x86::eax, Imm(std::numeric_limits<s32>::max()));
+				log_trace("\t\tmov eax, 0x7fffffff");
+			} else {
+				rv::as.mov(x86::rax, Imm(std::numeric_limits<s64>::max()));
+				log_trace("\t\tmov rax, 0x7fffffffffffffff");
+			}
+			rv::as.bind(l_done);
+			log_trace("\t\t2:");
+			if (word) {
+				rv::as.movsxd(x86::rax, x86::eax);
+				log_trace("\t\tmovsxd rax, eax");
+			}
+			emit_store_rax(dec);
+			return true;
+		}
+
+		/*
+		 * fused multiply add: FMA3 computes rs1 * rs2 +/- rs3 with a
+		 * single rounding, as the interpreter does with fma and fmaf.
+		 * negation flips the sign bit of the result in the register file.
+		 */
+
+		bool emit_fmadd_common(decode_type &dec, bool dbl, bool sub, bool neg)
+		{
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+			term_pc = dec.pc + inst_length(dec.inst);
+			const X86Mem rs1 = dbl ? rv::rbp_freg_q(dec.rs1) : rv::rbp_freg_d(dec.rs1);
+			const X86Mem rs2 = dbl ? rv::rbp_freg_q(dec.rs2) : rv::rbp_freg_d(dec.rs2);
+			const X86Mem rs3 = dbl ? rv::rbp_freg_q(dec.rs3) : rv::rbp_freg_d(dec.rs3);
+			const X86Mem rd = dbl ? rv::rbp_freg_q(dec.rd) : rv::rbp_freg_d(dec.rd);
+			const char *sfx = dbl ? "sd" : "ss";
+			auto freg_str = [&](int reg) {
+				return dbl ? rv::rbp_freg_str_q(reg) : rv::rbp_freg_str_d(reg);
+			};
+			if (host_has_fma()) {
+				/* xmm0 = +/-(xmm1 * rs2) +/- xmm0 */
+				const char *fop = neg ? (sub ? "vfnmadd231" : "vfnmsub231") : (sub ? "vfmsub231" : "vfmadd231");
+				if (dbl) {
+					rv::as.movsd(x86::xmm0, rs3);
+					rv::as.movsd(x86::xmm1, rs1);
+					if (neg) {
+						if (sub) rv::as.vfnmadd231sd(x86::xmm0, x86::xmm1, rs2);
+						else rv::as.vfnmsub231sd(x86::xmm0, x86::xmm1, rs2);
+					} else {
+						if (sub) rv::as.vfmsub231sd(x86::xmm0, x86::xmm1, rs2);
+						else rv::as.vfmadd231sd(x86::xmm0, x86::xmm1, rs2);
+					}
+					rv::as.movsd(rd, x86::xmm0);
+				} else {
+					rv::as.movss(x86::xmm0, rs3);
+					rv::as.movss(x86::xmm1, rs1);
+					if (neg) {
+						if (sub) rv::as.vfnmadd231ss(x86::xmm0, x86::xmm1, rs2);
+						else rv::as.vfnmsub231ss(x86::xmm0, x86::xmm1, rs2);
+					} else {
+						if (sub) rv::as.vfmsub231ss(x86::xmm0, x86::xmm1, rs2);
+						else rv::as.vfmadd231ss(x86::xmm0, x86::xmm1, rs2);
+					}
+					rv::as.movss(rd, x86::xmm0);
+				}
+				log_trace("\t\tmov%s xmm0, %s", sfx, freg_str(dec.rs3));
+				log_trace("\t\tmov%s xmm1, %s", sfx, freg_str(dec.rs1));
+				log_trace("\t\t%s%s xmm0, xmm1, %s", fop, sfx, freg_str(dec.rs2));
+				log_trace("\t\tmov%s %s, xmm0", sfx, freg_str(dec.rd));
+			} else {
+				/*
+				 * without FMA3 the product and sum are rounded separately,
+				 * so results can differ from the interpreter in the last
+				 * bit and inexact flags, and trace audits may report them
+				 */
+				if (dbl) {
+					rv::as.movsd(x86::xmm0, rs1);
+					rv::as.mulsd(x86::xmm0, rs2);
+					if (sub) rv::as.subsd(x86::xmm0, rs3);
+					else rv::as.addsd(x86::xmm0, rs3);
+					rv::as.movsd(rd, x86::xmm0);
+				} else {
+					rv::as.movss(x86::xmm0, rs1);
+					rv::as.mulss(x86::xmm0, rs2);
+					if (sub) rv::as.subss(x86::xmm0, rs3);
+					else rv::as.addss(x86::xmm0, rs3);
+					rv::as.movss(rd, x86::xmm0);
+				}
+				log_trace("\t\tmov%s xmm0, %s", sfx, freg_str(dec.rs1));
+				log_trace("\t\tmul%s xmm0, %s", sfx, freg_str(dec.rs2));
+				log_trace("\t\t%s%s xmm0, %s", sub ? "sub" : "add", sfx, freg_str(dec.rs3));
+				log_trace("\t\tmov%s %s, xmm0", sfx, freg_str(dec.rd));
+				if (neg) {
+					size_t sign_byte = proc_offset(freg) + dec.rd * sizeof(typename P::freg_t) + (dbl ? 7 : 3);
+					rv::as.xor_(x86::byte_ptr(x86::rbp, sign_byte), Imm(0x80));
+					log_trace("\t\txor byte ptr [rbp + %lu], 0x80", sign_byte);
+				}
+			}
+			return true;
+		}
+
+		bool emit_fadd_s(decode_type &dec) { return emit_fop_s(dec, &X86Assembler::addss, "addss"); }
+		bool emit_fsub_s(decode_type &dec) { return emit_fop_s(dec, &X86Assembler::subss, "subss"); }
+		bool emit_fmul_s(decode_type &dec) { return emit_fop_s(dec, &X86Assembler::mulss, "mulss"); }
+		bool emit_fdiv_s(decode_type &dec) { return emit_fop_s(dec, &X86Assembler::divss, "divss"); }
+		bool emit_fadd_d(decode_type &dec) { return emit_fop_d(dec, &X86Assembler::addsd, "addsd"); }
+		bool emit_fsub_d(decode_type &dec) { return emit_fop_d(dec, &X86Assembler::subsd, "subsd"); }
+		bool emit_fmul_d(decode_type &dec) { return emit_fop_d(dec, &X86Assembler::mulsd, "mulsd"); }
+		bool emit_fdiv_d(decode_type &dec) { return emit_fop_d(dec, &X86Assembler::divsd, "divsd"); }
+		bool emit_fmin_s(decode_type &dec) { return emit_fminmax_s(dec, &X86Assembler::minss, "minss"); }
+		bool emit_fmax_s(decode_type &dec) { return emit_fminmax_s(dec, &X86Assembler::maxss, "maxss"); }
+		bool emit_fmin_d(decode_type &dec) { return emit_fminmax_d(dec, &X86Assembler::minsd, "minsd"); }
+		bool emit_fmax_d(decode_type &dec) { return emit_fminmax_d(dec, &X86Assembler::maxsd, "maxsd"); }
+		bool emit_fsgnj_s(decode_type &dec) { return emit_fsgnj_common_s(dec, false, false); }
+		bool emit_fsgnjn_s(decode_type &dec) { return emit_fsgnj_common_s(dec, true, false); }
+		bool emit_fsgnjx_s(decode_type &dec) { return emit_fsgnj_common_s(dec, false, true); }
+		bool emit_fsgnj_d(decode_type &dec) { return emit_fsgnj_common_d(dec, false, false); }
+		bool emit_fsgnjn_d(decode_type &dec) { return emit_fsgnj_common_d(dec, true, false); }
+		bool emit_fsgnjx_d(decode_type &dec) { return emit_fsgnj_common_d(dec, false, true); }
+		bool emit_fcvt_s_w(decode_type &dec) { return emit_fcvt_f_x(dec, false, true, false); }
+		bool emit_fcvt_s_wu(decode_type &dec) { return emit_fcvt_f_x(dec, false, true, true); }
+		bool emit_fcvt_s_l(decode_type &dec) { return emit_fcvt_f_x(dec, false, false, false); }
+		bool emit_fcvt_d_w(decode_type &dec) { return emit_fcvt_f_x(dec, true, true, false); }
+		bool emit_fcvt_d_wu(decode_type &dec) { return emit_fcvt_f_x(dec, true, true, true); }
+		bool emit_fcvt_d_l(decode_type &dec) { return emit_fcvt_f_x(dec, true, false, false); }
+		bool emit_fcvt_w_s(decode_type &dec) { return emit_fcvt_x_f(dec, false, true); }
+		bool emit_fcvt_l_s(decode_type &dec) { return emit_fcvt_x_f(dec, false, false); }
+		bool emit_fcvt_w_d(decode_type &dec) { return emit_fcvt_x_f(dec, true, true); }
+		bool emit_fcvt_l_d(decode_type &dec) { return emit_fcvt_x_f(dec, true, false); }
+		bool emit_fmadd_s(decode_type &dec) { return emit_fmadd_common(dec, false, false, false); }
+		bool emit_fmsub_s(decode_type &dec) { return emit_fmadd_common(dec, false, true, false); }
+		bool emit_fnmadd_s(decode_type &dec) { return emit_fmadd_common(dec, false, false, true); }
+		bool emit_fnmsub_s(decode_type &dec) { return emit_fmadd_common(dec, false, true, true); }
+		bool emit_fmadd_d(decode_type &dec) { return emit_fmadd_common(dec, true, false, false); }
+		bool emit_fmsub_d(decode_type &dec) { return emit_fmadd_common(dec, true, true, false); }
+		bool emit_fnmadd_d(decode_type &dec) { return emit_fmadd_common(dec, true, false, true); }
+		bool emit_fnmsub_d(decode_type &dec) { return emit_fmadd_common(dec, true, true, true); }
+
 		void emit_cmp(decode_type &dec)
 		{
 			int rs1x = rv::x86_reg(dec.rs1), rs2x = rv::x86_reg(dec.rs2);
@@ -1933,13 +3448,22 @@ namespace riscv {
 			Error(T::*bf)(const Label&), const char* bfname,
 			Error(T::*ibf)(const Label&), const char* ibfname)
 		{
-			addr_t branch_pc = dec.pc + dec.imm;
-			addr_t cont_pc = dec.pc + inst_length(dec.inst);
-			auto branch_i = labels.find(branch_pc);
-			auto cont_i = labels.find(cont_pc);
-
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			emit_cmp(dec);
+			return emit_jcc(dec, cond, bf, bfname, ibf, ibfname);
+		}
+
+		/* branch on the flags of a preceding compare */
+		template <typename T>
+		bool emit_jcc(decode_type &dec, bool cond,
+			Error(T::*bf)(const Label&), const char* bfname,
+			Error(T::*ibf)(const Label&), const char* ibfname)
+		{
+			addr_t branch_pc = dec.pc + dec.imm;
+			addr_t cont_pc = dec.pc + inst_length(dec.inst);
+			bool link = mem_direct && !audit;
+			auto branch_i = link ? labels.find(branch_pc) : labels.end();
+			auto cont_i = link ? labels.find(cont_pc) : labels.end();
 			term_pc = 0;
 
 			if (branch_i != labels.end() && cont_i != labels.end()) {
@@ -1950,83 +3474,80 @@ namespace riscv {
 			}
 			else if (cond && branch_i != labels.end()) {
 				(rv::as.*bf)(branch_i->second);
-				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), (unsigned)cont_pc);
-				rv::as.jmp(term);
 				log_trace("\t\t%s 0x%016llx", bfname, branch_pc);
-				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), cont_pc);
-				log_trace("\t\tjmp term");
+				emit_exit(cont_pc);
 			}
 			else if (!cond && cont_i != labels.end()) {
 				(rv::as.*ibf)(cont_i->second);
-				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), (unsigned)branch_pc);
-				rv::as.jmp(term);
 				log_trace("\t\t%s 0x%016llx", ibfname, cont_pc);
-				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), branch_pc);
-				log_trace("\t\tjmp term");
+				emit_exit(branch_pc);
 			} else if (cond) {
 				Label l = rv::as.newLabel();
 				(rv::as.*bf)(l);
-				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), (unsigned)cont_pc);
-				rv::as.jmp(term);
-				rv::as.bind(l);
 				log_trace("\t\t%s 1f", bfname);
-				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), cont_pc);
-				log_trace("\t\tjmp term");
+				emit_exit(cont_pc);
+				rv::as.bind(l);
 				log_trace("\t\t1:");
 				term_pc = branch_pc;
 			} else {
 				Label l = rv::as.newLabel();
 				(rv::as.*ibf)(l);
-				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), (unsigned)branch_pc);
-				rv::as.jmp(term);
-				rv::as.bind(l);
 				log_trace("\t\t%s 1f", ibfname);
-				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), branch_pc);
-				log_trace("\t\tjmp term");
+				emit_exit(branch_pc);
+				rv::as.bind(l);
 				log_trace("\t\t1:");
 				term_pc = cont_pc;
 			}
 			return true;
 		}
 
+		/* direction of a branch while recording, from the pc that followed it */
+		bool branch_taken(decode_type &dec)
+		{
+			size_t next = emit_index + 1;
+			addr_t next_pc = next < trace.size() ? trace[next].pc : trace_next_pc;
+			return next_pc == dec.pc + dec.imm;
+		}
+
 		bool emit_bne(decode_type &dec)
 		{
-			bool cond = proc.ireg[dec.rs1].r.x.val != proc.ireg[dec.rs2].r.x.val;
+			bool cond = branch_taken(dec);
 			return emit_branch(dec, cond, &X86Assembler::jne, "jne", &X86Assembler::je, "je");
 		}
 
 		bool emit_beq(decode_type &dec)
 		{
-			bool cond = proc.ireg[dec.rs1].r.x.val == proc.ireg[dec.rs2].r.x.val;
+			bool cond = branch_taken(dec);
 			return emit_branch(dec, cond, &X86Assembler::je, "je", &X86Assembler::jne, "jne");
 		}
 
 		bool emit_blt(decode_type &dec)
 		{
-			bool cond = proc.ireg[dec.rs1].r.x.val < proc.ireg[dec.rs2].r.x.val;
+			bool cond = branch_taken(dec);
 			return emit_branch(dec, cond, &X86Assembler::jl, "jl", &X86Assembler::jge, "jge");
 		}
 
 		bool emit_bge(decode_type &dec)
 		{
-			bool cond = proc.ireg[dec.rs1].r.x.val >= proc.ireg[dec.rs2].r.x.val;
+			bool cond = branch_taken(dec);
 			return emit_branch(dec, cond, &X86Assembler::jge, "jge", &X86Assembler::jl, "jl");
 		}
 
 		bool emit_bltu(decode_type &dec)
 		{
-			bool cond = proc.ireg[dec.rs1].r.xu.val < proc.ireg[dec.rs2].r.xu.val;
+			bool cond = branch_taken(dec);
 			return emit_branch(dec, cond, &X86Assembler::jb, "jb", &X86Assembler::jae, "jae");
 		}
 
 		bool emit_bgeu(decode_type &dec)
 		{
-			bool cond = proc.ireg[dec.rs1].r.xu.val >= proc.ireg[dec.rs2].r.xu.val;
+			bool cond = branch_taken(dec);
 			return emit_branch(dec, cond, &X86Assembler::jae, "jae", &X86Assembler::jb, "jb");
 		}
 
 		bool emit_ld(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<s64>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2063,6 +3584,7 @@ namespace riscv {
 
 		bool emit_lw(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<s32>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2099,6 +3621,7 @@ namespace riscv {
 
 		bool emit_lwu(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<u32>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2135,6 +3658,7 @@ namespace riscv {
 
 		bool emit_lh(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<s16>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2171,6 +3695,7 @@ namespace riscv {
 
 		bool emit_lhu(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<u16>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2207,6 +3732,7 @@ namespace riscv {
 
 		bool emit_lb(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<s8>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2243,6 +3769,7 @@ namespace riscv {
 
 		bool emit_lbu(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_load<u8>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rdx = rv::x86_reg(dec.rd), rs1x = rv::x86_reg(dec.rs1);
@@ -2279,6 +3806,7 @@ namespace riscv {
 
 		bool emit_sd(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_store<u64>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rs2x = rv::x86_reg(dec.rs2), rs1x = rv::x86_reg(dec.rs1);
@@ -2318,11 +3846,13 @@ namespace riscv {
 					}
 				}
 			}
+			emit_code_page_check(dec);
 			return true;
 		}
 
 		bool emit_sw(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_store<u32>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rs2x = rv::x86_reg(dec.rs2), rs1x = rv::x86_reg(dec.rs1);
@@ -2362,11 +3892,13 @@ namespace riscv {
 					}
 				}
 			}
+			emit_code_page_check(dec);
 			return true;
 		}
 
 		bool emit_sh(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_store<u16>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rs2x = rv::x86_reg(dec.rs2), rs1x = rv::x86_reg(dec.rs1);
@@ -2406,11 +3938,13 @@ namespace riscv {
 					}
 				}
 			}
+			emit_code_page_check(dec);
 			return true;
 		}
 
 		bool emit_sb(decode_type &dec)
 		{
+			if (!mem_direct) return emit_mem_store<u8>(dec, false);
 			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
 			term_pc = dec.pc + inst_length(dec.inst);
 			int rs2x = rv::x86_reg(dec.rs2), rs1x = rv::x86_reg(dec.rs1);
@@ -2450,6 +3984,7 @@ namespace riscv {
 					}
 				}
 			}
+			emit_code_page_check(dec);
 			return true;
 		}
 
@@ -2481,7 +4016,6 @@ namespace riscv {
 				// nop
 			} else {
 				addr_t link_addr = dec.pc + inst_length(dec.inst);
-				callstack.push_back(link_addr);
 				if (rdx > 0) {
 					rv::as.mov(x86::gpq(rdx), Imm(link_addr));
 					log_trace("\t\tmov %s, 0x%llx", rv::x86_reg_str_q(rdx), link_addr);
@@ -2497,25 +4031,75 @@ namespace riscv {
 
 		bool emit_jalr(decode_type &dec)
 		{
-			term_pc = dec.pc + dec.imm;
-			if (dec.rd == rv_ireg_zero && dec.rs1 == rv_ireg_ra && callstack.size() > 0) {
-				addr_t link_addr = callstack.back();
-				callstack.pop_back();
-				rv::as.cmp(x86::gpq(rv::x86_reg(rv_ireg_ra)), Imm(link_addr));
-				Label l = rv::as.newLabel();
-				rv::as.je(l);
-				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), Imm(dec.pc));
-				rv::as.jmp(term);
-				rv::as.bind(l);
-				log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
-				log_trace("\t\tcmp %s, 0x%llx", rv::x86_reg_str_q(rv_ireg_ra), link_addr);
+			log_trace("\t# 0x%016llx\t%s", dec.pc, disasm_inst_simple(dec).c_str());
+
+			/* the trace continues at the target seen while recording */
+			addr_t link_addr = dec.pc + inst_length(dec.inst);
+			addr_t trace_pc = jalr_targets[dec.pc];
+
+			/* rax = target */
+			emit_load_scratch_q(0, dec.rs1, false);
+			if (dec.imm != 0) {
+				rv::as.add(x86::rax, Imm(dec.imm));
+				log_trace("\t\tadd rax, %lld", dec.imm);
+			}
+			rv::as.and_(x86::rax, Imm(-2));
+			log_trace("\t\tand rax, -2");
+
+			/* rd = link address */
+			if (dec.rd != rv_ireg_zero) {
+				int rdx = rv::x86_reg(dec.rd);
+				if (rdx > 0) {
+					rv::as.mov(x86::gpq(rdx), Imm(link_addr));
+					log_trace("\t\tmov %s, 0x%llx", rv::x86_reg_str_q(rdx), link_addr);
+				} else {
+					rv::as.mov(x86::rcx, Imm(link_addr));
+					rv::as.mov(rv::rbp_reg_q(dec.rd), x86::rcx);
+					log_trace("\t\tmov rcx, 0x%llx", link_addr);
+					log_trace("\t\tmov %s, rcx", rv::rbp_reg_str_q(dec.rd));
+				}
+			}
+
+			Label l_trace = rv::as.newLabel();
+
+			/* soft MMU traces return other targets to the runloop */
+			if (!mem_direct) {
+				rv::as.mov(x86::rcx, Imm(trace_pc));
+				rv::as.cmp(x86::rax, x86::rcx);
+				rv::as.je(l_trace);
+				log_trace("\t\tmov rcx, 0x%llx", trace_pc);
+				log_trace("\t\tcmp rax, rcx");
 				log_trace("\t\tje 1f");
-				log_trace("\t\tmov [rbp + %lu], 0x%llx", proc_offset(pc), dec.pc);
+				emit_retire(emit_index + 1);
+				rv::as.mov(x86::qword_ptr(x86::rbp, proc_offset(pc)), x86::rax);
+				rv::as.jmp(term);
+				rv::as.bind(l_trace);
+				log_trace("\t\tmov [rbp + %lu], rax", proc_offset(pc));
 				log_trace("\t\tjmp term");
 				log_trace("\t\t1:");
+				term_pc = trace_pc;
 				return true;
 			}
-			return false;
+
+			Label cache = rv::as.newLabel();
+			caches.push_back(cache);
+
+			rv::as.mov(x86::rcx, Imm(trace_pc));
+			rv::as.cmp(x86::rax, x86::rcx);
+			rv::as.je(l_trace);
+			log_trace("\t\tmov rcx, 0x%llx", trace_pc);
+			log_trace("\t\tcmp rax, rcx");
+			log_trace("\t\tje 1f");
+			emit_retire(emit_index + 1);
+			rv::as.lea(x86::rcx, x86::ptr(cache));
+			rv::as.jmp(dispatch);
+			rv::as.bind(l_trace);
+			log_trace("\t\tlea rcx, [cache_%zu]", caches.size() - 1);
+			log_trace("\t\tjmp dispatch");
+			log_trace("\t\t1:");
+
+			term_pc = trace_pc;
+			return true;
 		}
 
 		bool emit_li(decode_type &dec)
@@ -2583,6 +4167,130 @@ namespace riscv {
 			return true;
 		}
 
+		emit_fn lookup_emit(int op)
+		{
+			switch(op) {
+				case rv_op_auipc: return &fusion_emitter<P>::emit_auipc;
+				case rv_op_add: return &fusion_emitter<P>::emit_add;
+				case rv_op_sub: return &fusion_emitter<P>::emit_sub;
+				case rv_op_slt: return &fusion_emitter<P>::emit_slt;
+				case rv_op_sltu: return &fusion_emitter<P>::emit_sltu;
+				case rv_op_and: return &fusion_emitter<P>::emit_and;
+				case rv_op_or: return &fusion_emitter<P>::emit_or;
+				case rv_op_xor: return &fusion_emitter<P>::emit_xor;
+				case rv_op_sll: return &fusion_emitter<P>::emit_sll;
+				case rv_op_srl: return &fusion_emitter<P>::emit_srl;
+				case rv_op_sra: return &fusion_emitter<P>::emit_sra;
+				case rv_op_sllw: return &fusion_emitter<P>::emit_sllw;
+				case rv_op_srlw: return &fusion_emitter<P>::emit_srlw;
+				case rv_op_sraw: return &fusion_emitter<P>::emit_sraw;
+				case rv_op_addi: return &fusion_emitter<P>::emit_addi;
+				case rv_op_slti: return &fusion_emitter<P>::emit_slti;
+				case rv_op_sltiu: return &fusion_emitter<P>::emit_sltiu;
+				case rv_op_andi: return &fusion_emitter<P>::emit_andi;
+				case rv_op_ori: return &fusion_emitter<P>::emit_ori;
+				case rv_op_xori: return &fusion_emitter<P>::emit_xori;
+				case rv_op_slli: return &fusion_emitter<P>::emit_slli;
+				case rv_op_srli: return &fusion_emitter<P>::emit_srli;
+				case rv_op_srai: return &fusion_emitter<P>::emit_srai;
+				case rv_op_addiw: return &fusion_emitter<P>::emit_addiw;
+				case rv_op_slliw: return &fusion_emitter<P>::emit_slliw;
+				case rv_op_srliw: return &fusion_emitter<P>::emit_srliw;
+				case rv_op_sraiw: return &fusion_emitter<P>::emit_sraiw;
+				case rv_op_mul: return &fusion_emitter<P>::emit_mul;
+				case rv_op_mulh: return &fusion_emitter<P>::emit_mulh;
+				case rv_op_mulhsu: return &fusion_emitter<P>::emit_mulhsu;
+				case rv_op_mulhu: return &fusion_emitter<P>::emit_mulhu;
+				case rv_op_div: return &fusion_emitter<P>::emit_div;
+				case rv_op_divu: return &fusion_emitter<P>::emit_divu;
+				case rv_op_rem: return &fusion_emitter<P>::emit_rem;
+				case rv_op_remu: return &fusion_emitter<P>::emit_remu;
+				case rv_op_mulw: return &fusion_emitter<P>::emit_mulw;
+				case rv_op_divw: return &fusion_emitter<P>::emit_divw;
+				case rv_op_divuw: return &fusion_emitter<P>::emit_divuw;
+				case rv_op_remw: return &fusion_emitter<P>::emit_remw;
+				case rv_op_remuw: return &fusion_emitter<P>::emit_remuw;
+				case rv_op_flw: return &fusion_emitter<P>::emit_flw;
+				case rv_op_fld: return &fusion_emitter<P>::emit_fld;
+				case rv_op_fsw: return &fusion_emitter<P>::emit_fsw;
+				case rv_op_fsd: return &fusion_emitter<P>::emit_fsd;
+				case rv_op_fadd_s: return &fusion_emitter<P>::emit_fadd_s;
+				case rv_op_fsub_s: return &fusion_emitter<P>::emit_fsub_s;
+				case rv_op_fmul_s: return &fusion_emitter<P>::emit_fmul_s;
+				case rv_op_fdiv_s: return &fusion_emitter<P>::emit_fdiv_s;
+				case rv_op_fsqrt_s: return &fusion_emitter<P>::emit_fsqrt_s;
+				case rv_op_fmin_s: return &fusion_emitter<P>::emit_fmin_s;
+				case rv_op_fmax_s: return &fusion_emitter<P>::emit_fmax_s;
+				case rv_op_fadd_d: return &fusion_emitter<P>::emit_fadd_d;
+				case rv_op_fsub_d: return &fusion_emitter<P>::emit_fsub_d;
+				case rv_op_fmul_d: return &fusion_emitter<P>::emit_fmul_d;
+				case rv_op_fdiv_d: return &fusion_emitter<P>::emit_fdiv_d;
+				case rv_op_fsqrt_d: return &fusion_emitter<P>::emit_fsqrt_d;
+				case rv_op_fmin_d: return &fusion_emitter<P>::emit_fmin_d;
+				case rv_op_fmax_d: return &fusion_emitter<P>::emit_fmax_d;
+				case rv_op_fsgnj_s: return &fusion_emitter<P>::emit_fsgnj_s;
+				case rv_op_fsgnjn_s: return &fusion_emitter<P>::emit_fsgnjn_s;
+				case rv_op_fsgnjx_s: return &fusion_emitter<P>::emit_fsgnjx_s;
+				case rv_op_fsgnj_d: return &fusion_emitter<P>::emit_fsgnj_d;
+				case rv_op_fsgnjn_d: return &fusion_emitter<P>::emit_fsgnjn_d;
+				case rv_op_fsgnjx_d: return &fusion_emitter<P>::emit_fsgnjx_d;
+				case rv_op_fmv_x_s: return &fusion_emitter<P>::emit_fmv_x_s;
+				case rv_op_fmv_s_x: return &fusion_emitter<P>::emit_fmv_s_x;
+				case rv_op_fmv_x_d: return &fusion_emitter<P>::emit_fmv_x_d;
+				case rv_op_fmv_d_x: return &fusion_emitter<P>::emit_fmv_d_x;
+				case rv_op_feq_s: return &fusion_emitter<P>::emit_feq_s;
+				case rv_op_flt_s: return &fusion_emitter<P>::emit_flt_s;
+				case rv_op_fle_s: return &fusion_emitter<P>::emit_fle_s;
+				case rv_op_feq_d: return &fusion_emitter<P>::emit_feq_d;
+				case rv_op_flt_d: return &fusion_emitter<P>::emit_flt_d;
+				case rv_op_fle_d: return &fusion_emitter<P>::emit_fle_d;
+				case rv_op_fcvt_s_d: return &fusion_emitter<P>::emit_fcvt_s_d;
+				case rv_op_fcvt_d_s: return &fusion_emitter<P>::emit_fcvt_d_s;
+				case rv_op_fcvt_s_w: return &fusion_emitter<P>::emit_fcvt_s_w;
+				case rv_op_fcvt_s_wu: return &fusion_emitter<P>::emit_fcvt_s_wu;
+				case rv_op_fcvt_s_l: return &fusion_emitter<P>::emit_fcvt_s_l;
+				case rv_op_fcvt_d_w: return &fusion_emitter<P>::emit_fcvt_d_w;
+				case rv_op_fcvt_d_wu: return &fusion_emitter<P>::emit_fcvt_d_wu;
+				case rv_op_fcvt_d_l: return &fusion_emitter<P>::emit_fcvt_d_l;
+				case rv_op_fcvt_w_s: return &fusion_emitter<P>::emit_fcvt_w_s;
+				case rv_op_fcvt_l_s: return &fusion_emitter<P>::emit_fcvt_l_s;
+				case rv_op_fcvt_w_d: return &fusion_emitter<P>::emit_fcvt_w_d;
+				case rv_op_fcvt_l_d: return &fusion_emitter<P>::emit_fcvt_l_d;
+				case rv_op_fmadd_s: return &fusion_emitter<P>::emit_fmadd_s;
+				case rv_op_fmsub_s: return &fusion_emitter<P>::emit_fmsub_s;
+				case rv_op_fnmadd_s: return &fusion_emitter<P>::emit_fnmadd_s;
+				case rv_op_fnmsub_s: return &fusion_emitter<P>::emit_fnmsub_s;
+				case rv_op_fmadd_d: return &fusion_emitter<P>::emit_fmadd_d;
+				case rv_op_fmsub_d: return &fusion_emitter<P>::emit_fmsub_d;
+				case rv_op_fnmadd_d: return &fusion_emitter<P>::emit_fnmadd_d;
+				case rv_op_fnmsub_d: return &fusion_emitter<P>::emit_fnmsub_d;
+				case rv_op_bne: return &fusion_emitter<P>::emit_bne;
+				case rv_op_beq: return &fusion_emitter<P>::emit_beq;
+				case rv_op_blt: return &fusion_emitter<P>::emit_blt;
+				case rv_op_bge: return &fusion_emitter<P>::emit_bge;
+				case rv_op_bltu: return &fusion_emitter<P>::emit_bltu;
+				case rv_op_bgeu: return &fusion_emitter<P>::emit_bgeu;
+				case rv_op_ld: return &fusion_emitter<P>::emit_ld;
+				case rv_op_lw: return &fusion_emitter<P>::emit_lw;
+				case rv_op_lwu: return &fusion_emitter<P>::emit_lwu;
+				case rv_op_lh: return &fusion_emitter<P>::emit_lh;
+				case rv_op_lhu: return &fusion_emitter<P>::emit_lhu;
+				case rv_op_lb: return &fusion_emitter<P>::emit_lb;
+				case rv_op_lbu: return &fusion_emitter<P>::emit_lbu;
+				case rv_op_sd: return &fusion_emitter<P>::emit_sd;
+				case rv_op_sw: return &fusion_emitter<P>::emit_sw;
+				case rv_op_sh: return &fusion_emitter<P>::emit_sh;
+				case rv_op_sb: return &fusion_emitter<P>::emit_sb;
+				case rv_op_lui: return &fusion_emitter<P>::emit_lui;
+				case rv_op_jal: return &fusion_emitter<P>::emit_jal;
+				case rv_op_jalr: return &fusion_emitter<P>::emit_jalr;
+				case fusion_op_li: return &fusion_emitter<P>::emit_li;
+				case fusion_op_la: return &fusion_emitter<P>::emit_la;
+				case fusion_op_call: return &fusion_emitter<P>::emit_call;
+			}
+			return nullptr;
+		}
+
 		bool emit(decode_type &dec)
 		{
 			auto li = labels.find(dec.pc);
@@ -2592,59 +4300,8 @@ namespace riscv {
 			Label l = rv::as.newLabel();
 			labels[dec.pc] = l;
 			rv::as.bind(l);
-			switch(dec.op) {
-				case rv_op_auipc: return emit_auipc(dec);
-				case rv_op_add: return emit_add(dec);
-				case rv_op_sub: return emit_sub(dec);
-				case rv_op_slt: return emit_slt(dec);
-				case rv_op_sltu: return emit_sltu(dec);
-				case rv_op_and: return emit_and(dec);
-				case rv_op_or: return emit_or(dec);
-				case rv_op_xor: return emit_xor(dec);
-				case rv_op_sll: return emit_sll(dec);
-				case rv_op_srl: return emit_srl(dec);
-				case rv_op_sra: return emit_sra(dec);
-				case rv_op_sllw: return emit_sllw(dec);
-				case rv_op_srlw: return emit_srlw(dec);
-				case rv_op_sraw: return emit_sraw(dec);
-				case rv_op_addi: return emit_addi(dec);
-				case rv_op_slti: return emit_slti(dec);
-				case rv_op_sltiu: return emit_sltiu(dec);
-				case rv_op_andi: return emit_andi(dec);
-				case rv_op_ori: return emit_ori(dec);
-				case rv_op_xori: return emit_xori(dec);
-				case rv_op_slli: return emit_slli(dec);
-				case rv_op_srli: return emit_srli(dec);
-				case rv_op_srai: return emit_srai(dec);
-				case rv_op_addiw: return emit_addiw(dec);
-				case rv_op_slliw: return emit_slliw(dec);
-				case rv_op_srliw: return emit_srliw(dec);
-				case rv_op_sraiw: return emit_sraiw(dec);
-				case rv_op_bne: return emit_bne(dec);
-				case rv_op_beq: return emit_beq(dec);
-				case rv_op_blt: return emit_blt(dec);
-				case rv_op_bge: return emit_bge(dec);
-				case rv_op_bltu: return emit_bltu(dec);
-				case rv_op_bgeu: return emit_bgeu(dec);
-				case rv_op_ld: return emit_ld(dec);
-				case rv_op_lw: return emit_lw(dec);
-				case rv_op_lwu: return emit_lwu(dec);
-				case rv_op_lh: return emit_lh(dec);
-				case rv_op_lhu: return emit_lhu(dec);
-				case rv_op_lb: return emit_lb(dec);
-				case rv_op_lbu: return emit_lbu(dec);
-				case rv_op_sd: return emit_sd(dec);
-				case rv_op_sw: return emit_sw(dec);
-				case rv_op_sh: return emit_sh(dec);
-				case rv_op_sb: return emit_sb(dec);
-				case rv_op_lui: return emit_lui(dec);
-				case rv_op_jal: return emit_jal(dec);
-				case rv_op_jalr: return emit_jalr(dec);
-				case fusion_op_li: return emit_li(dec);
-				case fusion_op_la: return emit_la(dec);
-				case fusion_op_call: return emit_call(dec);
-			}
-			return false;
+			emit_fn fn = lookup_emit(dec.op);
+			return fn ? (this->*fn)(dec) : false;
 		}
 	};
 
@@ -0,0 +1,156 @@
+//
+//  fusion-perf.h
+//
+
+#ifndef rv_fusion_perf_h
+#define rv_fusion_perf_h
+
+namespace riscv {
+
+	/*
+	 * fusion_perf publishes compiled traces to host profilers.
+	 *
+	 * the perf map (/tmp/perf-<pid>.map) names the address range of each
+	 * trace so perf report can attribute samples to guest code. the
+	 * jitdump (/tmp/jit-<pid>.dump) also carries a copy of the code for
+	 * perf inject --jit. perf record notices the jitdump by the
+	 * executable mapping of its first page and the record timestamps use
+	 * the monotonic clock, so record with -k mono.
+	 *
+	 * traces are named by guest pc and nearest guest symbol.
+	 */
+	struct fusion_perf
+	{
+		enum : u32 {
+			jitdump_magic = 0x4A695444,
+			jitdump_version = 1,
+			jitdump_elf_mach = 62,          /* EM_X86_64 */
+			jitdump_id_code_load = 0
+		};
+
+		struct jitdump_header
+		{
+			u32 magic;
+			u32 version;
+			u32 total_size;
+			u32 elf_mach;
+			u32 pad1;
+			u32 pid;
+			u64 timestamp;
+			u64 flags;
+		};
+
+		struct jitdump_code_load
+		{
+			u32 id;
+			u32 total_size;
+			u64 timestamp;
+			u32 pid;
+			u32 tid;
+			u64 vma;
+			u64 code_addr;
+			u64 code_size;
+			u64 code_index;
+		};
+
+		symbol_name_fn symlookup;
+		FILE *map_file;
+		FILE *dump_file;
+		void *dump_mark;
+		size_t dump_mark_len;
+		u64 code_index;
+
+		fusion_perf(symbol_name_fn symlookup = null_symbol_lookup)
+			: symlookup(symlookup), map_file(nullptr), dump_file(nullptr),
+			dump_mark(MAP_FAILED), dump_mark_len(0), code_index(0) {}
+
+		~fusion_perf()
+		{
+			if (map_file) fclose(map_file);
+			if (dump_mark != MAP_FAILED) munmap(dump_mark, dump_mark_len);
+			if (dump_file) fclose(dump_file);
+		}
+
+		static u64 timestamp()
+		{
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return u64(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+		}
+
+		void open_map()
+		{
+			std::string filename = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+			map_file = fopen(filename.c_str(), "w");
+			if (!map_file) {
+				panic("perf map: fopen: %s: %s", filename.c_str(), strerror(errno));
+			}
+		}
+
+		void open_dump()
+		{
+			std::string filename = "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+			int fd = open(filename.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+			if (fd < 0) {
+				panic("jitdump: open: %s: %s", filename.c_str(), strerror(errno));
+			}
+			dump_mark_len = sysconf(_SC_PAGESIZE);
+			dump_mark = mmap(nullptr, dump_mark_len, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+			if (dump_mark == MAP_FAILED) {
+				panic("jitdump: mmap: %s: %s", filename.c_str(), strerror(errno));
+			}
+			dump_file = fdopen(fd, "w");
+
+			jitdump_header hdr;
+			memset(&hdr, 0, sizeof(hdr));
+			hdr.magic = jitdump_magic;
+			hdr.version = jitdump_version;
+			hdr.total_size = sizeof(hdr);
+			hdr.elf_mach = jitdump_elf_mach;
+			hdr.pid = getpid();
+			hdr.timestamp = timestamp();
+			fwrite(&hdr, sizeof(hdr), 1, dump_file);
+			fflush(dump_file);
+		}
+
+		std::string trace_name(addr_t pc)
+		{
+			std::string name;
+			const char *sym = symlookup(pc, true);
+			sprintf(name, "rv-trace 0x%llx", pc);
+			if (sym) name += std::string(" ") + sym;
+			return name;
+		}
+
+		void code_load(std::string name, const void *code, size_t size)
+		{
+			if (map_file) {
+				fprintf(map_file, "%" PRIxPTR " %zx %s\n", uintptr_t(code), size, name.c_str());
+				fflush(map_file);
+			}
+			if (dump_file) {
+				jitdump_code_load rec;
+				rec.id = jitdump_id_code_load;
+				rec.total_size = u32(sizeof(rec) + name.size() + 1 + size);
+				rec.timestamp = timestamp();
+				rec.pid = getpid();
+				rec.tid = u32(syscall(SYS_gettid));
+				rec.vma = rec.code_addr = u64(uintptr_t(code));
+				rec.code_size = size;
+				rec.code_index = code_index++;
+				fwrite(&rec, sizeof(rec), 1, dump_file);
+				fwrite(name.c_str(), name.size() + 1, 1, dump_file);
+				fwrite(code, size, 1, dump_file);
+				fflush(dump_file);
+			}
+		}
+
+		void trace_load(addr_t pc, const void *code, size_t size)
+		{
+			code_load(trace_name(pc), code, size);
+		}
+	};
+
+}
+
+#endif
@@ -9,10 +9,10 @@ namespace riscv {
 
 	struct fusion_fault
 	{
-		static fusion_fault *current;
+		static thread_local fusion_fault *current;
 	};
 
-	fusion_fault* fusion_fault::current = nullptr;
+	thread_local fusion_fault* fusion_fault::current = nullptr;
 
 	template <typename P>
 	struct fusion_runloop : fusion_fault, ErrorHandler, P
@@ -26,18 +26,190 @@ namespace riscv {
 			typename P::decode_type dec;
 		};
 
+		static const u32 chain_limit = 1024;
+		static const size_t trace_lookup_size = 4096;
+
 		typedef void (*TraceFunc)(typename P::processor_type *);
 
+		/*
+		 * trace_links maps a pc to the exit slots of compiled traces
+		 * that target it. slots are patched to the trace entry when the
+		 * target is compiled and restored to the exit path on eviction.
+		 */
+		struct trace_slot
+		{
+			uintptr_t *slot;
+			uintptr_t unlinked;
+			addr_t pc;
+		};
+
+		/*
+		 * traces are keyed by the machine physical address of their entry
+		 * as returned by the MMU's instruction fetch. with a soft MMU the
+		 * guest pc of a trace is checked on entry and on linking, so a
+		 * page mapped at more than one address is not entered at the
+		 * wrong one. keys of exits within the page of a trace follow
+		 * from the trace key and exits to other pages are not linked.
+		 */
+		struct trace_ent
+		{
+			addr_t pc;
+			TraceFunc fn;
+			uintptr_t entry;
+			size_t size;
+			u64 last_use;
+			std::vector<std::pair<addr_t,uintptr_t*>> exits;
+			std::vector<u64*> caches;
+			std::vector<addr_t> pages;
+			std::vector<typename P::decode_type> trace;
+			addr_t trace_next_pc;
+			std::map<addr_t,addr_t> jalr_targets;
+			TraceFunc audit_fn;
+		};
+
+		/*
+		 * the code cache is bounded by code_cache_limit bytes. when a new
+		 * trace does not fit, the least recently entered traces are
+		 * retired until the cache is below three quarters of the limit.
+		 * traces are stamped when entered from the runloop, so traces
+		 * only reached by chaining age and are retraced if still hot.
+		 * traces whose source pages are stored to are also retired.
+		 */
+		struct trace_stats
+		{
+			u64 compiles;
+			u64 recompiles;
+			u64 evictions;
+			u64 invalidations;
+			u64 audits;
+			u64 audit_failures;
+			u64 fusions[fusion_type_count];
+			size_t peak_size;
+		};
+
+		static const size_t code_cache_default = 64ULL << 20;
+
+		/*
+		 * hotspots are counted on block entry, at the target of each
+		 * taken branch or jump in the interpreter and at the pc a trace
+		 * exits to, in a small direct mapped table tagged by pc. loop
+		 * headers are entered by backward branches on every iteration
+		 * so they reach hotspot_iters first. a colliding pc takes over
+		 * the entry and starts counting from zero.
+		 */
+		struct hotspot_ent
+		{
+			addr_t pc;
+			u32 count;
+		};
+
+		static const size_t hotspot_table_size = 4096;
+		static const u32 hotspot_skip = std::numeric_limits<u32>::max();
+
+		/*
+		 * trace_lookup is a direct mapped table of trace entries probed
+		 * by the lookup stub that jalr sites jump to on an inline cache
+		 * miss. it is laid out as {pc, entry} for the stub and empty
+		 * entries hold pc 1, which never matches an aligned target.
+		 */
+		struct trace_lookup_ent
+		{
+			u64 pc;
+			u64 entry;
+		};
+
+		/*
+		 * traces are recorded on the emulation thread and, when jit_async
+		 * is set, assembled on a compile thread. finished jobs come back
+		 * through install_queue and are installed by step(), so the trace
+		 * cache and links are only modified on the emulation thread.
+		 */
+		struct trace_job
+		{
+			addr_t pc;
+			addr_t key;
+			CodeHolder code;
+			std::unique_ptr<fusion_tracer<P>> emitter;
+			TraceFunc fn;
+			u64 gen;
+		};
+
+		static const size_t compile_queue_size = 1024;
+
+		/*
+		 * one in audit_rate trace entries is audited against the
+		 * interpreter (see jit_audit_trace). audit_store journals the
+		 * memory at a store made by the interpreter, before the store
+		 * and at the end of the interpreted path.
+		 */
+		struct audit_store
+		{
+			addr_t addr;
+			size_t size;
+			size_t step;
+			u64 prev;
+			u64 interp;
+		};
+
+		static const size_t audit_none = size_t(-1);
+
 		JitRuntime rt;
-		google::dense_hash_map<addr_t,TraceFunc> trace_cache;
+		google::dense_hash_map<addr_t,trace_ent> trace_cache;
+		google::dense_hash_map<addr_t,std::vector<trace_slot>> trace_links;
+		google::dense_hash_map<addr_t,u32> trace_compiles;
+		size_t code_cache_limit;
+		size_t code_cache_size;
+		u64 trace_clock;
+		u64 trace_gen;
+		u64 trace_map_gen;
+		trace_stats stats;
+		hotspot_ent hotspot_table[hotspot_table_size];
+		std::unique_ptr<fusion_perf> perf;
+		trace_lookup_ent trace_lookup[trace_lookup_size];
+		TraceFunc lookup_stub;
+		trace_job *recording;
+		bool jit_running;
+		bool jit_async;
+		u64 audit_rate;
+		u64 audit_count;
+		queue_atomic<trace_job*> compile_queue;
+		queue_atomic<trace_job*> install_queue;
+		std::atomic<bool> compile_running;
+		std::thread compile_thread;
 		std::shared_ptr<debug_cli<P>> cli;
 		rv_inst_cache_ent inst_cache[inst_cache_size];
 
 		fusion_runloop() : fusion_runloop(std::make_shared<debug_cli<P>>()) {}
-		fusion_runloop(std::shared_ptr<debug_cli<P>> cli) : cli(cli), inst_cache()
+		fusion_runloop(std::shared_ptr<debug_cli<P>> cli)
+			: code_cache_limit(code_cache_default), code_cache_size(0),
+			trace_clock(0), trace_gen(0), trace_map_gen(0), stats(), hotspot_table(),
+			trace_lookup(), lookup_stub(nullptr), recording(nullptr), jit_running(false),
+			jit_async(false), audit_rate(0), audit_count(0),
+			compile_queue(compile_queue_size), install_queue(compile_queue_size),
+			compile_running(false), cli(cli), inst_cache()
 		{
 			trace_cache.set_empty_key(0);
 			trace_cache.set_deleted_key(-1);
+			trace_links.set_empty_key(0);
+			trace_links.set_deleted_key(-1);
+			trace_compiles.set_empty_key(0);
+			for (auto &le : trace_lookup) {
+				le.pc = 1;
+			}
+		}
+
+		~fusion_runloop()
+		{
+			if (compile_running) {
+				compile_running = false;
+				compile_thread.join();
+			}
+			trace_job *job;
+			while ((job = compile_queue.pop_front()) != nullptr) delete job;
+			while ((job = install_queue.pop_front()) != nullptr) {
+				if (job->fn) rt.release(job->fn);
+				delete job;
+			}
 		}
 
 		virtual bool handleError(Error err, const char* message, CodeEmitter* origin)
@@ -62,6 +234,37 @@ namespace riscv {
 		}
 
 		void init()
+		{
+			/* signals are handled on the main thread by hart 0 */
+			if (P::hart_id == 0) {
+				init_signals();
+			}
+
+			/* processor initialization */
+			P::init();
+		}
+
+		/* secondary hart thread initialization */
+		void init_thread()
+		{
+			/* leave asynchronous signals to the main thread */
+			sigset_t set;
+			sigemptyset(&set);
+			sigaddset(&set, SIGTERM);
+			sigaddset(&set, SIGQUIT);
+			sigaddset(&set, SIGINT);
+			sigaddset(&set, SIGHUP);
+			sigaddset(&set, SIGUSR1);
+			if (pthread_sigmask(SIG_BLOCK, &set, NULL) != 0) {
+				panic("can't set thread signal mask: %s", strerror(errno));
+			}
+
+			/* faults on this thread are dispatched to this hart */
+			fusion_fault::current = this;
+			P::init_thread();
+		}
+
+		void init_signals()
 		{
 			// block signals before so we don't deadlock in signal handlers
 			sigset_t set;
@@ -99,9 +302,6 @@ namespace riscv {
 			if (pthread_sigmask(SIG_UNBLOCK, &set, NULL) != 0) {
 				panic("can't set thread signal mask: %s", strerror(errno));
 			}
-
-			/* processor initialization */
-			P::init();
 		}
 
 		void run(exit_cause ex = exit_cause_continue)
@@ -111,6 +311,8 @@ namespace riscv {
 			for (;;) {
 				switch (ex) {
 					case exit_cause_continue:
+						/* another hart may have stopped the node */
+						if (!P::running.load(std::memory_order_relaxed)) return;
 						break;
 					case exit_cause_cli:
 						P::debugging = true;
@@ -133,18 +335,353 @@ namespace riscv {
 			}
 		}
 
-		void jit_cache(CodeHolder &code, addr_t pc)
+		void jit_compile(trace_job *job)
 		{
-			TraceFunc fn = nullptr;
-			Error err = rt.add(&fn, &code);
-			if (!err) trace_cache[pc] = fn;
+			job->emitter->emit_trace();
+			if (rt.add(&job->fn, &job->code)) job->fn = nullptr;
 		}
 
+		/* code generation excluding changes of translation */
+		u64 code_version()
+		{
+			return P::code_gen - P::code_map_gen;
+		}
+
+		void jit_install(trace_job *job)
+		{
+			/* drop traces recorded before their code was modified */
+			if (job->fn && job->gen != code_version()) {
+				rt.release(job->fn);
+				hotspot_set(job->pc, 0);
+				stats.invalidations++;
+			} else if (job->fn) {
+				jit_cache(job->code, *job->emitter, job->fn, job->pc, job->key);
+			}
+			delete job;
+		}
+
+		void compile_main()
+		{
+			while (compile_running) {
+				trace_job *job = compile_queue.pop_front();
+				if (!job) {
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+					continue;
+				}
+				jit_compile(job);
+				while (!install_queue.push_back(job)) {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		/* key of a pc on the page of a trace, or zero if on another page */
+		addr_t page_key(addr_t key, addr_t pc, addr_t exit_pc)
+		{
+			if (P::mmu_type::jit_mem_direct) return exit_pc;
+			if ((pc ^ exit_pc) >> page_shift) return 0;
+			return (key & ~addr_t(page_size - 1)) | (exit_pc & (page_size - 1));
+		}
+
+		void jit_cache(CodeHolder &code, fusion_tracer<P> &emitter, TraceFunc fn, addr_t pc, addr_t key)
+		{
+			/* replace any previous trace for this key */
+			jit_evict(key);
+
+			/* make room for the trace */
+			size_t size = code.getCodeSize();
+			if (code_cache_limit && code_cache_size + size > code_cache_limit) {
+				jit_reclaim(size);
+			}
+			if (trace_compiles[key]++ > 0) stats.recompiles++;
+			stats.compiles++;
+			for (int i = 0; i < fusion_type_count; i++) {
+				stats.fusions[i] += emitter.fusions[i];
+			}
+
+			uintptr_t base = uintptr_t(fn);
+			trace_ent &ent = trace_cache[key];
+			ent.pc = pc;
+			ent.fn = fn;
+			ent.entry = base + code.getLabelOffset(emitter.entry);
+			ent.size = size;
+			ent.last_use = trace_clock;
+			ent.audit_fn = nullptr;
+			code_cache_size += size;
+			stats.peak_size = std::max(stats.peak_size, code_cache_size);
+			if (perf) perf->trace_load(pc, (const void*)fn, size);
+
+			/* pages the trace was built from */
+			for (auto &dec : emitter.trace) {
+				addr_t page = page_key(key, pc, dec.pc) >> page_shift;
+				if (std::find(ent.pages.begin(), ent.pages.end(), page) == ent.pages.end()) {
+					ent.pages.push_back(page);
+				}
+			}
+
+			/* keep the recorded trace for audit builds */
+			if (audit_rate) {
+				ent.trace = emitter.trace;
+				ent.trace_next_pc = emitter.trace_next_pc;
+				ent.jalr_targets = emitter.jalr_targets;
+			}
+
+			/* link exits to compiled successors */
+			for (auto &ex : emitter.exits) {
+				addr_t link_key = page_key(key, pc, ex.pc);
+				if (!link_key) continue;
+				uintptr_t *slot = (uintptr_t*)(base + code.getLabelOffset(ex.slot));
+				trace_links[link_key].push_back(trace_slot{slot, *slot, ex.pc});
+				ent.exits.push_back(std::pair<addr_t,uintptr_t*>(link_key, slot));
+				auto ti = trace_cache.find(link_key);
+				if (ti != trace_cache.end() && ti->second.pc == ex.pc) *slot = ti->second.entry;
+			}
+
+			/* back-patch exits waiting for this trace */
+			for (auto &ts : trace_links[key]) {
+				if (ts.pc == pc) *ts.slot = ent.entry;
+			}
+
+			/* publish the entry to indirect branches */
+			for (auto &cache : emitter.caches) {
+				ent.caches.push_back((u64*)(base + code.getLabelOffset(cache)));
+			}
+			if (P::mmu_type::jit_mem_direct) {
+				trace_lookup_ent &le = trace_lookup[trace_lookup_index(pc)];
+				le.pc = pc;
+				le.entry = ent.entry;
+			}
+		}
+
+		static size_t trace_lookup_index(addr_t pc)
+		{
+			return (pc >> 1) & (trace_lookup_size - 1);
+		}
+
+		/*
+		 * lookup stub, entered from a trace's indirect exit with registers
+		 * stored, rax = target and rcx = site inline cache. on a hit the
+		 * target is moved into the first way of the cache and entered,
+		 * otherwise it returns to the runloop.
+		 */
+		void jit_lookup_stub()
+		{
+			CodeHolder code;
+			code.init(rt.getCodeInfo());
+			code.setErrorHandler(this);
+			fusion_base<P> stub(code);
+			Label l_miss = stub.as.newLabel();
+
+			stub.as.push(x86::rsi);
+			stub.as.push(x86::rdi);
+			stub.as.mov(x86::rdi, x86::rax);
+			stub.as.shr(x86::rdi, Imm(1));
+			stub.as.and_(x86::edi, Imm(trace_lookup_size - 1));
+			stub.as.shl(x86::edi, Imm(4));
+			stub.as.mov(x86::rsi, Imm(uintptr_t(trace_lookup)));
+			stub.as.add(x86::rsi, x86::rdi);
+			stub.as.cmp(x86::rax, x86::qword_ptr(x86::rsi));
+			stub.as.jne(l_miss);
+			for (int i = fusion_emitter<P>::jalr_cache_ways - 1; i > 0; i--) {
+				stub.as.mov(x86::rdi, x86::qword_ptr(x86::rcx, (i - 1) * 16));
+				stub.as.mov(x86::qword_ptr(x86::rcx, i * 16), x86::rdi);
+				stub.as.mov(x86::rdi, x86::qword_ptr(x86::rcx, (i - 1) * 16 + 8));
+				stub.as.mov(x86::qword_ptr(x86::rcx, i * 16 + 8), x86::rdi);
+			}
+			stub.as.mov(x86::rdi, x86::qword_ptr(x86::rsi, 8));
+			stub.as.mov(x86::qword_ptr(x86::rcx), x86::rax);
+			stub.as.mov(x86::qword_ptr(x86::rcx, 8), x86::rdi);
+			stub.as.pop(x86::rdi);
+			stub.as.pop(x86::rsi);
+			stub.as.jmp(x86::qword_ptr(x86::rcx, 8));
+			stub.as.bind(l_miss);
+			stub.as.pop(x86::rdi);
+			stub.as.pop(x86::rsi);
+			stub.emit_pop_frame();
+
+			Error err = rt.add(&lookup_stub, &code);
+			if (err) lookup_stub = nullptr;
+			else if (perf) perf->code_load("rv-lookup-stub", (const void*)lookup_stub, code.getCodeSize());
+		}
+
+		void jit_evict(addr_t key)
+		{
+			auto ti = trace_cache.find(key);
+			if (ti == trace_cache.end()) return;
+			addr_t pc = ti->second.pc;
+
+			/* unlink exits entering this trace */
+			auto li = trace_links.find(key);
+			if (li != trace_links.end()) {
+				for (auto &ts : li->second) {
+					*ts.slot = ts.unlinked;
+				}
+			}
+
+			/* forget this trace's own exit slots */
+			for (auto &ex : ti->second.exits) {
+				auto &slots = trace_links[ex.first];
+				slots.erase(std::remove_if(slots.begin(), slots.end(),
+					[&](trace_slot &ts) { return ts.slot == ex.second; }), slots.end());
+			}
+
+			/* drop the entry from the lookup table and inline caches */
+			trace_lookup_ent &le = trace_lookup[trace_lookup_index(pc)];
+			if (le.pc == u64(pc)) {
+				le.pc = 1;
+				le.entry = 0;
+			}
+			for (auto &ent : trace_cache) {
+				for (auto cache : ent.second.caches) {
+					for (int i = 0; i < fusion_emitter<P>::jalr_cache_ways; i++) {
+						if (cache[i * 2] == u64(pc)) {
+							cache[i * 2] = 1;
+							cache[i * 2 + 1] = 0;
+						}
+					}
+				}
+			}
+
+			rt.release(ti->second.fn);
+			if (ti->second.audit_fn) rt.release(ti->second.audit_fn);
+			code_cache_size -= ti->second.size;
+			trace_cache.erase(ti);
+		}
+
+		/* evict a trace and reset its hotspot count so it can be retraced */
+		void jit_retire(addr_t key)
+		{
+			auto ti = trace_cache.find(key);
+			if (ti == trace_cache.end()) return;
+			addr_t pc = ti->second.pc;
+			jit_evict(key);
+			hotspot_set(pc, 0);
+		}
+
+		void jit_reclaim(size_t size)
+		{
+			std::vector<std::pair<u64,addr_t>> lru;
+			for (auto &ent : trace_cache) {
+				lru.push_back(std::pair<u64,addr_t>(ent.second.last_use, ent.first));
+			}
+			std::sort(lru.begin(), lru.end());
+			size_t target = code_cache_limit - code_cache_limit / 4;
+			for (auto &ent : lru) {
+				if (code_cache_size + size <= target) break;
+				jit_retire(ent.second);
+				stats.evictions++;
+			}
+		}
+
+		/*
+		 * retire traces built from the page of the store that hit the
+		 * code page filter, or every trace when the code generation was
+		 * bumped without a store (fence.i) or more than once, then re-mark
+		 * the pages of the remaining traces in the filter. changes of
+		 * translation (sfence.vm) only flush the MMU's JIT TLBs as traces
+		 * are keyed by physical address.
+		 */
+		void jit_invalidate()
+		{
+			u64 flushes = (P::code_gen - trace_gen) - (P::code_map_gen - trace_map_gen);
+			P::mmu.jit_flush();
+			if (flushes > 0) {
+				addr_t store_addr = P::code_store_addr;
+				addr_t store_page = store_addr >> page_shift;
+				std::vector<addr_t> stale;
+				for (auto &ent : trace_cache) {
+					auto &pages = ent.second.pages;
+					if (store_addr == P::code_store_none || flushes > 1 ||
+						std::find(pages.begin(), pages.end(), store_page) != pages.end())
+					{
+						stale.push_back(ent.first);
+					}
+				}
+				for (auto key : stale) {
+					jit_retire(key);
+					stats.invalidations++;
+				}
+				memset(P::code_pages, 0, sizeof(P::code_pages));
+				for (auto &ent : trace_cache) {
+					for (auto page : ent.second.pages) {
+						P::code_page_fetch(page << page_shift);
+					}
+				}
+			}
+			P::code_store_addr = P::code_store_none;
+			trace_gen = P::code_gen;
+			trace_map_gen = P::code_map_gen;
+		}
+
+		void jit_print_stats()
+		{
+			u64 compiles = std::max(stats.compiles, u64(1));
+			printf("jit-code-cache  size=%zu peak=%zu limit=%zu traces=%zu\n",
+				code_cache_size, stats.peak_size, code_cache_limit, trace_cache.size());
+			printf("jit-compiles    %llu recompiles=%llu (%.1f%%)\n",
+				stats.compiles, stats.recompiles, stats.recompiles * 100.0 / compiles);
+			printf("jit-evictions   %llu invalidations=%llu\n",
+				stats.evictions, stats.invalidations);
+			printf("jit-audits      %llu failures=%llu\n",
+				stats.audits, stats.audit_failures);
+			printf("jit-fusions    ");
+			for (int i = 0; i < fusion_type_count; i++) {
+				printf(" %s=%llu", fusion_type_name[i], stats.fusions[i]);
+			}
+			printf("\n");
+		}
+
+		static size_t hotspot_index(addr_t pc)
+		{
+			return (pc >> 1) & (hotspot_table_size - 1);
+		}
+
+		void hotspot_set(addr_t pc, u32 count)
+		{
+			hotspot_ent &he = hotspot_table[hotspot_index(pc)];
+			he.pc = pc;
+			he.count = count;
+		}
+
+		bool hotspot_count(addr_t pc)
+		{
+			hotspot_ent &he = hotspot_table[hotspot_index(pc)];
+			if (he.pc != pc) {
+				he.pc = pc;
+				he.count = 0;
+			} else if (he.count == hotspot_skip) {
+				return false;
+			}
+			return ++he.count >= P::hotspot_iters;
+		}
+
+		void hotspot_enter(addr_t pc)
+		{
+			if (likely(!hotspot_count(pc))) return;
+			jit_trace();
+		}
+
+		/* user mode traces are keyed by pc */
 		bool jit_exec(P &proc, addr_t pc)
 		{
-			auto ti = trace_cache.find(pc);
-			if (ti != trace_cache.end()) {
-				ti->second(static_cast<typename P::processor_type *>(&proc));
+			return jit_exec(proc, pc, pc);
+		}
+
+		bool jit_exec(P &proc, addr_t pc, addr_t key)
+		{
+			if (unlikely(P::code_gen != trace_gen)) jit_invalidate();
+			auto ti = trace_cache.find(key);
+			if (ti != trace_cache.end() && ti->second.pc == pc) {
+				ti->second.last_use = ++trace_clock;
+				if (unlikely(audit_rate > 0) && ++audit_count >= audit_rate) {
+					audit_count = 0;
+					if (jit_audit_trace(ti->second, key)) return true;
+				}
+				P::mmu.jit_sync(proc);
+				proc.chain_budget = chain_limit;
+				jit_running = true;
+				ti->second.fn(static_cast<typename P::processor_type *>(&proc));
+				jit_running = false;
 				return true;
 			}
 			return false;
@@ -152,10 +689,17 @@ namespace riscv {
 
 		void jit_trace()
 		{
-			CodeHolder code;
-			code.init(rt.getCodeInfo());
-			code.setErrorHandler(this);
-			fusion_emitter<P> emitter(*this, code);
+			trace_job *job = new trace_job();
+			job->pc = P::pc;
+			job->key = 0;
+			job->fn = nullptr;
+			job->gen = code_version();
+			job->code.init(rt.getCodeInfo());
+			job->code.setErrorHandler(this);
+			job->emitter.reset(new fusion_tracer<P>(*this, job->code));
+
+			if (P::mmu_type::jit_mem_direct && !lookup_stub) jit_lookup_stub();
+			job->emitter->lookup_stub = uintptr_t(lookup_stub);
 
 			typename P::ux trace_pc = P::pc;
 			typename P::ux trace_instret = P::instret;
@@ -164,37 +708,64 @@ namespace riscv {
 				printf("jit-trace-begin pc=0x%016llx\n", P::pc);
 			}
 
+			/* a trap while recording abandons the trace (see step) */
 			P::log &= ~proc_log_jit_trap;
+			recording = job;
 
-			emitter.emit_prolog();
-			emitter.begin();
 			for(;;) {
 				typename P::decode_type dec;
 				addr_t pc_offset, new_offset;
 				inst_t inst = P::mmu.inst_fetch(*this, P::pc, pc_offset);
+				if (job->key == 0) {
+					job->key = P::mmu.inst_mpa;
+					auto ti = trace_cache.find(job->key);
+					if (ti != trace_cache.end() && ti->second.pc == addr_t(P::pc)) break;
+				}
 				P::inst_decode(dec, inst);
 				dec.pc = P::pc;
 				dec.inst = inst;
-				if (emitter.emit(dec) == false) break;
+				if (job->emitter->record(dec) == false) break;
 				if ((new_offset = P::inst_exec(dec, pc_offset)) == -1) break;
 				P::pc += new_offset;
 				P::cycle++;
 				P::instret++;
 			}
-			emitter.end();
-			emitter.emit_epilog();
+			job->emitter->trace_next_pc = P::pc;
 
 			P::log |= proc_log_jit_trap;
+			recording = nullptr;
 
 			if (P::log & proc_log_jit_trace) {
 				printf("jit-trace-end   pc=0x%016llx\n", P::pc);
 			}
 
 			if (P::instret == trace_instret) {
-				P::histogram_set_pc(trace_pc, P::hostspot_trace_skip);
+				hotspot_set(trace_pc, hotspot_skip);
+				delete job;
+				return;
+			}
+
+			/* hand the trace to the compile thread, skipping its hotspot until installed */
+			if (jit_async) {
+				if (!compile_running) {
+					compile_running = true;
+					compile_thread = std::thread(&fusion_runloop<P>::compile_main, this);
+				}
+				if (compile_queue.push_back(job)) {
+					hotspot_set(trace_pc, hotspot_skip);
+					return;
+				}
 			}
-			else {
-				jit_cache(code, trace_pc);
+
+			jit_compile(job);
+			jit_install(job);
+		}
+
+		void jit_install_pending()
+		{
+			trace_job *job;
+			while ((job = install_queue.pop_front()) != nullptr) {
+				jit_install(job);
 			}
 		}
 
@@ -204,24 +775,22 @@ namespace riscv {
 			code.init(rt.getCodeInfo());
 			code.setErrorHandler(this);
 			fusion_emitter<P> emitter(*this, code);
-			processor_rv64imafd pre_jit, post_jit;
+			typename P::processor_type pre_jit, post_jit;
 			bool audited = false;
 
 			/* jit instruction */
-			emitter.emit_prolog();
-			emitter.begin();
 			addr_t save_pc = dec.pc = P::pc;
 			dec.inst = inst;
-			if (emitter.emit(dec)) {
-				emitter.end();
-				emitter.emit_epilog();
+			if (emitter.record(dec)) {
+				emitter.emit_trace();
 				TraceFunc fn;
 				Error err = rt.add(&fn, &code);
 				if (!err) {
-					memcpy(&pre_jit, static_cast<processor_rv64imafd*>(this), sizeof(processor_rv64imafd));
-					fn(static_cast<processor_rv64imafd*>(this));
-					memcpy(&post_jit, static_cast<processor_rv64imafd*>(this), sizeof(processor_rv64imafd));
-					memcpy(static_cast<processor_rv64imafd*>(this), &pre_jit, sizeof(processor_rv64imafd));
+					typename P::processor_type *state = static_cast<typename P::processor_type*>(this);
+					memcpy((void*)&pre_jit, (void*)state, sizeof(pre_jit));
+					fn(state);
+					memcpy((void*)&post_jit, (void*)state, sizeof(post_jit));
+					jit_audit_restore(pre_jit);
 					audited = true;
 					rt.release(fn);
 				}
@@ -262,16 +831,191 @@ namespace riscv {
 			}
 		}
 
+		static size_t audit_store_size(int op)
+		{
+			switch (op) {
+				case rv_op_sb: return 1;
+				case rv_op_sh: return 2;
+				case rv_op_sw: case rv_op_fsw: return 4;
+				case rv_op_sd: case rv_op_fsd: return 8;
+			}
+			return 0;
+		}
+
+		/* audit builds neither loop nor chain and count retired instructions */
+		bool jit_audit_compile(trace_ent &ent)
+		{
+			if (ent.trace.size() == 0) return false;
+			CodeHolder code;
+			code.init(rt.getCodeInfo());
+			code.setErrorHandler(this);
+			fusion_tracer<P> emitter(*this, code);
+			emitter.trace = ent.trace;
+			emitter.trace_next_pc = ent.trace_next_pc;
+			emitter.jalr_targets = ent.jalr_targets;
+			emitter.audit = true;
+			emitter.emit_trace();
+			if (rt.add(&ent.audit_fn, &code)) ent.audit_fn = nullptr;
+			return ent.audit_fn != nullptr;
+		}
+
+		/* restore hart state, keeping a stop requested by another hart */
+		void jit_audit_restore(typename P::processor_type &saved)
+		{
+			bool running = P::running.load(std::memory_order_relaxed);
+			memcpy((void*)static_cast<typename P::processor_type*>(this), (void*)&saved, sizeof(saved));
+			if (!running) P::running = false;
+		}
+
+		/* undo the journaled stores and restore registers */
+		void jit_audit_rollback(typename P::processor_type &pre, std::vector<audit_store> &journal)
+		{
+			for (auto si = journal.rbegin(); si != journal.rend(); si++) {
+				memcpy((void*)uintptr_t(si->addr), &si->prev, si->size);
+			}
+			jit_audit_restore(pre);
+		}
+
+		/*
+		 * trace audit. the path of the trace is interpreted from the
+		 * current state, journaling memory before each store, then memory
+		 * and registers are rolled back and an audit build of the trace
+		 * is run from the same state. integer and FP registers, the pc,
+		 * instructions retired and the stored memory are compared, and
+		 * the instruction that last wrote the earliest diverging location
+		 * is reported. a failing trace is dropped and execution continues
+		 * from the interpreter's results. the journal holds host
+		 * addresses, so audits need direct memory.
+		 */
+		bool jit_audit_trace(trace_ent &ent, addr_t key)
+		{
+			typedef typename P::processor_type state_type;
+			if (!P::mmu_type::jit_mem_direct) return false;
+			if (!ent.audit_fn && !jit_audit_compile(ent)) return false;
+
+			state_type *state = static_cast<state_type*>(this);
+			state_type pre, interp;
+			typename P::ireg_t last_ireg[P::ireg_count];
+			typename P::freg_t last_freg[P::freg_count];
+			size_t ireg_writer[P::ireg_count], freg_writer[P::freg_count];
+			std::vector<typename P::decode_type> path;
+			std::vector<audit_store> journal;
+			std::fill(ireg_writer, ireg_writer + P::ireg_count, audit_none);
+			std::fill(freg_writer, freg_writer + P::freg_count, audit_none);
+			memcpy((void*)&pre, (void*)state, sizeof(pre));
+
+			/* interpret while the path follows the trace */
+			for (;;) {
+				typename P::decode_type dec;
+				addr_t pc_offset, new_offset;
+				inst_t inst = P::mmu.inst_fetch(*this, P::pc, pc_offset);
+				P::inst_decode(dec, inst);
+				dec.pc = P::pc;
+				dec.inst = inst;
+				size_t size = audit_store_size(dec.op);
+				if (size > 0) {
+					audit_store st = { addr_t(P::ireg[dec.rs1].r.xu.val + dec.imm), size, path.size(), 0, 0 };
+					memcpy(&st.prev, (void*)uintptr_t(st.addr), size);
+					journal.push_back(st);
+				}
+				memcpy(last_ireg, &P::ireg[0], sizeof(last_ireg));
+				memcpy(last_freg, &P::freg[0], sizeof(last_freg));
+				if ((new_offset = P::inst_exec(dec, pc_offset)) == -1) {
+					jit_audit_rollback(pre, journal);
+					return false;
+				}
+				P::pc += new_offset;
+				P::cycle++;
+				P::instret++;
+				for (size_t i = 0; i < P::ireg_count; i++) {
+					if (P::ireg[i].r.xu.val != last_ireg[i].r.xu.val) ireg_writer[i] = path.size();
+				}
+				for (size_t i = 0; i < P::freg_count; i++) {
+					if (P::freg[i].r.xu.val != last_freg[i].r.xu.val) freg_writer[i] = path.size();
+				}
+				path.push_back(dec);
+				if (path.size() == ent.trace.size() || addr_t(P::pc) != ent.trace[path.size()].pc) break;
+			}
+			memcpy((void*)&interp, (void*)state, sizeof(interp));
+			for (auto &st : journal) {
+				memcpy(&st.interp, (void*)uintptr_t(st.addr), st.size);
+			}
+
+			/* run the audit build from the same state */
+			jit_audit_rollback(pre, journal);
+			P::mmu.jit_sync(*this);
+			P::chain_budget = 1;
+			jit_running = true;
+			ent.audit_fn(state);
+			jit_running = false;
+			stats.audits++;
+
+			/* compare, noting the earliest writer of a diverging location */
+			size_t steps = path.size(), jit_steps = size_t(P::instret - pre.instret);
+			size_t first = audit_none;
+			auto diverge = [&](size_t step) {
+				first = std::min(first, step == audit_none ? steps - 1 : step);
+			};
+			for (size_t i = 0; i < P::ireg_count; i++) {
+				if (interp.ireg[i].r.xu.val != P::ireg[i].r.xu.val) {
+					printf("ERROR interp-%s=0x%016llx jit-%s=0x%016llx\n",
+						rv_ireg_name_sym[i], interp.ireg[i].r.xu.val,
+						rv_ireg_name_sym[i], P::ireg[i].r.xu.val);
+					diverge(ireg_writer[i]);
+				}
+			}
+			for (size_t i = 0; i < P::freg_count; i++) {
+				if (interp.freg[i].r.xu.val != P::freg[i].r.xu.val) {
+					printf("ERROR interp-%s=0x%016llx jit-%s=0x%016llx\n",
+						rv_freg_name_sym[i], interp.freg[i].r.xu.val,
+						rv_freg_name_sym[i], P::freg[i].r.xu.val);
+					diverge(freg_writer[i]);
+				}
+			}
+			for (size_t i = 0; i < journal.size(); i++) {
+				audit_store &st = journal[i];
+				bool last = std::none_of(journal.begin() + i + 1, journal.end(),
+					[&](audit_store &later) { return later.addr == st.addr; });
+				u64 val = 0;
+				memcpy(&val, (void*)uintptr_t(st.addr), st.size);
+				if (last && val != st.interp) {
+					printf("ERROR interp-mem[0x%016llx]=0x%llx jit-mem[0x%016llx]=0x%llx\n",
+						st.addr, st.interp, st.addr, val);
+					diverge(st.step);
+				}
+			}
+			if (interp.pc != P::pc || steps != jit_steps) {
+				printf("ERROR interp-pc=0x%016llx jit-pc=0x%016llx interp-instret=%zu jit-instret=%zu\n",
+					interp.pc, P::pc, steps, jit_steps);
+				diverge(std::max(std::min(steps, jit_steps), size_t(1)) - 1);
+			}
+			if (first == audit_none) return true;
+
+			/* report and continue without the trace */
+			stats.audit_failures++;
+			printf("jit-audit-fail  trace=0x%016llx first diverging instruction:\n", pre.pc);
+			printf("\t# 0x%016llx\t%s\n", path[first].pc, disasm_inst_simple(path[first]).c_str());
+			jit_audit_restore(interp);
+			for (auto &st : journal) {
+				memcpy((void*)uintptr_t(st.addr), &st.interp, st.size);
+			}
+			jit_evict(key);
+			hotspot_set(pre.pc, hotspot_skip);
+			return true;
+		}
+
 		exit_cause step(size_t count)
 		{
 			typename P::decode_type dec;
-			typename P::ux inststop = P::instret + count;
 			addr_t pc_offset, new_offset;
 			inst_t inst = 0, inst_cache_key;
 
-			/* interrupt service routine */
-			P::time = cpu_cycle_clock();
+			/* install traces finished by the compile thread */
+			if (compile_running) jit_install_pending();
+
+			/* interrupt service routine, stepping no further than the next event */
 			P::isr();
+			typename P::ux inststop = P::instret + P::step_limit(count);
 
 			/* trap return path */
 			int cause;
@@ -286,23 +1030,32 @@ namespace riscv {
 						return exit_cause_poweroff;
 					case P::internal_cause_poweroff:
 						return exit_cause_poweroff;
-					case P::internal_cause_hotspot:
-						jit_trace();
-						return exit_cause_continue;
+				}
+				if (jit_running) {
+					/* faulting access in a trace, state is stored at the instruction */
+					dec = typename P::decode_type();
+					jit_running = false;
+				}
+				if (recording) {
+					hotspot_set(recording->pc, 0);
+					delete recording;
+					recording = nullptr;
+					P::log |= proc_log_jit_trap;
 				}
 				P::trap(dec, cause);
-				if (!P::running) return exit_cause_poweroff;
+				if (!P::running.load(std::memory_order_relaxed)) return exit_cause_poweroff;
 			}
 
 			/* step the processor */
 			while (P::instret < inststop) {
-				if ((P::log & proc_log_jit_trap) && jit_exec(*this, P::pc)) {
-					continue;
-				}
 				if (P::pc == P::breakpoint && P::breakpoint != 0) {
 					return exit_cause_cli;
 				}
 				inst = P::mmu.inst_fetch(*this, P::pc, pc_offset);
+				if ((P::log & proc_log_jit_trap) && jit_exec(*this, P::pc, P::mmu.inst_mpa)) {
+					hotspot_enter(P::pc);
+					continue;
+				}
 				inst_cache_key = inst % inst_cache_size;
 				if (inst_cache[inst_cache_key].inst == inst) {
 					dec = inst_cache[inst_cache_key].dec;
@@ -321,6 +1074,11 @@ namespace riscv {
 					P::pc += new_offset;
 					P::cycle++;
 					P::instret++;
+					if ((P::log & proc_log_jit_trap) && new_offset != pc_offset) {
+						hotspot_enter(P::pc);
+					}
+					/* wfi returns so the next step services pending interrupts */
+					if (dec.op == rv_op_wfi) return exit_cause_continue;
 				} else {
 					P::raise(rv_cause_illegal_instruction, P::pc);
 				}
@@ -7,154 +7,452 @@
 
 namespace riscv {
 
+	enum fusion_type {
+		fusion_type_li,                 /* lui; addi[w] */
+		fusion_type_la,                 /* auipc; addi */
+		fusion_type_call,               /* auipc; jalr */
+		fusion_type_zext,               /* slli; srli */
+		fusion_type_load_index,         /* add; load */
+		fusion_type_load_abs,           /* lui; load */
+		fusion_type_load_pcrel,         /* auipc; load */
+		fusion_type_cmp_branch,         /* slt[i][u]; beqz/bnez */
+		fusion_type_sext_w,             /* add/sub/addi/mul; sext.w */
+		fusion_type_count
+	};
+
+	static const char* fusion_type_name[fusion_type_count] = {
+		"li",
+		"la",
+		"call",
+		"zext",
+		"load-index",
+		"load-abs",
+		"load-pcrel",
+		"cmp-branch",
+		"sext-w"
+	};
+
+	/*
+	 * fusion_tracer emits recorded traces with adjacent instruction
+	 * pairs lowered to shorter host sequences. pairs are matched
+	 * against a table of patterns, each giving the opcodes and
+	 * meta/constraints checks for both instructions and how the
+	 * second instruction must use the result of the first.
+	 *
+	 * fusion only applies when the first result is consumed (or
+	 * overwritten) by the second, so the guest register state at the
+	 * end of the pair is the same. memory patterns are only used with
+	 * direct memory as a soft MMU access may trap between the pair.
+	 * branches into the middle of a pair leave the trace.
+	 */
 	template <typename P>
 	struct fusion_tracer : fusion_emitter<P>
 	{
 		typedef typename P::decode_type decode_type;
+		typedef fusion_emitter<P> em;
+		typedef fusion_base<P> rv;
+
+		typedef bool (fusion_tracer<P>::*emit_pair_fn)(decode_type &d1, decode_type &d2);
+
+		enum {
+			fusion_link_rs1 = 1,        /* second rs1 is the first rd */
+			fusion_link_rd = 2,         /* second rd is the first rd */
+			fusion_link_imm = 4,        /* second imm is the first imm */
+			fusion_mem = 8              /* direct memory only */
+		};
 
-		enum match_state {
-			match_state_none,
-			match_state_auipc,
-			match_state_call,
-			match_state_la,
-			match_state_li,
-			match_state_lui,
+		struct fusion_pattern
+		{
+			fusion_type type;
+			const int *ops1;
+			const rvc_constraint *cons1;
+			const int *ops2;
+			const rvc_constraint *cons2;
+			int link;
+			emit_pair_fn emit;
 		};
 
-		u64 imm;
-		int rd;
-		addr_t pseudo_pc;
-		match_state state;
-		std::vector<decode_type> queue;
+		u64 fusions[fusion_type_count];
+		fusion_type fusing;
 
 		fusion_tracer(P &proc, CodeHolder &code)
-			: fusion_emitter<P>(proc, code), imm(0), rd(0), state(match_state_none) {}
+			: fusion_emitter<P>(proc, code), fusions(), fusing(fusion_type_count) {}
 
-		void emit_queue()
+		static const fusion_pattern* patterns()
 		{
-			state = match_state_none;
-			for (auto &dec : queue) {
-				fusion_emitter<P>::emit(dec);
+			static const int op_lui[] = { rv_op_lui, 0 };
+			static const int op_auipc[] = { rv_op_auipc, 0 };
+			static const int op_addi[] = { rv_op_addi, rv_op_addiw, 0 };
+			static const int op_addi_64[] = { rv_op_addi, 0 };
+			static const int op_jalr[] = { rv_op_jalr, 0 };
+			static const int op_slli[] = { rv_op_slli, 0 };
+			static const int op_srli[] = { rv_op_srli, 0 };
+			static const int op_add[] = { rv_op_add, 0 };
+			static const int op_load[] = {
+				rv_op_ld, rv_op_lw, rv_op_lwu, rv_op_lh, rv_op_lhu, rv_op_lb, rv_op_lbu, 0
+			};
+			static const int op_slt[] = { rv_op_slt, rv_op_sltu, rv_op_slti, rv_op_sltiu, 0 };
+			static const int op_bcc[] = { rv_op_bne, rv_op_beq, 0 };
+			static const int op_arith[] = { rv_op_add, rv_op_sub, rv_op_addi, rv_op_mul, 0 };
+			static const int op_addiw[] = { rv_op_addiw, 0 };
+
+			static const rvc_constraint c_none[] = { rvc_end };
+			static const rvc_constraint c_rd[] = { rvc_rd_ne_x0, rvc_end };
+			static const rvc_constraint c_rd_rs1[] = { rvc_rd_eq_rs1, rvc_end };
+			static const rvc_constraint c_index[] = { rvc_rd_ne_x0, rvc_rs1_ne_x0, rvc_rs2_ne_x0, rvc_end };
+			static const rvc_constraint c_bz[] = { rvc_rs2_eq_x0, rvc_end };
+			static const rvc_constraint c_sext[] = { rvc_rd_eq_rs1, rvc_imm_eq_zero, rvc_end };
+
+			static const fusion_pattern table[] = {
+				{ fusion_type_sext_w, op_arith, c_rd, op_addiw, c_sext,
+					fusion_link_rs1 | fusion_link_rd, &fusion_tracer<P>::emit_fused_sext_w },
+				{ fusion_type_li, op_lui, c_rd, op_addi, c_rd_rs1,
+					fusion_link_rs1 | fusion_link_rd, &fusion_tracer<P>::emit_fused_li },
+				{ fusion_type_la, op_auipc, c_rd, op_addi_64, c_rd_rs1,
+					fusion_link_rs1 | fusion_link_rd, &fusion_tracer<P>::emit_fused_la },
+				{ fusion_type_call, op_auipc, c_rd, op_jalr, c_none,
+					fusion_link_rs1 | fusion_link_rd, &fusion_tracer<P>::emit_fused_call },
+				{ fusion_type_zext, op_slli, c_rd, op_srli, c_rd_rs1,
+					fusion_link_rs1 | fusion_link_rd | fusion_link_imm, &fusion_tracer<P>::emit_fused_zext },
+				{ fusion_type_load_index, op_add, c_index, op_load, c_rd_rs1,
+					fusion_link_rs1 | fusion_link_rd | fusion_mem, &fusion_tracer<P>::emit_fused_load },
+				{ fusion_type_load_abs, op_lui, c_rd, op_load, c_rd_rs1,
+					fusion_link_rs1 | fusion_link_rd | fusion_mem, &fusion_tracer<P>::emit_fused_load },
+				{ fusion_type_load_pcrel, op_auipc, c_rd, op_load, c_rd_rs1,
+					fusion_link_rs1 | fusion_link_rd | fusion_mem, &fusion_tracer<P>::emit_fused_load },
+				{ fusion_type_cmp_branch, op_slt, c_rd, op_bcc, c_bz,
+					fusion_link_rs1, &fusion_tracer<P>::emit_fused_branch },
+				{ fusion_type_count, nullptr, nullptr, nullptr, nullptr, 0, nullptr }
+			};
+			return table;
+		}
+
+		static bool match_op(const int *ops, int op)
+		{
+			for (; *ops; ops++) {
+				if (*ops == op) return true;
 			}
-			queue.clear();
-		}
-
-		void clear_queue()
-		{
-			state = match_state_none;
-			queue.clear();
-		}
-
-		void begin()
-		{
-			fusion_emitter<P>::emit_prolog();
-		}
-
-		void end()
-		{
-			emit_queue();
-			fusion_emitter<P>::emit_epilog();
-		}
-
-		bool emit(decode_type &dec)
-		{
-		reparse:
-			switch(state) {
-				case match_state_none:
-					switch (dec.op) {
-						case rv_op_addi:
-							if (dec.rs1 == rv_ireg_zero) {
-								rd = dec.rd;
-								imm = dec.imm;
-								pseudo_pc = dec.pc;
-								state = match_state_li;
-								queue.push_back(dec);
-								return true;
-							}
-							break;
-						case rv_op_auipc:
-							rd = dec.rd;
-							imm = dec.imm;
-							pseudo_pc = dec.pc;
-							state = match_state_auipc;
-							queue.push_back(dec);
-							return true;
-						case rv_op_lui:
-							rd = dec.rd;
-							imm = dec.imm;
-							pseudo_pc = dec.pc;
-							state = match_state_lui;
-							queue.push_back(dec);
-							return true;
-						default:
-							break;
-					}
-					break;
-				case match_state_auipc:
-					switch (dec.op) {
-						case rv_op_addi: state = match_state_la; goto reparse;
-						case rv_op_jalr: state = match_state_call; goto reparse;
-						default:
-							emit_queue();
-							break;
-					}
-					break;
-				case match_state_lui:
-					switch (dec.op) {
-						case rv_op_slli: state = match_state_li; goto reparse;
-						case rv_op_addi: state = match_state_li; goto reparse;
-						default:
-							emit_queue();
-							break;
-					}
-					break;
-				case match_state_li:
-					switch (dec.op) {
-						case rv_op_addi:
-							if (rd == dec.rd && rd == dec.rs1) {
-								imm += dec.imm;
-								return true;
-							}
-							break;
-						case rv_op_slli:
-							if (rd == dec.rd && rd == dec.rs1) {
-								imm <<= dec.imm;
-								return true;
-							}
-							break;
-						default:
-							break;
-					}
-					{
-						fusion_decode dec(pseudo_pc, fusion_op_li, rd, imm);
-						fusion_emitter<P>::emit(dec);
-						clear_queue();
-						goto reparse;
-					}
-					break;
-				case match_state_la:
-					if (rd == dec.rd && rd == dec.rs1) {
-						imm += dec.imm;
-						fusion_decode dec(pseudo_pc, fusion_op_la, rd, imm);
-						fusion_emitter<P>::emit(dec);
-						clear_queue();
-						return true;
+			return false;
+		}
+
+		static bool match(const fusion_pattern *p, decode_type &d1, decode_type &d2)
+		{
+			if (!match_op(p->ops1, d1.op) || !match_op(p->ops2, d2.op)) return false;
+			if ((p->link & fusion_link_rs1) && d2.rs1 != d1.rd) return false;
+			if ((p->link & fusion_link_rd) && d2.rd != d1.rd) return false;
+			if ((p->link & fusion_link_imm) && d2.imm != d1.imm) return false;
+			if ((p->link & fusion_mem) && !em::mem_direct) return false;
+			return constraint_check(d1, p->cons1) && constraint_check(d2, p->cons2);
+		}
+
+		/* emit the pair at index if it matches, leaving emit_index at its second instruction */
+		virtual bool emit_fused(size_t index)
+		{
+			if (index + 1 >= em::trace.size()) return false;
+			decode_type &d1 = em::trace[index], &d2 = em::trace[index + 1];
+			if (d2.pc != d1.pc + addr_t(inst_length(d1.inst))) return false;
+			for (const fusion_pattern *p = patterns(); p->ops1; p++) {
+				if (!match(p, d1, d2)) continue;
+				Label l = rv::as.newLabel();
+				em::labels[d1.pc] = l;
+				rv::as.bind(l);
+				em::emit_index = index + 1;
+				fusing = p->type;
+				if ((this->*p->emit)(d1, d2)) {
+					fusions[p->type]++;
+					return true;
+				}
+				/* declined before emitting, emit() binds a new label */
+				em::labels.erase(d1.pc);
+				em::emit_index = index;
+			}
+			return false;
+		}
+
+		void log_pair(decode_type &d1, decode_type &d2)
+		{
+			em::log_trace("\t# fusion %s", fusion_type_name[fusing]);
+			em::log_trace("\t# 0x%016llx\t%s", d1.pc, disasm_inst_simple(d1).c_str());
+			em::log_trace("\t# 0x%016llx\t%s", d2.pc, disasm_inst_simple(d2).c_str());
+		}
+
+		void set_term_pc(decode_type &dec)
+		{
+			em::term_pc = dec.pc + inst_length(dec.inst);
+		}
+
+		const X86Mem rbp_reg_sized(int reg, size_t size, std::string &str)
+		{
+			size_t offset = proc_offset(ireg) + reg * (P::xlen >> 3);
+			switch (size) {
+				case 1: sprintf(str, "byte ptr [rbp + %lu]", offset); return x86::byte_ptr(x86::rbp, offset);
+				case 2: sprintf(str, "word ptr [rbp + %lu]", offset); return x86::word_ptr(x86::rbp, offset);
+				case 4: sprintf(str, "dword ptr [rbp + %lu]", offset); return x86::dword_ptr(x86::rbp, offset);
+				default: sprintf(str, "qword ptr [rbp + %lu]", offset); return x86::qword_ptr(x86::rbp, offset);
+			}
+		}
+
+		/* store rax to rd unless the result was emitted to its host register */
+		void emit_result(decode_type &dec, int dst)
+		{
+			if (dst == 0) em::emit_store_rax(dec);
+		}
+
+		bool emit_fused_li(decode_type &d1, decode_type &d2)
+		{
+			log_pair(d1, d2);
+			s64 imm = d1.imm + d2.imm;
+			if (d2.op == rv_op_addiw) imm = s32(imm);
+			fusion_decode dec(d1.pc, fusion_op_li, d2.rd, imm);
+			em::emit_li(dec);
+			set_term_pc(d2);
+			return true;
+		}
+
+		bool emit_fused_la(decode_type &d1, decode_type &d2)
+		{
+			log_pair(d1, d2);
+			fusion_decode dec(d1.pc, fusion_op_la, d2.rd, d1.imm + d2.imm);
+			em::emit_la(dec);
+			set_term_pc(d2);
+			return true;
+		}
+
+		/* the call target is static so the jalr needs no target check */
+		bool emit_fused_call(decode_type &d1, decode_type &d2)
+		{
+			log_pair(d1, d2);
+			addr_t target = (d1.pc + d1.imm + d2.imm) & ~addr_t(1);
+			fusion_decode dec(d2.pc, fusion_op_call, d2.rd, target - d2.pc);
+			dec.inst = d2.inst;
+			em::emit_call(dec);
+			return true;
+		}
+
+		/* slli rd, rs1, n; srli rd, rd, n with n = 32, 48 or 56 */
+		bool emit_fused_zext(decode_type &d1, decode_type &d2)
+		{
+			size_t size = d1.imm == 32 ? 4 : d1.imm == 48 ? 2 : d1.imm == 56 ? 1 : 0;
+			if (size == 0) return false;
+			log_pair(d1, d2);
+			int rs1x = rv::x86_reg(d1.rs1), rdx = rv::x86_reg(d2.rd);
+			int dst = std::max(rdx, 0);
+			std::string src_str;
+			if (rs1x > 0) {
+				X86Gp src = em::sized_reg(rs1x, size);
+				src_str = em::sized_reg_str(rs1x, size);
+				if (size == 4) rv::as.mov(x86::gpd(dst), src);
+				else rv::as.movzx(x86::gpd(dst), src);
+			} else {
+				X86Mem src = rbp_reg_sized(d1.rs1, size, src_str);
+				if (size == 4) rv::as.mov(x86::gpd(dst), src);
+				else rv::as.movzx(x86::gpd(dst), src);
+			}
+			em::log_trace("\t\t%s %s, %s", size == 4 ? "mov" : "movzx",
+				rv::x86_reg_str_d(dst), src_str.c_str());
+			emit_result(d2, dst);
+			set_term_pc(d2);
+			return true;
+		}
+
+		static size_t load_size(int op)
+		{
+			switch (op) {
+				case rv_op_lb: case rv_op_lbu: return 1;
+				case rv_op_lh: case rv_op_lhu: return 2;
+				case rv_op_lw: case rv_op_lwu: return 4;
+				default: return 8;
+			}
+		}
+
+		static bool load_signed(int op)
+		{
+			return op == rv_op_lb || op == rv_op_lh || op == rv_op_lw;
+		}
+
+		X86Mem load_ptr(size_t size, const X86Gp &base, s32 disp)
+		{
+			switch (size) {
+				case 1: return x86::byte_ptr(base, disp);
+				case 2: return x86::word_ptr(base, disp);
+				case 4: return x86::dword_ptr(base, disp);
+				default: return x86::qword_ptr(base, disp);
+			}
+		}
+
+		X86Mem load_ptr(size_t size, const X86Gp &base, const X86Gp &index, s32 disp)
+		{
+			switch (size) {
+				case 1: return x86::byte_ptr(base, index, 0, disp);
+				case 2: return x86::word_ptr(base, index, 0, disp);
+				case 4: return x86::dword_ptr(base, index, 0, disp);
+				default: return x86::qword_ptr(base, index, 0, disp);
+			}
+		}
+
+		/*
+		 * add rd, rs1, rs2; l{d,w,h,b}[u] rd, imm(rd) loads [rs1 + rs2 + imm]
+		 * lui rd, hi; l* rd, lo(rd) and auipc rd, hi; l* rd, lo(rd) load
+		 * from an address known when the trace is emitted
+		 */
+		bool emit_fused_load(decode_type &d1, decode_type &d2)
+		{
+			log_pair(d1, d2);
+			size_t size = load_size(d2.op);
+			int rdx = rv::x86_reg(d2.rd);
+			int dst = std::max(rdx, 0);
+			const char *ptr_name = size == 1 ? "byte" : size == 2 ? "word" : size == 4 ? "dword" : "qword";
+			std::string addr_str;
+			X86Mem mem;
+
+			if (d1.op == rv_op_add) {
+				int rs1x = rv::x86_reg(d1.rs1), rs2x = rv::x86_reg(d1.rs2);
+				if (rs1x > 0 && rs2x > 0) {
+					mem = load_ptr(size, x86::gpq(rs1x), x86::gpq(rs2x), s32(d2.imm));
+					sprintf(addr_str, "%s + %s + %lld", rv::x86_reg_str_q(rs1x),
+						rv::x86_reg_str_q(rs2x), d2.imm);
+				} else {
+					if (rs1x > 0) {
+						rv::as.mov(x86::rax, x86::gpq(rs1x));
+						em::log_trace("\t\tmov rax, %s", rv::x86_reg_str_q(rs1x));
+					} else {
+						rv::as.mov(x86::rax, rv::rbp_reg_q(d1.rs1));
+						em::log_trace("\t\tmov rax, %s", rv::rbp_reg_str_q(d1.rs1));
 					}
-					emit_queue();
-					break;
-				case match_state_call:
-					if (rd == dec.rs1 && dec.rd == rv_ireg_ra) {
-						imm += dec.imm;
-						fusion_decode dec(pseudo_pc, fusion_op_call, rv_ireg_ra, imm);
-						fusion_emitter<P>::emit(dec);
-						clear_queue();
-						return true;
+					if (rs2x > 0) {
+						rv::as.add(x86::rax, x86::gpq(rs2x));
+						em::log_trace("\t\tadd rax, %s", rv::x86_reg_str_q(rs2x));
+					} else {
+						rv::as.add(x86::rax, rv::rbp_reg_q(d1.rs2));
+						em::log_trace("\t\tadd rax, %s", rv::rbp_reg_str_q(d1.rs2));
 					}
-					emit_queue();
-					state = match_state_none;
-					break;
+					mem = load_ptr(size, x86::rax, s32(d2.imm));
+					sprintf(addr_str, "rax + %lld", d2.imm);
+				}
+			} else {
+				addr_t addr = d1.imm + d2.imm;
+				if (d1.op == rv_op_auipc) addr += d1.pc;
+				rv::as.mov(x86::rax, Imm(addr));
+				em::log_trace("\t\tmov rax, 0x%llx", addr);
+				mem = load_ptr(size, x86::rax, 0);
+				addr_str = "rax";
+			}
+
+			if (size == 8) {
+				rv::as.mov(x86::gpq(dst), mem);
+				em::log_trace("\t\tmov %s, %s ptr [%s]", rv::x86_reg_str_q(dst), ptr_name, addr_str.c_str());
+			} else if (size == 4 && load_signed(d2.op)) {
+				rv::as.movsxd(x86::gpq(dst), mem);
+				em::log_trace("\t\tmovsxd %s, %s ptr [%s]", rv::x86_reg_str_q(dst), ptr_name, addr_str.c_str());
+			} else if (size == 4) {
+				rv::as.mov(x86::gpd(dst), mem);
+				em::log_trace("\t\tmov %s, %s ptr [%s]", rv::x86_reg_str_d(dst), ptr_name, addr_str.c_str());
+			} else if (load_signed(d2.op)) {
+				rv::as.movsx(x86::gpq(dst), mem);
+				em::log_trace("\t\tmovsx %s, %s ptr [%s]", rv::x86_reg_str_q(dst), ptr_name, addr_str.c_str());
+			} else {
+				rv::as.movzx(x86::gpd(dst), mem);
+				em::log_trace("\t\tmovzx %s, %s ptr [%s]", rv::x86_reg_str_d(dst), ptr_name, addr_str.c_str());
+			}
+			emit_result(d2, dst);
+			set_term_pc(d2);
+			return true;
+		}
+
+		/* slt[i][u] rd, rs1, rs2/imm; bnez/beqz rd branches on the compare flags */
+		bool emit_fused_branch(decode_type &d1, decode_type &d2)
+		{
+			log_pair(d1, d2);
+			bool is_imm = d1.op == rv_op_slti || d1.op == rv_op_sltiu;
+			bool is_unsigned = d1.op == rv_op_sltu || d1.op == rv_op_sltiu;
+			bool bnez = d2.op == rv_op_bne;
+			int rdx = rv::x86_reg(d1.rd), rs1x = rv::x86_reg(d1.rs1);
+
+			/* cmp rs1, rs2/imm */
+			if (!is_imm) {
+				em::emit_cmp(d1);
+			} else if (rs1x > 0) {
+				rv::as.cmp(x86::gpq(rs1x), Imm(d1.imm));
+				em::log_trace("\t\tcmp %s, %lld", rv::x86_reg_str_q(rs1x), d1.imm);
+			} else {
+				rv::as.cmp(rv::rbp_reg_q(d1.rs1), Imm(d1.imm));
+				em::log_trace("\t\tcmp %s, %lld", rv::rbp_reg_str_q(d1.rs1), d1.imm);
+			}
+
+			/* rd = less than, mov and movzx leave the flags */
+			if (is_unsigned) {
+				rv::as.setb(x86::al);
+				em::log_trace("\t\tsetb al");
+			} else {
+				rv::as.setl(x86::al);
+				em::log_trace("\t\tsetl al");
 			}
-			return fusion_emitter<P>::emit(dec);
+			if (rdx > 0) {
+				rv::as.movzx(x86::gpd(rdx), x86::al);
+				em::log_trace("\t\tmovzx %s, al", rv::x86_reg_str_d(rdx));
+			} else {
+				rv::as.movzx(x86::eax, x86::al);
+				rv::as.mov(rv::rbp_reg_q(d1.rd), x86::rax);
+				em::log_trace("\t\tmovzx eax, al");
+				em::log_trace("\t\tmov %s, rax", rv::rbp_reg_str_q(d1.rd));
+			}
+
+			/* jcc branches on lt for bnez and on !lt for beqz */
+			bool cond = em::branch_taken(d2);
+			if (is_unsigned) {
+				return bnez ?
+					em::emit_jcc(d2, cond, &X86Assembler::jb, "jb", &X86Assembler::jae, "jae") :
+					em::emit_jcc(d2, cond, &X86Assembler::jae, "jae", &X86Assembler::jb, "jb");
+			} else {
+				return bnez ?
+					em::emit_jcc(d2, cond, &X86Assembler::jl, "jl", &X86Assembler::jge, "jge") :
+					em::emit_jcc(d2, cond, &X86Assembler::jge, "jge", &X86Assembler::jl, "jl");
+			}
+		}
+
+		/* add/sub/addi/mul rd, ...; addiw rd, rd, 0 computes in 32 bits and sign extends */
+		bool emit_fused_sext_w(decode_type &d1, decode_type &d2)
+		{
+			log_pair(d1, d2);
+			int rdx = rv::x86_reg(d2.rd), rs1x = rv::x86_reg(d1.rs1), rs2x = rv::x86_reg(d1.rs2);
+			const char *op_name = d1.op == rv_op_sub ? "sub" : d1.op == rv_op_mul ? "imul" : "add";
+
+			/* eax = rs1 */
+			if (rs1x > 0) {
+				rv::as.mov(x86::eax, x86::gpd(rs1x));
+				em::log_trace("\t\tmov eax, %s", rv::x86_reg_str_d(rs1x));
+			} else {
+				rv::as.mov(x86::eax, rv::rbp_reg_d(d1.rs1));
+				em::log_trace("\t\tmov eax, %s", rv::rbp_reg_str_d(d1.rs1));
+			}
+
+			/* eax op= rs2/imm */
+			if (d1.op == rv_op_addi) {
+				rv::as.add(x86::eax, Imm(d1.imm));
+				em::log_trace("\t\tadd eax, %lld", d1.imm);
+			} else if (rs2x > 0) {
+				switch (d1.op) {
+					case rv_op_add: rv::as.add(x86::eax, x86::gpd(rs2x)); break;
+					case rv_op_sub: rv::as.sub(x86::eax, x86::gpd(rs2x)); break;
+					case rv_op_mul: rv::as.imul(x86::eax, x86::gpd(rs2x)); break;
+				}
+				em::log_trace("\t\t%s eax, %s", op_name, rv::x86_reg_str_d(rs2x));
+			} else {
+				switch (d1.op) {
+					case rv_op_add: rv::as.add(x86::eax, rv::rbp_reg_d(d1.rs2)); break;
+					case rv_op_sub: rv::as.sub(x86::eax, rv::rbp_reg_d(d1.rs2)); break;
+					case rv_op_mul: rv::as.imul(x86::eax, rv::rbp_reg_d(d1.rs2)); break;
+				}
+				em::log_trace("\t\t%s eax, %s", op_name, rv::rbp_reg_str_d(d1.rs2));
+			}
+
+			/* rd = sext(eax) */
+			int dst = std::max(rdx, 0);
+			rv::as.movsxd(x86::gpq(dst), x86::eax);
+			em::log_trace("\t\tmovsxd %s, eax", rv::x86_reg_str_q(dst));
+			emit_result(d2, dst);
+			set_term_pc(d2);
+			return true;
 		}
 	};
 }
@@ -1,8 +1,9 @@
 unsigned char build_riscv64_unknown_elf_bin_boot_rom_bin[] = {
   0x6f, 0x00, 0x00, 0x01, 0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x01, 0x40, 0x97, 0x02, 0x00, 0x00, 0x93, 0x82, 0x42, 0x06,
+  0x00, 0x00, 0x01, 0x40, 0x97, 0x02, 0x00, 0x00, 0x93, 0x82, 0x02, 0x07,
   0x73, 0x90, 0x52, 0x30, 0xb7, 0xf1, 0x00, 0x40, 0x83, 0xb2, 0x81, 0x02,
-  0x03, 0xb3, 0x01, 0x03, 0x33, 0x81, 0x62, 0x00, 0x13, 0x01, 0x01, 0xf0,
+  0x03, 0xb3, 0x01, 0x03, 0x33, 0x81, 0x62, 0x00, 0xf3, 0x22, 0x40, 0xf1,
+  0x93, 0x92, 0x82, 0x00, 0x33, 0x01, 0x51, 0x40, 0x13, 0x01, 0x01, 0xf0,
   0x73, 0x23, 0x00, 0x30, 0x93, 0x02, 0x30, 0x00, 0x93, 0x92, 0xb2, 0x00,
   0x33, 0x63, 0x53, 0x00, 0x73, 0x20, 0x03, 0x30, 0xb7, 0x32, 0x00, 0x40,
   0x13, 0x03, 0x10, 0x00, 0xa3, 0x80, 0x62, 0x00, 0xb7, 0x12, 0x00, 0x00,
@@ -54,17 +55,16 @@ unsigned char build_riscv64_unknown_elf_bin_boot_rom_bin[] = {
   0x33, 0x1f, 0xa3, 0x00, 0x13, 0x05, 0x00, 0x00, 0x83, 0x32, 0x01, 0x00,
   0x03, 0x33, 0x81, 0x00, 0x73, 0x11, 0x01, 0x34, 0x73, 0x00, 0x20, 0x30,
   0x13, 0x05, 0xf0, 0xff, 0x83, 0x32, 0x01, 0x00, 0x03, 0x33, 0x81, 0x00,
-  0x73, 0x11, 0x01, 0x34, 0x73, 0x00, 0x20, 0x30, 0x2c, 0x11, 0x00, 0x00,
-  0x2c, 0x11, 0x00, 0x00, 0x2c, 0x11, 0x00, 0x00, 0x2c, 0x11, 0x00, 0x00,
-  0x2c, 0x11, 0x00, 0x00, 0x2c, 0x11, 0x00, 0x00, 0x2c, 0x11, 0x00, 0x00,
-  0x2c, 0x11, 0x00, 0x00, 0x2c, 0x11, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00,
-  0x00, 0x11, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x38, 0x11, 0x00, 0x00,
-  0x4c, 0x11, 0x00, 0x00, 0x64, 0x11, 0x00, 0x00, 0x88, 0x11, 0x00, 0x00,
-  0x8c, 0x11, 0x00, 0x00, 0x90, 0x11, 0x00, 0x00, 0x94, 0x11, 0x00, 0x00,
-  0xa4, 0x11, 0x00, 0x00, 0xc8, 0x11, 0x00, 0x00, 0xcc, 0x11, 0x00, 0x00,
-  0xd0, 0x11, 0x00, 0x00, 0xe8, 0x11, 0x00, 0x00, 0x20, 0x12, 0x00, 0x00,
-  0x38, 0x12, 0x00, 0x00, 0x64, 0x12, 0x00, 0x00, 0xc8, 0x11, 0x00, 0x00,
-  0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
+  0x73, 0x11, 0x01, 0x34, 0x73, 0x00, 0x20, 0x30, 0x38, 0x11, 0x00, 0x00,
+  0x38, 0x11, 0x00, 0x00, 0x38, 0x11, 0x00, 0x00, 0x38, 0x11, 0x00, 0x00,
+  0x38, 0x11, 0x00, 0x00, 0x38, 0x11, 0x00, 0x00, 0x38, 0x11, 0x00, 0x00,
+  0x38, 0x11, 0x00, 0x00, 0x38, 0x11, 0x00, 0x00, 0x0c, 0x11, 0x00, 0x00,
+  0x0c, 0x11, 0x00, 0x00, 0x0c, 0x11, 0x00, 0x00, 0x44, 0x11, 0x00, 0x00,
+  0x58, 0x11, 0x00, 0x00, 0x70, 0x11, 0x00, 0x00, 0x94, 0x11, 0x00, 0x00,
+  0x98, 0x11, 0x00, 0x00, 0x9c, 0x11, 0x00, 0x00, 0xa0, 0x11, 0x00, 0x00,
+  0xb0, 0x11, 0x00, 0x00, 0xd4, 0x11, 0x00, 0x00, 0xd8, 0x11, 0x00, 0x00,
+  0xdc, 0x11, 0x00, 0x00, 0xf4, 0x11, 0x00, 0x00, 0x2c, 0x12, 0x00, 0x00,
+  0x44, 0x12, 0x00, 0x00, 0x70, 0x12, 0x00, 0x00, 0xd4, 0x11, 0x00, 0x00,
   0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
   0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
   0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
@@ -92,6 +92,7 @@ PROGRAMS = \
 	$(BIN_DIR)/test-jump-tables-no \
 	$(BIN_DIR)/test-large-imm \
 	$(BIN_DIR)/test-reloc-imm \
+	$(BIN_DIR)/test-m-code-cache \
 	$(BIN_DIR)/test-m-ecall-trap \
 	$(BIN_DIR)/test-m-hartid \
 	$(BIN_DIR)/test-m-mret-user \
@@ -99,6 +100,7 @@ PROGRAMS = \
 	$(BIN_DIR)/test-m-mmio-timer \
 	$(BIN_DIR)/test-m-mmio-uart \
 	$(BIN_DIR)/test-m-poll-uart \
+	$(BIN_DIR)/test-m-snapshot \
 	$(BIN_DIR)/test-m-sv39 \
 	$(BIN_DIR)/test-sbi-info \
 	$(BIN_DIR)/test-sbi-timer
@@ -123,9 +125,18 @@ test-sim: all
 	$(EMULATOR) $(BIN_DIR)/test-jump-tables-no 11
 
 test-sys: all
+	$(EMULATOR) --harts 2 $(BIN_DIR)/test-m-code-cache
 	$(EMULATOR) $(BIN_DIR)/test-m-ecall-trap
 	$(EMULATOR) $(BIN_DIR)/test-m-mmio-timer
 	$(EMULATOR) $(BIN_DIR)/test-m-sv39
+	$(EMULATOR) --snapshot $(BIN_DIR)/test-m-snapshot.snap $(BIN_DIR)/test-m-snapshot
+	$(EMULATOR) --restore $(BIN_DIR)/test-m-snapshot.snap
+
+# the JIT translates rv64 only
+test-sys-jit: all
+	$(EMULATOR) --harts 2 --jit $(BIN_DIR)/test-m-code-cache
+	$(EMULATOR) --jit $(BIN_DIR)/test-m-mmio-timer
+	$(EMULATOR) --jit $(BIN_DIR)/test-m-sv39
 
 $(OBJ_DIR)/asm-call.o: $(SRC_DIR)/asm-call.s ; $(BIN)/rv-asm $^ -o $@
 $(BIN_DIR)/asm-call: $(OBJ_DIR)/asm-call.o ; $(LD) $^ -o $@
@@ -211,6 +222,9 @@ $(BIN_DIR)/test-large-imm: $(OBJ_DIR)/test-large-imm.o ; $(LD) $^ -o $@
 $(OBJ_DIR)/test-reloc-imm.o: $(SRC_DIR)/test-reloc-imm.S ; $(CC) -c $^ -o $@
 $(BIN_DIR)/test-reloc-imm: $(OBJ_DIR)/test-reloc-imm.o ; $(LD) $^ -o $@
 
+$(OBJ_DIR)/test-m-code-cache.o: $(SRC_DIR)/test-m-code-cache.S ; $(CC) -c $^ -o $@
+$(BIN_DIR)/test-m-code-cache: $(OBJ_DIR)/test-m-code-cache.o ; $(LD) $^ -o $@
+
 $(OBJ_DIR)/test-m-ecall-trap.o: $(SRC_DIR)/test-m-ecall-trap.S ; $(CC) -c $^ -o $@
 $(BIN_DIR)/test-m-ecall-trap: $(OBJ_DIR)/test-m-ecall-trap.o ; $(LD) $^ -o $@
 
@@ -232,6 +246,9 @@ $(BIN_DIR)/test-m-poll-uart: $(OBJ_DIR)/test-m-poll-uart.o ; $(LD) $^ -o $@
 $(OBJ_DIR)/test-m-mret-user.o: $(SRC_DIR)/test-m-mret-user.S ; $(CC) -c $^ -o $@
 $(BIN_DIR)/test-m-mret-user: $(OBJ_DIR)/test-m-mret-user.o ; $(LD) $^ -o $@
 
+$(OBJ_DIR)/test-m-snapshot.o: $(SRC_DIR)/test-m-snapshot.S ; $(CC) -c $^ -o $@
+$(BIN_DIR)/test-m-snapshot: $(OBJ_DIR)/test-m-snapshot.o ; $(LD) $^ -o $@
+
 $(OBJ_DIR)/test-m-sv39.o: $(SRC_DIR)/test-m-sv39.S ; $(CC) -c $^ -o $@
 $(BIN_DIR)/test-m-sv39: $(OBJ_DIR)/test-m-sv39.o ; $(LD) $^ -o $@
 